@@ -0,0 +1,65 @@
+#include "aliasTable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+void AliasTable::assign(const double *weights, size_t count) {
+
+    if (count == 0) {
+        throw std::invalid_argument("AliasTable: weights must not be empty");
+    }
+
+    double total = 0.0;
+    for (size_t i = 0; i < count; ++i) {
+        double weight = weights[i];
+        if (weight < 0.0 || !std::isfinite(weight)) throw std::invalid_argument("AliasTable: weights must be finite and non-negative");
+        total += weight;
+    }
+    if (total <= 0.0) {
+        throw std::invalid_argument("AliasTable: weights must not all be zero");
+    }
+
+    size_t n = count;
+
+    /**
+     * NOTE: small and large always hold n columns between them, so they share one buffer: small grows up from the
+     * front, large down from the back. Both scratch buffers live per thread and only ever grow.
+     */
+    thread_local std::vector<double> scaled;
+    thread_local std::vector<uint32_t> work;
+    scaled.resize(n);
+    work.resize(n);
+    size_t smallCount = 0;
+    size_t largeBegin = n;
+
+    for (size_t i = 0; i < n; ++i) {
+        scaled[i] = weights[i] * static_cast<double>(n) / total;
+        if (scaled[i] < 1.0) work[smallCount++] = static_cast<uint32_t>(i);
+        else work[--largeBegin] = static_cast<uint32_t>(i);
+    }
+
+    threshold.assign(n, UINT32_MAX);
+    alias.resize(n);
+    for (size_t i = 0; i < n; ++i) alias[i] = static_cast<uint32_t>(i);
+
+    /**
+     * NOTE: Vose pairing -> every under-full column is topped up by exactly one over-full column
+     */
+    while (smallCount > 0 && largeBegin < n) {
+        uint32_t less = work[--smallCount];
+        uint32_t more = work[largeBegin];
+
+        threshold[less] = static_cast<uint32_t>(std::min(scaled[less] * 4294967296.0, 4294967295.0));
+        alias[less] = more;
+
+        scaled[more] -= 1.0 - scaled[less];
+        if (scaled[more] < 1.0) {
+            ++largeBegin;
+            work[smallCount++] = more;
+        }
+    }
+
+    /**
+     * NOTE: leftovers are 1.0 up to rounding error and keep their own column (threshold stays UINT32_MAX)
+     */
+}
@@ -0,0 +1,131 @@
+#include "baseSampler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+constexpr double    FIXED_POINT_SCALE =     4294967296.0;
+
+/**
+ * NOTE: number of words pulled from the generator at once by fill
+ */
+constexpr size_t    WORD_BATCH =            64;
+
+}
+
+BaseSampler::BaseSampler(const std::array<double, 4> &weights) {
+
+    double total = 0.0;
+    for (double weight : weights) {
+        if (weight < 0.0 || !std::isfinite(weight)) throw std::invalid_argument("BaseSampler: weights must be finite and non-negative");
+        total += weight;
+    }
+    if (total <= 0.0) throw std::invalid_argument("BaseSampler: weights must not all be zero");
+
+    double cumulative = 0.0;
+    for (size_t i = 0; i < 3; ++i) {
+        cumulative += weights[i] / total;
+        thresholds[i] = static_cast<uint64_t>(std::llround(std::min(cumulative, 1.0) * FIXED_POINT_SCALE));
+    }
+
+    bits = MAX_BITS;
+    for (unsigned k = MIN_BITS; k < MAX_BITS; ++k) {
+        uint64_t mask = (uint64_t{1} << (32 - k)) - 1;
+        if (std::all_of(thresholds.begin(), thresholds.end(), [mask](uint64_t t) { return (t & mask) == 0; })) {
+            bits = k;
+            break;
+        }
+    }
+
+    auto baseAt = [this](uint64_t draw) {
+        return static_cast<uint8_t>((draw >= thresholds[0]) + (draw >= thresholds[1]) + (draw >= thresholds[2]));
+    };
+
+    unsigned shift = 32 - bits;
+    identity = true;
+    for (uint32_t slot = 0; slot < (1u << bits); ++slot) {
+        uint64_t first = uint64_t{slot} << shift;
+        uint64_t last = first | ((uint64_t{1} << shift) - 1);
+        slots[slot] = baseAt(first) == baseAt(last) ? baseAt(first) : SAMPLE_SPLIT;
+        identity = identity && bits == MIN_BITS && slots[slot] == slot;
+    }
+
+    /**
+     * NOTE: 8-bit slot s lies entirely at or above threshold t iff s >= ceil(t / 2^24); it straddles t iff s == t >> 24
+     * and t is not slot aligned
+     */
+    for (size_t j = 0; j < 3; ++j) {
+        uint64_t cutoff = (thresholds[j] + (uint64_t{1} << 24) - 1) >> 24;
+        cutoffs.cutoff[j] = static_cast<uint8_t>(std::min<uint64_t>(cutoff, 255));
+        cutoffs.active[j] = cutoff <= 255 ? 0xFF : 0;
+        cutoffs.split[j] = static_cast<uint8_t>(std::min<uint64_t>(thresholds[j] >> 24, 255));
+        cutoffs.straddles[j] = (thresholds[j] & ((uint64_t{1} << 24) - 1)) != 0 ? 0xFF : 0;
+    }
+}
+
+uint8_t BaseSampler::resolve(uint64_t slot, uint64_t word) const {
+
+    unsigned shift = 32 - bits;
+    uint64_t draw = (slot << shift) | (word & ((uint64_t{1} << shift) - 1));
+    return static_cast<uint8_t>((draw >= thresholds[0]) + (draw >= thresholds[1]) + (draw >= thresholds[2]));
+}
+
+uint8_t BaseSampler::sample(BlockRng &rng) const {
+
+    uint64_t word = rng.next();
+    uint64_t slot = word >> (64 - bits);
+    uint8_t code = slots[slot];
+    return code == SAMPLE_SPLIT ? resolve(slot, word >> 8) : code;
+}
+
+void BaseSampler::fill(BlockRng &rng, uint8_t *out, size_t count) const {
+
+    const KernelTable &kernel = kernels();
+    const unsigned perWord = 64 / bits;
+    const uint64_t mask = (uint64_t{1} << bits) - 1;
+    uint64_t words[WORD_BATCH];
+    const uint8_t *randomBytes = reinterpret_cast<const uint8_t *>(words);
+
+    size_t i = 0;
+    while (i < count) {
+        size_t wanted = std::min(WORD_BATCH, (count - i + perWord - 1) / perWord);
+        size_t n = std::min(wanted * perWord, count - i);
+        rng.fill(words, wanted);
+
+        if (identity) {
+            /**
+             * NOTE: uniform bases -> every 2-bit field already is a base code
+             */
+            kernel.unpackCodes(words, n, out + i);
+            i += n;
+            continue;
+        }
+
+        if (bits == MAX_BITS) {
+            /**
+             * NOTE: slots are the little-endian bytes of the words, i.e. the same low-bits-first order as the loop below
+             */
+            uint8_t *batch = out + i;
+            kernel.sampleBases(randomBytes, n, cutoffs, batch);
+            for (uint8_t *split = batch; (split = static_cast<uint8_t *>(std::memchr(split, SAMPLE_SPLIT, batch + n - split))); ++split) {
+                *split = resolve(randomBytes[split - batch], rng.next());
+            }
+            i += n;
+            continue;
+        }
+
+        for (size_t w = 0; w < wanted; ++w) {
+            uint64_t word = words[w];
+            size_t take = std::min<size_t>(perWord, count - i);
+
+            for (size_t j = 0; j < take; ++j) {
+                uint64_t slot = word & mask;
+                word >>= bits;
+                uint8_t code = slots[slot];
+                out[i++] = code == SAMPLE_SPLIT ? resolve(slot, rng.next()) : code;
+            }
+        }
+    }
+}
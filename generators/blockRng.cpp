@@ -0,0 +1,37 @@
+#include "blockRng.hpp"
+#include "rngUtils.hpp"
+
+void BlockRng::reseed(uint64_t seed) {
+
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        uint64_t x = deriveSeed(seed, lane);
+        for (size_t word = 0; word < 4; ++word) {
+            x = splitmix64(x);
+            state[word][lane] = x;
+        }
+        /**
+         * NOTE: xoshiro must not start from the all-zero state; splitmix64 output makes that practically impossible
+         */
+        if ((state[0][lane] | state[1][lane] | state[2][lane] | state[3][lane]) == 0) state[0][lane] = 1;
+    }
+    cursor = BUFFER_WORDS;
+}
+
+void BlockRng::generateBlocks(uint64_t *out, size_t blocks) {
+    kernels().xoshiroBlocks(state, out, blocks);
+}
+
+void BlockRng::fill(uint64_t *out, size_t count) {
+
+    size_t written = 0;
+    while (written < count && cursor < BUFFER_WORDS) out[written++] = buffer[cursor++];
+
+    /**
+     * NOTE: the buffer is drained, so the stream sits on a block boundary and whole blocks can go straight to out
+     */
+    size_t blocks = (count - written) / LANES;
+    generateBlocks(out + written, blocks);
+    written += blocks * LANES;
+
+    while (written < count) out[written++] = next();
+}
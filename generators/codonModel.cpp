@@ -0,0 +1,50 @@
+#include "codonModel.hpp"
+#include "baseCodes.hpp"
+#include <stdexcept>
+
+namespace {
+
+void writeCodon(uint8_t index, uint8_t *out) {
+    out[0] = static_cast<uint8_t>(index >> 4);
+    out[1] = static_cast<uint8_t>((index >> 2) & 3);
+    out[2] = static_cast<uint8_t>(index & 3);
+}
+
+}
+
+void CodonModel::assign(const std::array<double, 4> &baseWeights) {
+
+    std::array<double, 64> sense {};
+    for (uint8_t index = 0; index < 64; ++index) {
+        if (isStopCodon(index)) continue;
+        sense[index] = baseWeights[index >> 4] * baseWeights[(index >> 2) & 3] * baseWeights[index & 3];
+    }
+
+    std::array<double, 3> stops {};
+    for (size_t i = 0; i < 3; ++i) {
+        uint8_t index = STOP_CODONS[i];
+        stops[i] = baseWeights[index >> 4] * baseWeights[(index >> 2) & 3] * baseWeights[index & 3];
+    }
+    /**
+     * NOTE: every stop codon contains A and T; at GC = 1 the frame still has to end, so stops fall back to equal weights
+     */
+    if (stops[0] + stops[1] + stops[2] <= 0.0) stops.fill(1.0);
+
+    try {
+        senseCodons.assign(sense.data(), sense.size());
+        stopCodons.assign(stops.data(), stops.size());
+    } catch (const std::invalid_argument &) {
+        throw std::invalid_argument("CodonModel: base weights must be non-negative and leave a sense codon");
+    }
+}
+
+void CodonModel::fillOpenReadingFrame(BlockRng &rng, uint8_t *out, size_t codonCount) const {
+
+    if (codonCount < 2) throw std::invalid_argument("CodonModel: a reading frame needs at least a start and a stop codon");
+
+    writeCodon(START_CODON, out);
+    for (size_t c = 1; c + 1 < codonCount; ++c) {
+        writeCodon(static_cast<uint8_t>(senseCodons.sample(rng.next())), out + 3 * c);
+    }
+    writeCodon(STOP_CODONS[stopCodons.sample(rng.next())], out + 3 * (codonCount - 1));
+}
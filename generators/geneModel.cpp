@@ -0,0 +1,112 @@
+#include "geneModel.hpp"
+#include <algorithm>
+
+namespace {
+
+/**
+ * NOTE: MIN_CDS_PER_EXON -> coding bases every exon keeps, so no exon is reduced to a sliver around a splice site;
+ * MAX_EXONS bounds the geometric exon count draw.
+ */
+constexpr size_t    MIN_CDS_PER_EXON =  30;
+constexpr size_t    MAX_EXONS =         64;
+
+/**
+ * @brief Sense-strand offsets [first, last] of a feature -> chromosome coordinates.
+ */
+GeneFeature placeFeature(const RegionPlan &plan, size_t first, size_t last, uint32_t parent, GeneFeatureType type, uint8_t phase = 0) {
+    if (plan.strand == StrandInfo::plus) {
+        return GeneFeature{plan.region_start_index + first, plan.region_start_index + last, parent, type, plan.strand, phase};
+    }
+    return GeneFeature{plan.region_end_index - last, plan.region_end_index - first, parent, type, plan.strand, phase};
+}
+
+}
+
+size_t geneRunEnd(const GeneModel &genes, size_t gene) {
+    size_t end = gene + 1;
+    while (end < genes.size() && genes[end].parent != NO_PARENT) ++end;
+    return end;
+}
+
+std::optional<uint32_t> planSplicedGene(const RegionInfo &region, const GenerationConfig &config, std::mt19937_64 &rng, GeneModel &genes) {
+
+    const RegionPlan &plan = region.base.region_plan;
+    size_t length = plan.RegionLength();
+
+    /**
+     * NOTE: exon count = 2 + geometric with mean (meanExons - 2); introns are dropped from the 3' end until the
+     * UTRs, introns and MIN_CDS_PER_EXON per exon fit the region; a mean of exactly 2 draws nothing, as the
+     * geometric distribution is undefined at p == 1
+     */
+    size_t exons = 2;
+    if (config.genes.meanExons > 2.0) {
+        std::geometric_distribution<size_t> extraExons(1.0 / (config.genes.meanExons - 1.0));
+        exons = std::min(MAX_EXONS, 2 + extraExons(rng));
+    }
+
+    size_t utr5 = config.utrLengths.sample(rng());
+    size_t utr3 = config.utrLengths.sample(rng());
+    std::vector<size_t> introns(exons - 1);
+    for (size_t &intron : introns) intron = config.intronLengths.sample(rng());
+
+    size_t used = utr5 + utr3;
+    for (size_t intron : introns) used += intron;
+    while (exons >= 2 && used + exons * MIN_CDS_PER_EXON > length) {
+        used -= introns.back();
+        introns.pop_back();
+        --exons;
+    }
+    if (exons < 2) return std::nullopt;
+
+    size_t cds = length - used;
+    utr3 += cds % 3;
+    cds -= cds % 3;
+
+    /**
+     * NOTE: CDS pieces -> MIN_CDS_PER_EXON each plus a random share of the rest; the last piece takes the rounding
+     */
+    std::vector<size_t> pieces(exons, MIN_CDS_PER_EXON);
+    std::uniform_real_distribution<double> share(0.0, 1.0);
+    std::vector<double> shares(exons);
+    double shareSum = 0.0;
+    for (double &s : shares) shareSum += (s = share(rng));
+    size_t extra = cds - exons * MIN_CDS_PER_EXON;
+    size_t assigned = 0;
+    for (size_t e = 0; e + 1 < exons; ++e) {
+        size_t piece = static_cast<size_t>(static_cast<double>(extra) * shares[e] / shareSum);
+        pieces[e] += piece;
+        assigned += piece;
+    }
+    pieces.back() += extra - assigned;
+
+    uint32_t gene = static_cast<uint32_t>(genes.size());
+    genes.push_back(placeFeature(plan, 0, length - 1, NO_PARENT, GeneFeatureType::gene));
+    uint32_t mrna = static_cast<uint32_t>(genes.size());
+    genes.push_back(placeFeature(plan, 0, length - 1, gene, GeneFeatureType::mrna));
+
+    size_t offset = 0;
+    size_t codingBefore = 0;
+    for (size_t e = 0; e < exons; ++e) {
+        size_t exonLength = pieces[e] + (e == 0 ? utr5 : 0) + (e + 1 == exons ? utr3 : 0);
+        genes.push_back(placeFeature(plan, offset, offset + exonLength - 1, mrna, GeneFeatureType::exon));
+
+        if (e == 0) {
+            genes.push_back(placeFeature(plan, offset, offset + utr5 - 1, mrna, GeneFeatureType::five_prime_utr));
+            offset += utr5;
+        }
+
+        uint8_t phase = static_cast<uint8_t>((3 - codingBefore % 3) % 3);
+        genes.push_back(placeFeature(plan, offset, offset + pieces[e] - 1, mrna, GeneFeatureType::cds, phase));
+        offset += pieces[e];
+        codingBefore += pieces[e];
+
+        if (e + 1 == exons) {
+            genes.push_back(placeFeature(plan, offset, offset + utr3 - 1, mrna, GeneFeatureType::three_prime_utr));
+            offset += utr3;
+        } else {
+            genes.push_back(placeFeature(plan, offset, offset + introns[e] - 1, mrna, GeneFeatureType::intron));
+            offset += introns[e];
+        }
+    }
+    return gene;
+}
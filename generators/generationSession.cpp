@@ -0,0 +1,238 @@
+#include "generationSession.hpp"
+#include "allocationProfile.hpp"
+#include "kernels.hpp"
+#include "metrics.hpp"
+#include "rngUtils.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char      CHECKPOINT_MAGIC[4] =   {'G', 'M', 'C', 'P'};
+constexpr uint32_t  CHECKPOINT_VERSION =    2;
+
+std::shared_ptr<const GenerationConfig> orDefaults(std::shared_ptr<const GenerationConfig> config) {
+    if (config) return config;
+    return std::shared_ptr<const GenerationConfig>(&GenerationConfig::defaults(), [](const GenerationConfig *) {});
+}
+
+void putLE(std::string &out, uint64_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+uint64_t takeLE(const std::string &in, size_t &offset, size_t bytes) {
+    if (offset + bytes > in.size()) throw std::runtime_error("checkpoint is truncated");
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) value |= static_cast<uint64_t>(static_cast<unsigned char>(in[offset + i])) << (8 * i);
+    offset += bytes;
+    return value;
+}
+
+}
+
+GenerationSession::GenerationSession(uint64_t seed, size_t targetLength, std::shared_ptr<const GenerationConfig> config)
+    : seed(seed),
+      targetLength(targetLength),
+      config(orDefaults(std::move(config))),
+      planner(seed, *this->config),
+      gcWindow(GC_WINDOW, BASE_A)
+{
+    if (targetLength < 100) {
+        throw std::invalid_argument("GenerationSession: targetLength must be at least 100");
+    }
+
+    RepeatGenerator repeatGenerator(deriveSeed(seed, REPEAT_LIBRARY_STREAM));
+    repeatLibrary = repeatGenerator.createFamilies(RepeatGenerator::DEFAULT_FAMILY_COUNT,
+                                                   this->config->gcContent[static_cast<size_t>(FeatureType::repeat)]);
+}
+
+void GenerationSession::materializeRegion(size_t start) {
+
+    planner.reseed(deriveSeed(seed, regionIndex));
+    planner.setMarkovContext(contextBeforeRegion);
+    region = planner.createRegion(start, targetLength);
+
+    regionCodes.resize(region.base.region_plan.RegionLength());
+    filler.reset(deriveSeed(seed, regionIndex, 1), *config);
+    filler.useRepeatLibrary(repeatLibrary);
+    filler.generate_region(region, regionCodes.data());
+
+    hasRegion = true;
+    GENOMORPH_COUNT(regions_planned, 1);
+    GENOMORPH_COUNT(regions_filled, 1);
+}
+
+void GenerationSession::pushWindow(const uint8_t *codes, size_t count) {
+
+    /**
+     * NOTE: a push at least one window long replaces the whole window, counted in one kernel call
+     */
+    if (count >= GC_WINDOW) {
+        std::copy(codes + count - GC_WINDOW, codes + count, gcWindow.begin());
+        windowGc = kernels().countGc(gcWindow.data(), GC_WINDOW);
+        windowFill = GC_WINDOW;
+        windowHead = 0;
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        if (windowFill == GC_WINDOW) {
+            windowGc -= isGcCode(gcWindow[windowHead]);
+        } else {
+            ++windowFill;
+        }
+        gcWindow[windowHead] = codes[i];
+        windowGc += isGcCode(codes[i]);
+        windowHead = (windowHead + 1) % GC_WINDOW;
+    }
+}
+
+SequenceBlock GenerationSession::append(size_t length) {
+
+    GENOMORPH_TIME(base_sampling);
+    GENOMORPH_ALLOC_STAGE(base_generation);
+
+    length = std::min(length, remaining());
+    SequenceBlock block(generatedBases, length);
+    size_t written = 0;
+
+    while (written < length) {
+        if (!hasRegion) {
+            materializeRegion(generatedBases);
+            startedRegions.push_back(region);
+        }
+
+        const RegionPlan &plan = region.base.region_plan;
+        size_t offset = generatedBases - plan.region_start_index;
+        size_t take = std::min(length - written, plan.RegionLength() - offset);
+
+        std::memcpy(block.codes() + written, regionCodes.data() + offset, take);
+        block.regionColumn().append(static_cast<uint32_t>(regionIndex), take);
+        pushWindow(regionCodes.data() + offset, take);
+
+        written += take;
+        generatedBases += take;
+
+        if (offset + take == plan.RegionLength()) {
+            contextBeforeRegion = planner.getMarkovContext();
+            ++regionIndex;
+            hasRegion = false;
+        }
+    }
+
+    GENOMORPH_COUNT(bases_generated, length);
+    return block;
+}
+
+RegionMap GenerationSession::takeStartedRegions() {
+    RegionMap regions;
+    regions.swap(startedRegions);
+    return regions;
+}
+
+void GenerationSession::saveCheckpoint(const std::string &path) const {
+
+    std::string data(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    putLE(data, CHECKPOINT_VERSION, 4);
+    putLE(data, seed, 8);
+    putLE(data, targetLength, 8);
+    putLE(data, generatedBases, 8);
+    putLE(data, regionIndex, 8);
+    putLE(data, hasRegion ? region.base.region_plan.region_start_index : generatedBases, 8);
+    putLE(data, contextBeforeRegion, 4);
+    putLE(data, config->fingerprint(), 8);
+    putLE(data, lineWidth, 4);
+    putLE(data, recordName.size(), 4);
+    data += recordName;
+    putLE(data, windowFill, 4);
+    putLE(data, windowHead, 4);
+    putLE(data, windowGc, 4);
+
+    for (size_t i = 0; i < GC_WINDOW; i += 4) {
+        uint8_t packed = 0;
+        for (size_t j = 0; j < 4 && i + j < GC_WINDOW; ++j) packed |= static_cast<uint8_t>(gcWindow[i + j] << (2 * j));
+        data.push_back(static_cast<char>(packed));
+    }
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) throw std::runtime_error("cannot open checkpoint file " + temporary);
+        file.write(data.data(), static_cast<std::streamsize>(data.size()));
+        file.flush();
+        if (!file) throw std::runtime_error("failed writing checkpoint " + temporary);
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("cannot replace checkpoint " + path);
+    }
+}
+
+GenerationSession GenerationSession::resume(const std::string &path, std::shared_ptr<const GenerationConfig> config) {
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("cannot open checkpoint " + path);
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    if (data.size() < 4 || std::memcmp(data.data(), CHECKPOINT_MAGIC, 4) != 0) {
+        throw std::runtime_error(path + " is not a genomorph checkpoint");
+    }
+    size_t offset = 4;
+    uint64_t version = takeLE(data, offset, 4);
+    if (version == 0 || version > CHECKPOINT_VERSION) {
+        throw std::runtime_error(path + ": unsupported checkpoint version");
+    }
+
+    uint64_t seed = takeLE(data, offset, 8);
+    uint64_t targetLength = takeLE(data, offset, 8);
+    GenerationSession session(seed, targetLength, std::move(config));
+
+    session.generatedBases = takeLE(data, offset, 8);
+    session.regionIndex = takeLE(data, offset, 8);
+    size_t regionStart = takeLE(data, offset, 8);
+    session.contextBeforeRegion = takeLE(data, offset, 4);
+
+    if (takeLE(data, offset, 8) != session.config->fingerprint()) {
+        throw std::invalid_argument(path + ": checkpoint was written with a different generation config");
+    }
+
+    if (version >= 2) {
+        session.lineWidth = takeLE(data, offset, 4);
+        size_t nameLength = takeLE(data, offset, 4);
+        if (offset + nameLength > data.size()) throw std::runtime_error(path + ": checkpoint is truncated");
+        session.recordName = data.substr(offset, nameLength);
+        offset += nameLength;
+    }
+
+    session.windowFill = takeLE(data, offset, 4);
+    session.windowHead = takeLE(data, offset, 4);
+    session.windowGc = takeLE(data, offset, 4);
+    constexpr size_t packedWindow = (GC_WINDOW + 3) / 4;
+    if (offset + packedWindow > data.size()) throw std::runtime_error(path + ": checkpoint is truncated");
+    for (size_t i = 0; i < GC_WINDOW; ++i) {
+        session.gcWindow[i] = (static_cast<unsigned char>(data[offset + i / 4]) >> (2 * (i % 4))) & 3;
+    }
+    offset += packedWindow;
+    if (offset != data.size()) throw std::runtime_error(path + ": trailing bytes after checkpoint");
+
+    /**
+     * NOTE: slots not yet filled still hold BASE_A, so the whole window counts to windowGc
+     */
+    if (session.generatedBases > targetLength || regionStart > session.generatedBases
+        || session.contextBeforeRegion > REGION_TYPE_COUNT || session.windowFill > GC_WINDOW || session.windowHead >= GC_WINDOW
+        || (session.windowFill < GC_WINDOW && session.windowHead != session.windowFill)
+        || session.windowGc != kernels().countGc(session.gcWindow.data(), GC_WINDOW)) {
+        throw std::runtime_error(path + ": inconsistent checkpoint");
+    }
+
+    /**
+     * NOTE: a region cut by the checkpoint is replayed from its seed; the emitted prefix is skipped by append()
+     */
+    if (regionStart < session.generatedBases) {
+        session.materializeRegion(regionStart);
+    }
+
+    return session;
+}
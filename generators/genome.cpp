@@ -0,0 +1,373 @@
+#include "genome.hpp"
+#include "allocationProfile.hpp"
+#include "metrics.hpp"
+#include "parallel.hpp"
+#include "rngUtils.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_set>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * NOTE: structural lengths scale with the chromosome so small test genomes stay mostly euchromatic;
+ * telomeres are whole hexamers and centromeres whole alpha-satellite monomers.
+ */
+constexpr size_t    TELOMERE_UNIT =         6;
+constexpr size_t    TELOMERE_MAX =          10000;
+constexpr size_t    CENTROMERE_UNIT =       171;
+constexpr size_t    CENTROMERE_MAX =        1000000;
+
+size_t telomereLength(size_t chromosomeLength) {
+    size_t length = std::clamp<size_t>(chromosomeLength / 100, TELOMERE_UNIT, TELOMERE_MAX);
+    return length - length % TELOMERE_UNIT;
+}
+
+size_t centromereLength(size_t chromosomeLength) {
+    size_t length = std::clamp<size_t>(chromosomeLength / 50, CENTROMERE_UNIT, CENTROMERE_MAX);
+    return length - length % CENTROMERE_UNIT;
+}
+
+/**
+ * NOTE: spilled plans are read back by the process that wrote them, so the arrays are stored as raw bytes
+ */
+static_assert(std::is_trivially_copyable_v<RegionInfo> && std::is_trivially_copyable_v<GeneFeature> && std::is_trivially_copyable_v<MotifSite>);
+
+template <typename T>
+void appendArray(std::string &out, const std::vector<T> &values) {
+    uint64_t count = values.size();
+    out.append(reinterpret_cast<const char *>(&count), sizeof(count));
+    out.append(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+}
+
+template <typename T>
+void readArray(const char *&in, std::vector<T> &values) {
+    uint64_t count = 0;
+    std::memcpy(&count, in, sizeof(count));
+    in += sizeof(count);
+    values.resize(count);
+    std::memcpy(values.data(), in, count * sizeof(T));
+    in += count * sizeof(T);
+}
+
+template <typename T>
+void freeArray(std::vector<T> &values) {
+    std::vector<T>().swap(values);
+}
+
+uint64_t planBytes(const Chromosome &chromosome) {
+    return chromosome.regions.capacity() * sizeof(RegionInfo) + chromosome.genes.capacity() * sizeof(GeneFeature)
+         + chromosome.motifSites.capacity() * sizeof(MotifSite);
+}
+
+RegionInfo structuralRegion(FeatureType type, size_t start, size_t length, StrandInfo strand, double gc) {
+    RegionInfo region;
+    region.base.type = type;
+    region.base.region_plan = RegionPlan{start, start + length - 1, strand};
+    region.base.GC_CONTENT = gc;
+    region.base.AT_CONTENT = 1.0 - gc;
+    return region;
+}
+
+}
+
+Genome::Genome(std::vector<ChromosomeSpec> specs, uint64_t seed, std::shared_ptr<const GenerationConfig> config)
+    : seed(seed),
+      config(config ? std::move(config) : std::shared_ptr<const GenerationConfig>(&GenerationConfig::defaults(), [](const GenerationConfig *) {}))
+{
+    if (specs.empty()) {
+        throw std::invalid_argument("Genome: at least one chromosome is required");
+    }
+
+    std::unordered_set<std::string> names;
+    for (ChromosomeSpec &spec : specs) {
+        if (spec.length < MIN_CHROMOSOME_LENGTH) {
+            throw std::invalid_argument("Genome: chromosome " + spec.name + " is shorter than MIN_CHROMOSOME_LENGTH");
+        }
+        if (!names.insert(spec.name).second) {
+            throw std::invalid_argument("Genome: duplicate chromosome name " + spec.name);
+        }
+
+        Chromosome chromosome;
+        chromosome.name = std::move(spec.name);
+        chromosome.length = spec.length;
+        chromosomes.push_back(std::move(chromosome));
+    }
+}
+
+Genome::~Genome() {
+    if (spillFd >= 0) ::close(spillFd);
+}
+
+size_t Genome::maxRegionLength(size_t chromosomeLength, const GenerationConfig &config) {
+    size_t longest = std::max(telomereLength(chromosomeLength), centromereLength(chromosomeLength));
+    for (const LengthSpec &spec : config.lengths) longest = std::max(longest, spec.max);
+    return longest;
+}
+
+void Genome::limitPlanMemory(uint64_t bytes, const std::string &directory) {
+    planBudget = bytes;
+    spillDirectory = directory;
+}
+
+void Genome::spillPlan(size_t c) {
+
+    Chromosome &chromosome = chromosomes[c];
+    std::string bytes;
+    appendArray(bytes, chromosome.regions);
+    appendArray(bytes, chromosome.genes);
+    appendArray(bytes, chromosome.motifSites);
+
+    {
+        std::lock_guard<std::mutex> lock(spillMutex);
+        if (spillFd < 0) {
+            /**
+             * NOTE: unlinked right away, so the file disappears with the process however it ends
+             */
+            std::string path = (spillDirectory.empty() ? std::string("/tmp") : spillDirectory) + "/genomorph-plan-XXXXXX";
+            spillFd = ::mkstemp(path.data());
+            if (spillFd < 0) throw std::runtime_error("cannot create plan spill file in " + spillDirectory + ": " + std::strerror(errno));
+            ::unlink(path.c_str());
+        }
+        for (size_t done = 0; done < bytes.size();) {
+            ssize_t written = ::pwrite(spillFd, bytes.data() + done, bytes.size() - done, static_cast<off_t>(spillEnd + done));
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) throw std::runtime_error("failed writing plan spill file: " + std::string(std::strerror(errno)));
+            done += static_cast<size_t>(written);
+        }
+        spills[c] = PlanSpill{spillEnd, bytes.size()};
+        spillEnd += bytes.size();
+    }
+    releasePlan(c);
+}
+
+void Genome::loadPlan(size_t c) {
+
+    const PlanSpill &spill = spills[c];
+    if (spill.size == 0) return;
+
+    std::string bytes(spill.size, '\0');
+    for (size_t done = 0; done < bytes.size();) {
+        ssize_t got = ::pread(spillFd, bytes.data() + done, bytes.size() - done, static_cast<off_t>(spill.offset + done));
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) throw std::runtime_error("failed reading plan spill file: " + std::string(std::strerror(errno)));
+        done += static_cast<size_t>(got);
+    }
+
+    const char *in = bytes.data();
+    readArray(in, chromosomes[c].regions);
+    readArray(in, chromosomes[c].genes);
+    readArray(in, chromosomes[c].motifSites);
+}
+
+void Genome::releasePlan(size_t c) {
+    if (spills[c].size == 0) return;
+    freeArray(chromosomes[c].regions);
+    freeArray(chromosomes[c].genes);
+    freeArray(chromosomes[c].motifSites);
+}
+
+RegionMap Genome::planChromosome(size_t chromosomeIndex) const {
+
+    GENOMORPH_TIME(region_planning);
+
+    size_t length = chromosomes[chromosomeIndex].length;
+    size_t telomere = telomereLength(length);
+    size_t centromere = centromereLength(length);
+
+    RegionGenerator planner(deriveSeed(seed, chromosomeIndex), *config);
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(deriveSeed(seed, chromosomeIndex, 1)));
+
+    /**
+     * NOTE: centromere position -> anywhere between metacentric (0.5) and acrocentric (~0.15) placements
+     */
+    size_t armSpace = length - 2 * telomere - centromere;
+    std::uniform_real_distribution<double> centromereDist(0.15, 0.5);
+    size_t pArm = std::max<size_t>(1, static_cast<size_t>(armSpace * centromereDist(rng)));
+    size_t centromereStart = telomere + pArm;
+    size_t qArmStart = centromereStart + centromere;
+
+    RegionMap regions;
+    regions.push_back(structuralRegion(FeatureType::telomere, 0, telomere, StrandInfo::minus, 0.5));
+
+    RegionMap pArmRegions = planner.planRegions(telomere, centromereStart);
+    regions.insert(regions.end(), pArmRegions.begin(), pArmRegions.end());
+
+    regions.push_back(structuralRegion(FeatureType::centromere, centromereStart, centromere, StrandInfo::plus, 0.38));
+
+    RegionMap qArmRegions = planner.planRegions(qArmStart, length - telomere);
+    regions.insert(regions.end(), qArmRegions.begin(), qArmRegions.end());
+
+    regions.push_back(structuralRegion(FeatureType::telomere, length - telomere, telomere, StrandInfo::plus, 0.5));
+
+    GENOMORPH_COUNT(regions_planned, regions.size());
+    return regions;
+}
+
+GeneModel Genome::planGenes(size_t chromosomeIndex, RegionMap &regions) const {
+
+    GeneModel genes;
+    if (config->genes.splicedFraction <= 0.0) return genes;
+
+    std::mt19937_64 rng(deriveSeed(seed, GENE_MODEL_STREAM, chromosomeIndex));
+    std::bernoulli_distribution spliced(config->genes.splicedFraction);
+
+    for (RegionInfo &region : regions) {
+        if (region.base.type != FeatureType::coding || !spliced(rng)) continue;
+        region.gene = planSplicedGene(region, *config, rng, genes);
+        GENOMORPH_COUNT(genes_planned, region.gene ? 1 : 0);
+    }
+    return genes;
+}
+
+std::vector<MotifSite> Genome::planMotifs(size_t chromosomeIndex, RegionMap &regions) const {
+
+    std::vector<MotifSite> sites;
+    if (config->regulatory.motifDensity <= 0.0) return sites;
+
+    std::mt19937_64 rng(deriveSeed(seed, MOTIF_STREAM, chromosomeIndex));
+    for (RegionInfo &region : regions) {
+        if (region.base.type != FeatureType::regulatory || !region.regulatory_meta_data) continue;
+        planMotifSites(region, *config, rng, sites);
+    }
+    GENOMORPH_COUNT(motifs_planted, sites.size());
+    return sites;
+}
+
+void Genome::plan(unsigned threads) {
+
+    GENOMORPH_ALLOC_STAGE(region_planning);
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    /**
+     * NOTE: the repeat library has its own stream, disjoint from every chromosome index,
+     * and every chromosome copies from the same families.
+     */
+    RepeatGenerator repeatGenerator(deriveSeed(seed, REPEAT_LIBRARY_STREAM));
+    repeatLibrary = repeatGenerator.createFamilies(REPEAT_FAMILIES, config->gcContent[static_cast<size_t>(FeatureType::repeat)]);
+
+    spills.assign(chromosomes.size(), PlanSpill{});
+    planBytesHeld = 0;
+
+    parallelFor(chromosomes.size(), threads, [&](size_t c) {
+        chromosomes[c].regions = planChromosome(c);
+        chromosomes[c].genes = planGenes(c, chromosomes[c].regions);
+        chromosomes[c].motifSites = planMotifs(c, chromosomes[c].regions);
+
+        uint64_t bytes = planBytes(chromosomes[c]);
+        if (planBytesHeld.fetch_add(bytes) + bytes > planBudget) {
+            planBytesHeld.fetch_sub(bytes);
+            spillPlan(c);
+        }
+    });
+}
+
+void Genome::fillRegion(size_t c, size_t r, uint8_t *out) const {
+
+    GENOMORPH_TIME(base_sampling);
+    GENOMORPH_ALLOC_STAGE(base_generation);
+
+    const Chromosome &chromosome = chromosomes[c];
+    const RegionInfo &region = chromosome.regions[r];
+
+    /**
+     * NOTE: one generator per thread, reset per region, so its scratch buffers and codon tables are reused and a
+     * region is filled without allocating; reset() gives the same streams a fresh generator would
+     */
+    thread_local GenomeGenerator generator;
+    generator.reset(deriveSeed(seed, c, r + 2), *config);
+    generator.useRepeatLibrary(repeatLibrary);
+    generator.useGeneModel(chromosome.genes);
+    generator.useMotifSites(chromosome.motifSites);
+    generator.generate_region(region, out);
+
+    GENOMORPH_COUNT(bases_generated, region.base.region_plan.RegionLength());
+    GENOMORPH_COUNT(regions_filled, 1);
+}
+
+void Genome::fillRegion(size_t c, size_t r) {
+    Chromosome &chromosome = chromosomes[c];
+    fillRegion(c, r, chromosome.sequence.codes() + (chromosome.regions[r].base.region_plan.region_start_index - chromosome.sequence.start()));
+}
+
+void Genome::allocateSequence(size_t c) {
+
+    Chromosome &chromosome = chromosomes[c];
+    chromosome.sequence = SequenceBlock(0, chromosome.length);
+    GENOMORPH_COUNT(buffer_allocations, 1);
+
+    for (size_t r = 0; r < chromosome.regions.size(); ++r) {
+        chromosome.sequence.regionColumn().append(static_cast<uint32_t>(r), chromosome.regions[r].base.region_plan.RegionLength());
+    }
+}
+
+void Genome::generate(unsigned threads) {
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    /**
+     * NOTE: planning is cheap and sequential within a chromosome, so chromosomes are planned in parallel first;
+     * filling is then flattened to (chromosome, region) tasks so one long chromosome cannot starve the pool.
+     */
+    plan(threads);
+
+    std::vector<std::pair<size_t, size_t>> tasks;
+    for (size_t c = 0; c < chromosomes.size(); ++c) {
+        allocateSequence(c);
+        for (size_t r = 0; r < chromosomes[c].regions.size(); ++r) tasks.emplace_back(c, r);
+    }
+
+    parallelFor(tasks.size(), threads, [&](size_t t) {
+        fillRegion(tasks[t].first, tasks[t].second);
+    });
+}
+
+void Genome::generate(unsigned threads, const std::function<void(const Chromosome &)> &onChromosome, size_t windowBases) {
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    plan(threads);
+
+    for (size_t c = 0; c < chromosomes.size(); ++c) {
+        Chromosome &chromosome = chromosomes[c];
+        loadPlan(c);
+
+        if (windowBases == 0 || windowBases >= chromosome.length) {
+            allocateSequence(c);
+            parallelFor(chromosome.regions.size(), threads, [&](size_t r) { fillRegion(c, r); });
+            onChromosome(chromosome);
+        } else {
+            const RegionMap &regions = chromosome.regions;
+            for (size_t first = 0; first < regions.size();) {
+                size_t start = regions[first].base.region_plan.region_start_index;
+                size_t end = first + 1;
+                while (end < regions.size() && regions[end].base.region_plan.region_end_index + 1 - start <= windowBases) ++end;
+
+                chromosome.sequence.reset(start, regions[end - 1].base.region_plan.region_end_index + 1 - start);
+                for (size_t r = first; r < end; ++r) {
+                    chromosome.sequence.regionColumn().append(static_cast<uint32_t>(r), regions[r].base.region_plan.RegionLength());
+                }
+                parallelFor(end - first, threads, [&](size_t i) { fillRegion(c, first + i); });
+                onChromosome(chromosome);
+                first = end;
+            }
+        }
+
+        chromosome.sequence.release();
+        releasePlan(c);
+    }
+}
+
+size_t Genome::totalLength() const {
+    size_t total = 0;
+    for (const Chromosome &chromosome : chromosomes) total += chromosome.length;
+    return total;
+}
@@ -1,18 +1,296 @@
 #include "genomeGenerator.hpp"
+#include "allocationProfile.hpp"
+#include "kernels.hpp"
+#include "metrics.hpp"
+#include "rngUtils.hpp"
 #include <iostream>
 #include <sstream>
 #include <random>
+#include <cstdlib>
 #include <ctime>
 #include <fstream>
+#include <stdexcept>
+#include <algorithm>
 
+namespace {
+
+/**
+ * NOTE: TELOMERE_REPEAT -> vertebrate telomeric hexamer, CENTROMERE_MONOMER_LENGTH -> alpha-satellite monomer length
+ */
+constexpr uint8_t   TELOMERE_REPEAT[] =             {BASE_T, BASE_T, BASE_A, BASE_G, BASE_G, BASE_G};
+constexpr size_t    CENTROMERE_MONOMER_LENGTH =     171;
+constexpr double    CENTROMERE_DIVERGENCE =         0.02;
+
+/**
+ * NOTE: share of repeat regions laid down as tandem repeats (micro/minisatellites) rather than interspersed copies
+ */
+constexpr double    TANDEM_REPEAT_FRACTION =        0.3;
+constexpr double    TANDEM_REPEAT_DIVERGENCE =      0.01;
+
+}
 
 GenomeGenerator::GenomeGenerator()
+    : config(&GenerationConfig::defaults())
 {
     rng.seed(static_cast<unsigned>(time(0))); // Seed with system clock
+    baseRng.reseed(static_cast<uint64_t>(time(0)));
+}
+
+GenomeGenerator::GenomeGenerator(uint64_t seed, const GenerationConfig &config)
+    : baseRng(deriveSeed(seed, 1)), regionGenerator(splitmix64(seed), config), config(&config)
+{
+    rng.seed(static_cast<std::mt19937::result_type>(seed ^ (seed >> 32)));
+}
+
+void GenomeGenerator::reset(uint64_t seed, const GenerationConfig &config) {
+
+    rng.seed(static_cast<std::mt19937::result_type>(seed ^ (seed >> 32)));
+    baseRng.reseed(deriveSeed(seed, 1));
+    regionGenerator = RegionGenerator(splitmix64(seed), config);
+    this->config = &config;
+    repeatLibrary = nullptr;
+    geneModel = nullptr;
+    motifSites = nullptr;
 }
 
-char GenomeGenerator::generate_base(RegionInfo region) {
+std::array<double, 4> GenomeGenerator::baseWeights(const RegionInfo &region) {
+
+    /**
+     * NOTE: regionBasedBaseProbabilities answers in A, T, C, G order, the samplers expect base code order
+     */
+    std::array<double, 4> probabilities = regionGenerator.regionBasedBaseProbabilities(region);
+    return {probabilities[0], probabilities[2], probabilities[3], probabilities[1]};
 }
 
-std::vector<BaseInfo> GenomeGenerator::generate_sequence(size_t total_generated, size_t length) {
-}
\ No newline at end of file
+template <FeatureType KIND, unsigned ORDER>
+void GenomeGenerator::fillRegion(const RegionInfo &region, uint8_t *out) {
+
+    const RegionPlan &plan = region.base.region_plan;
+    size_t length = plan.RegionLength();
+
+    if constexpr (KIND == FeatureType::repeat) {
+        RepeatGenerator repeats(rng());
+        std::bernoulli_distribution tandem(TANDEM_REPEAT_FRACTION);
+
+        if (!repeatLibrary || repeatLibrary->empty() || tandem(rng)) {
+            repeats.randomTandemUnit(tandemUnit);
+            repeats.fillTandem(tandemUnit, out, length, TANDEM_REPEAT_DIVERGENCE);
+        } else {
+            /**
+             * NOTE: interspersed region -> consecutive insertions, each a (possibly truncated) copy of one family
+             */
+            std::uniform_int_distribution<size_t> familyDist(0, repeatLibrary->size() - 1);
+            size_t written = 0;
+            while (written < length) {
+                const RepeatFamily &family = (*repeatLibrary)[familyDist(rng)];
+                std::uniform_int_distribution<size_t> copyLength(1, family.consensus.size());
+                size_t chunk = std::min(copyLength(rng), length - written);
+                repeats.insertCopy(family, out + written, chunk);
+                written += chunk;
+            }
+        }
+    } else {
+        std::array<double, 4> weights = baseWeights(region);
+        MarkovSampler<ORDER> sampler(weights, config->cpgRatio[static_cast<size_t>(KIND)]);
+
+        /**
+         * NOTE: regions are filled independently (and in parallel), so every region starts from an A context
+         */
+        uint8_t context = BASE_A;
+
+        if constexpr (KIND == FeatureType::coding) {
+            /**
+             * NOTE: phase = |reading_frame| - 1 bases precede the first codon on the sense strand (GFF3 phase);
+             * a minus-strand region is built as sense strand and written reverse complemented
+             */
+            size_t phase = region.coding ? static_cast<size_t>(std::abs(region.coding->reading_frame)) - 1 : 0;
+            size_t codons = length > phase ? (length - phase) / 3 : 0;
+            bool spliced = region.gene && geneModel;
+
+            if (codons < 2 && !spliced) {
+                sampler.fill(baseRng, out, length, context);
+                return;
+            }
+
+            bool minus = plan.strand == StrandInfo::minus;
+            if (minus) senseScratch.resize(length);
+            uint8_t *sense = minus ? senseScratch.data() : out;
+
+            codonModel.assign(weights);
+            if (spliced) {
+                fillSplicedGene(*region.gene, sampler, sense);
+            } else {
+                sampler.fill(baseRng, sense, phase, context);
+                codonModel.fillOpenReadingFrame(baseRng, sense + phase, codons);
+                context = sense[phase + 3 * codons - 1];
+                sampler.fill(baseRng, sense + phase + 3 * codons, length - phase - 3 * codons, context);
+            }
+
+            if (minus) kernels().reverseComplementCodes(sense, length, out);
+        } else {
+            sampler.fill(baseRng, out, length, context);
+        }
+
+        if constexpr (KIND == FeatureType::regulatory) {
+            if (!motifSites || !region.regulatory_meta_data) return;
+
+            const RegulatoryMetaData &meta = *region.regulatory_meta_data;
+            for (uint32_t s = meta.firstSite; s < meta.firstSite + meta.siteCount; ++s) {
+                const MotifSite &site = (*motifSites)[s];
+                const PositionWeightMatrix &motif = motifLibrary()[site.motif];
+                uint8_t *at = out + (site.start - plan.region_start_index);
+
+                if (site.strand == StrandInfo::plus) {
+                    motif.sample(baseRng, at);
+                } else {
+                    senseScratch.resize(motif.length());
+                    motif.sample(baseRng, senseScratch.data());
+                    kernels().reverseComplementCodes(senseScratch.data(), motif.length(), at);
+                }
+            }
+        }
+    }
+}
+
+template <unsigned ORDER>
+void GenomeGenerator::fillSplicedGene(uint32_t gene, const MarkovSampler<ORDER> &sampler, uint8_t *sense) {
+
+    const GeneModel &genes = *geneModel;
+    const GeneFeature &span = genes[gene];
+    size_t end = geneRunEnd(genes, gene);
+
+    size_t coding = 0;
+    for (size_t f = gene; f < end; ++f) {
+        if (genes[f].type == GeneFeatureType::cds) coding += genes[f].Length();
+    }
+    codingScratch.resize(coding);
+    codonModel.fillOpenReadingFrame(baseRng, codingScratch.data(), coding / 3);
+
+    /**
+     * NOTE: the leaves (UTRs, CDS pieces, introns) follow the exon they belong to in transcription order, so walking them
+     * writes the sense strand front to back and the Markov context carries across feature boundaries
+     */
+    uint8_t context = BASE_A;
+    size_t codingUsed = 0;
+    for (size_t f = gene + 2; f < end; ++f) {
+        const GeneFeature &feature = genes[f];
+        if (feature.type == GeneFeatureType::exon) continue;
+
+        size_t offset = feature.strand == StrandInfo::plus ? feature.start - span.start : span.end - feature.end;
+        size_t length = feature.Length();
+        uint8_t *out = sense + offset;
+
+        if (feature.type == GeneFeatureType::cds) {
+            std::copy_n(codingScratch.data() + codingUsed, length, out);
+            codingUsed += length;
+        } else if (feature.type == GeneFeatureType::intron) {
+            out[0] = BASE_G;
+            out[1] = BASE_T;
+            context = BASE_T;
+            sampler.fill(baseRng, out + 2, length - 4, context);
+            out[length - 2] = BASE_A;
+            out[length - 1] = BASE_G;
+        } else {
+            sampler.fill(baseRng, out, length, context);
+        }
+        context = out[length - 1];
+    }
+}
+
+GenomeGenerator::FillPath GenomeGenerator::selectFillPath(FeatureType type, unsigned order) {
+
+    static constexpr FillPath PATHS[REGION_TYPE_COUNT][2] = {
+        {&GenomeGenerator::fillRegion<FeatureType::coding, 0>,      &GenomeGenerator::fillRegion<FeatureType::coding, 1>},
+        {&GenomeGenerator::fillRegion<FeatureType::non_coding, 0>,  &GenomeGenerator::fillRegion<FeatureType::non_coding, 1>},
+        {&GenomeGenerator::fillRegion<FeatureType::regulatory, 0>,  &GenomeGenerator::fillRegion<FeatureType::regulatory, 1>},
+        {&GenomeGenerator::fillRegion<FeatureType::repeat, 0>,      &GenomeGenerator::fillRegion<FeatureType::repeat, 0>},
+    };
+
+    size_t index = static_cast<size_t>(type);
+    if (index >= REGION_TYPE_COUNT || order > 1) throw std::invalid_argument("no fill path for this region type / Markov order");
+    return PATHS[index][order];
+}
+
+void GenomeGenerator::generate_region(const RegionInfo &region, uint8_t *out) {
+
+    const RegionPlan &plan = region.base.region_plan;
+    size_t length = plan.RegionLength();
+
+    switch (region.base.type) {
+
+        case FeatureType::telomere: {
+            /**
+             * NOTE: a p-arm telomere reads CCCTAA on the forward strand, a q-arm telomere reads TTAGGG.
+             * the planner marks the p-arm telomere with StrandInfo::minus.
+             */
+            for (size_t i = 0; i < length; ++i) {
+                out[i] = plan.strand == StrandInfo::minus ? complementCode(TELOMERE_REPEAT[5 - (i % 6)]) : TELOMERE_REPEAT[i % 6];
+            }
+            break;
+        }
+
+        case FeatureType::centromere: {
+            BaseSampler sampler(baseWeights(region));
+            uint8_t monomer[CENTROMERE_MONOMER_LENGTH];
+            sampler.fill(baseRng, monomer, CENTROMERE_MONOMER_LENGTH);
+
+            for (size_t i = 0; i < length; ++i) out[i] = monomer[i % CENTROMERE_MONOMER_LENGTH];
+
+            /**
+             * NOTE: diverged positions are reached by geometric skips instead of one Bernoulli draw per base
+             */
+            std::geometric_distribution<size_t> gap(CENTROMERE_DIVERGENCE);
+            for (size_t i = gap(rng); i < length; i += 1 + gap(rng)) out[i] = sampler.sample(baseRng);
+            break;
+        }
+
+        default: {
+            size_t type = static_cast<size_t>(region.base.type);
+            (this->*selectFillPath(region.base.type, config->markovOrder(type)))(region, out);
+            break;
+        }
+    }
+}
+
+SequenceBlock GenomeGenerator::generate_sequence(size_t total_generated, size_t length) {
+
+    GENOMORPH_ALLOC_STAGE(base_generation);
+
+    if (length == 0) return SequenceBlock(total_generated, 0);
+
+    RegionMap regions = regionGenerator.planRegions(total_generated, total_generated + length);
+
+    SequenceBlock sequence(total_generated, length);
+    GENOMORPH_COUNT(buffer_allocations, 1);
+    for (uint32_t r = 0; r < regions.size(); ++r) {
+        const RegionPlan &plan = regions[r].base.region_plan;
+        generate_region(regions[r], sequence.codes() + (plan.region_start_index - total_generated));
+        sequence.regionColumn().append(r, plan.RegionLength());
+    }
+
+    return sequence;
+}
+
+SequenceBlock GenomeGenerator::complementary_strand(const SequenceBlock &original) {
+
+    GENOMORPH_TIME(strand_complement);
+    GENOMORPH_ALLOC_STAGE(strand_complement);
+    GENOMORPH_COUNT(buffer_allocations, 1);
+
+    SequenceBlock strand(original.start(), original.size());
+    kernels().complementCodes(original.codes(), original.size(), strand.codes());
+
+    return strand;
+}
+
+SequenceBlock GenomeGenerator::reverse_complement(const SequenceBlock &original) {
+
+    GENOMORPH_TIME(strand_complement);
+    GENOMORPH_ALLOC_STAGE(strand_complement);
+    GENOMORPH_COUNT(buffer_allocations, 1);
+
+    SequenceBlock strand(original.start(), original.size());
+    kernels().reverseComplementCodes(original.codes(), original.size(), strand.codes());
+
+    return strand;
+}
@@ -0,0 +1,136 @@
+#include "lengthDistribution.hpp"
+#include "rngUtils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+namespace {
+
+double normalCdf(double x) {
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+/**
+ * @brief Tabulates the quantile function of a continuous CDF on [low, high] by bisection.
+ * Only runs at config load, INVERSE_CDF_SIZE + 1 bisections of 64 steps each.
+ */
+std::vector<double> tabulateQuantiles(const std::function<double(double)> &cdf, double low, double high, size_t size) {
+
+    double cdfLow = cdf(low);
+    double cdfHigh = cdf(high);
+    std::vector<double> table(size + 1);
+
+    for (size_t i = 0; i <= size; ++i) {
+        double target = cdfLow + (cdfHigh - cdfLow) * static_cast<double>(i) / static_cast<double>(size);
+        double a = low;
+        double b = high;
+        for (int step = 0; step < 64; ++step) {
+            double middle = 0.5 * (a + b);
+            (cdf(middle) < target ? a : b) = middle;
+        }
+        table[i] = 0.5 * (a + b);
+    }
+
+    table.front() = low;
+    table.back() = high;
+    return table;
+}
+
+}
+
+LengthModel parseLengthModel(const std::string &name) {
+    if (name == "uniform") return LengthModel::uniform;
+    if (name == "lognormal" || name == "log_normal") return LengthModel::log_normal;
+    if (name == "geometric") return LengthModel::geometric;
+    if (name == "histogram") return LengthModel::histogram;
+    throw std::invalid_argument("unknown length distribution '" + name + "' (expected uniform, lognormal, geometric or histogram)");
+}
+
+LengthDistribution::LengthDistribution(const LengthSpec &spec)
+    : spec(spec)
+{
+    if (spec.min == 0 || spec.max < spec.min) {
+        throw std::invalid_argument("length distribution needs 0 < min <= max");
+    }
+
+    double low = static_cast<double>(spec.min);
+    double high = static_cast<double>(spec.max);
+
+    switch (spec.model) {
+
+        case LengthModel::uniform:
+            break;
+
+        case LengthModel::log_normal: {
+            if (spec.mean <= 0.0 || spec.sigma <= 0.0) {
+                throw std::invalid_argument("lognormal length distribution needs mean > 0 and sigma > 0");
+            }
+            double mu = std::log(spec.mean) - 0.5 * spec.sigma * spec.sigma;
+            double sigma = spec.sigma;
+            quantiles = tabulateQuantiles([&](double x) { return normalCdf((std::log(x) - mu) / sigma); },
+                                          low, high + 1.0, INVERSE_CDF_SIZE);
+            break;
+        }
+
+        case LengthModel::geometric: {
+            /**
+             * NOTE: geometric -> min + failures before the first success, success probability from the requested mean;
+             * tabulated through its continuous (exponential) envelope so floor() of a draw is exactly geometric.
+             */
+            if (spec.mean < low) {
+                throw std::invalid_argument("geometric length distribution needs mean >= min");
+            }
+            double p = 1.0 / (spec.mean - low + 1.0);
+            double rate = -std::log1p(-std::min(p, 1.0 - 1e-12));
+            quantiles = tabulateQuantiles([&](double x) { return 1.0 - std::exp(-rate * (x - low)); },
+                                          low, high + 1.0, INVERSE_CDF_SIZE);
+            break;
+        }
+
+        case LengthModel::histogram: {
+            if (spec.bins.empty()) {
+                throw std::invalid_argument("histogram length distribution needs at least one bin");
+            }
+            std::vector<double> weights;
+            size_t lower = spec.min;
+            for (const HistogramBin &bin : spec.bins) {
+                if (bin.upper < lower || bin.upper > spec.max) {
+                    throw std::invalid_argument("histogram bins must be increasing and inside [min, max]");
+                }
+                binLower.push_back(lower);
+                weights.push_back(bin.weight);
+                lower = bin.upper + 1;
+            }
+            binTable = AliasTable(weights);
+            break;
+        }
+    }
+}
+
+size_t LengthDistribution::sample(uint64_t random) const {
+
+    switch (spec.model) {
+
+        case LengthModel::uniform: {
+            uint64_t width = spec.max - spec.min + 1;
+            return spec.min + static_cast<size_t>(((random >> 32) * width) >> 32);
+        }
+
+        case LengthModel::histogram: {
+            size_t bin = binTable.sample(random);
+            uint64_t width = spec.bins[bin].upper - binLower[bin] + 1;
+            return binLower[bin] + static_cast<size_t>(((splitmix64(random) >> 32) * width) >> 32);
+        }
+
+        default: {
+            /**
+             * NOTE: quantile index from the top INVERSE_CDF_BITS bits, interpolation weight from the 32 bits below them
+             */
+            size_t index = static_cast<size_t>(random >> (64 - INVERSE_CDF_BITS));
+            double fraction = static_cast<double>((random >> (32 - INVERSE_CDF_BITS)) & 0xFFFFFFFFULL) * (1.0 / 4294967296.0);
+            double value = quantiles[index] + fraction * (quantiles[index + 1] - quantiles[index]);
+            return std::clamp(static_cast<size_t>(value), spec.min, spec.max);
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#include "motifLibrary.hpp"
+#include "baseCodes.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+
+struct MotifEntry {
+    const char     *name;
+    const char     *consensus;
+    RegulatoryKind  kind;
+};
+
+/**
+ * NOTE: MOTIF_TABLE -> core consensus of well-characterised factors; promoters get core-promoter elements,
+ * enhancers activator sites, silencers repressor sites
+ */
+constexpr MotifEntry MOTIF_TABLE[] = {
+    {"TBP_TATA",    "TATAWAWR",                 RegulatoryKind::promoter},
+    {"NFY_CCAAT",   "RRCCAATSR",                RegulatoryKind::promoter},
+    {"SP1_GC",      "GGGGCGGGG",                RegulatoryKind::promoter},
+    {"INR",         "YYANWYY",                  RegulatoryKind::promoter},
+    {"TFIIB_BRE",   "SSRCGCC",                  RegulatoryKind::promoter},
+    {"AP1",         "TGASTCA",                  RegulatoryKind::enhancer},
+    {"CREB_CRE",    "TGACGTCA",                 RegulatoryKind::enhancer},
+    {"MYC_EBOX",    "CACGTG",                   RegulatoryKind::enhancer},
+    {"NFKB",        "GGGRNWYYCC",               RegulatoryKind::enhancer},
+    {"CTCF",        "CCRSYAGRKGGCRS",           RegulatoryKind::enhancer},
+    {"REST_NRSE",   "TTCAGCACCATGGACAGCGCC",    RegulatoryKind::silencer},
+    {"YY1",         "AAGATGGCGGC",              RegulatoryKind::silencer},
+};
+
+}
+
+PositionWeightMatrix::PositionWeightMatrix(std::string name, std::vector<std::array<double, 4>> columns)
+    : name(std::move(name)), columns(std::move(columns))
+{
+    if (this->columns.empty()) throw std::invalid_argument("motif " + this->name + " has no positions");
+    for (const std::array<double, 4> &column : this->columns) {
+        try {
+            columnTables.emplace_back(std::vector<double>(column.begin(), column.end()));
+        } catch (const std::invalid_argument &) {
+            throw std::invalid_argument("motif " + this->name + " has a position without positive weight");
+        }
+    }
+}
+
+PositionWeightMatrix PositionWeightMatrix::fromConsensus(std::string name, const std::string &consensus) {
+
+    std::vector<std::array<double, 4>> columns;
+    for (char symbol : consensus) {
+        uint8_t mask = iupacMask(symbol);
+        if (mask == 0) throw std::invalid_argument("motif " + name + ": not an IUPAC base symbol: '" + symbol + "'");
+        size_t allowed = static_cast<size_t>(__builtin_popcount(mask));
+
+        std::array<double, 4> column {};
+        for (size_t code = 0; code < 4; ++code) {
+            bool match = (mask >> code) & 1;
+            column[code] = allowed == 4 ? 0.25 : match ? CONSENSUS_MATCH / allowed : (1.0 - CONSENSUS_MATCH) / (4 - allowed);
+        }
+        columns.push_back(column);
+    }
+    PositionWeightMatrix matrix(std::move(name), std::move(columns));
+    matrix.consensus = consensus;
+    return matrix;
+}
+
+void PositionWeightMatrix::sample(BlockRng &rng, uint8_t *out) const {
+    for (size_t i = 0; i < columnTables.size(); ++i) out[i] = static_cast<uint8_t>(columnTables[i].sample(rng.next()));
+}
+
+const std::vector<PositionWeightMatrix>& motifLibrary() {
+    static const std::vector<PositionWeightMatrix> library = [] {
+        std::vector<PositionWeightMatrix> built;
+        for (const MotifEntry &entry : MOTIF_TABLE) built.push_back(PositionWeightMatrix::fromConsensus(entry.name, entry.consensus));
+        return built;
+    }();
+    return library;
+}
+
+const std::vector<uint16_t>& motifsFor(RegulatoryKind kind) {
+    static const std::array<std::vector<uint16_t>, REGULATORY_KIND_COUNT> byKind = [] {
+        std::array<std::vector<uint16_t>, REGULATORY_KIND_COUNT> built;
+        for (uint16_t m = 0; m < std::size(MOTIF_TABLE); ++m) built[static_cast<size_t>(MOTIF_TABLE[m].kind)].push_back(m);
+        return built;
+    }();
+    return byKind[static_cast<size_t>(kind)];
+}
+
+void planMotifSites(RegionInfo &region, const GenerationConfig &config, std::mt19937_64 &rng, std::vector<MotifSite> &sites) {
+
+    RegulatoryMetaData &meta = *region.regulatory_meta_data;
+    meta.kind = static_cast<RegulatoryKind>(1 + config.regulatoryKindTable.sample(rng()));
+    meta.firstSite = static_cast<uint32_t>(sites.size());
+    meta.siteCount = 0;
+
+    const std::vector<uint16_t> &motifs = motifsFor(meta.kind);
+    const RegionPlan &plan = region.base.region_plan;
+    size_t length = plan.RegionLength();
+    if (motifs.empty()) return;
+
+    std::poisson_distribution<size_t> count(config.regulatory.motifDensity * static_cast<double>(length) / 1000.0);
+    std::uniform_int_distribution<size_t> pick(0, motifs.size() - 1);
+
+    std::vector<MotifSite> drawn(count(rng));
+    for (MotifSite &site : drawn) {
+        site.motif = motifs[pick(rng)];
+        site.strand = (rng() >> 63) ? StrandInfo::minus : StrandInfo::plus;
+        size_t motifLength = motifLibrary()[site.motif].length();
+        site.start = motifLength > length ? SIZE_MAX
+                   : plan.region_start_index + std::uniform_int_distribution<size_t>(0, length - motifLength)(rng);
+    }
+    std::sort(drawn.begin(), drawn.end(), [](const MotifSite &a, const MotifSite &b) { return a.start < b.start; });
+
+    /**
+     * NOTE: overlapping draws keep the leftmost site, so planted sites never overwrite each other
+     */
+    size_t freeFrom = plan.region_start_index;
+    for (const MotifSite &site : drawn) {
+        if (site.start == SIZE_MAX || site.start < freeFrom) continue;
+        sites.push_back(site);
+        freeFrom = site.start + motifLibrary()[site.motif].length();
+    }
+    meta.siteCount = static_cast<uint32_t>(sites.size() - meta.firstSite);
+}
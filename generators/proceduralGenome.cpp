@@ -0,0 +1,131 @@
+#include "proceduralGenome.hpp"
+#include "baseCodes.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+ProceduralGenome::ProceduralGenome(std::vector<ChromosomeSpec> specs, uint64_t seed, std::shared_ptr<const GenerationConfig> config,
+                                   unsigned threads, size_t cacheBytes)
+    : genome(std::move(specs), seed, std::move(config)),
+      threads(threads ? threads : std::max(1u, std::thread::hardware_concurrency())),
+      cache(BLOCK_SIZE, cacheBytes)
+{
+    genome.plan(this->threads);
+
+    const std::vector<Chromosome> &chromosomes = genome.getChromosomes();
+    for (size_t c = 0; c < chromosomes.size(); ++c) byName.emplace(chromosomes[c].name, c);
+}
+
+size_t ProceduralGenome::chromosomeIndex(const std::string &name) const {
+    auto found = byName.find(name);
+    if (found == byName.end()) throw std::invalid_argument("sequence '" + name + "' is not in the genome");
+    return found->second;
+}
+
+void ProceduralGenome::generateSpan(size_t c, size_t from, size_t to, uint8_t *out) const {
+
+    const RegionMap &regions = genome.getChromosomes()[c].regions;
+
+    /**
+     * NOTE: regions tile the chromosome, so the first region of the span is the last one starting at or before `from`
+     */
+    auto first = std::upper_bound(regions.begin(), regions.end(), from, [](size_t position, const RegionInfo &region) {
+        return position < region.base.region_plan.region_start_index;
+    });
+    size_t firstRegion = static_cast<size_t>(first - regions.begin()) - 1;
+    size_t lastRegion = firstRegion;
+    while (lastRegion + 1 < regions.size() && regions[lastRegion + 1].base.region_plan.region_start_index < to) ++lastRegion;
+
+    parallelFor(lastRegion - firstRegion + 1, threads, [&](size_t i) {
+        size_t r = firstRegion + i;
+        const RegionPlan &plan = regions[r].base.region_plan;
+        size_t regionEnd = plan.region_end_index + 1;
+
+        if (plan.region_start_index >= from && regionEnd <= to) {
+            genome.fillRegion(c, r, out + (plan.region_start_index - from));
+            return;
+        }
+
+        /**
+         * NOTE: a region sticking out of the span is filled whole and clipped; only the first and last region can
+         */
+        std::vector<uint8_t> scratch(plan.RegionLength());
+        genome.fillRegion(c, r, scratch.data());
+        size_t begin = std::max(from, plan.region_start_index);
+        size_t end = std::min(to, regionEnd);
+        std::copy(scratch.begin() + (begin - plan.region_start_index), scratch.begin() + (end - plan.region_start_index), out + (begin - from));
+    });
+}
+
+void ProceduralGenome::fetchCodes(size_t c, size_t start, size_t end, uint8_t *out) const {
+
+    const Chromosome &chromosome = genome.getChromosomes().at(c);
+    if (start > end || end > chromosome.length) {
+        throw std::invalid_argument("range " + std::to_string(start) + "-" + std::to_string(end) + " is outside " + chromosome.name
+                                    + " (length " + std::to_string(chromosome.length) + ")");
+    }
+    if (start == end) return;
+
+    size_t firstBlock = start / BLOCK_SIZE;
+    size_t lastBlock = (end - 1) / BLOCK_SIZE;
+    std::vector<BlockCache::Block> blocks(lastBlock - firstBlock + 1);
+    for (size_t b = firstBlock; b <= lastBlock; ++b) blocks[b - firstBlock] = cache.find(static_cast<uint32_t>(c), b);
+
+    auto overlap = [&](size_t from, size_t to, auto &&copy) {
+        size_t begin = std::max(start, from);
+        size_t finish = std::min(end, to);
+        copy(begin - from, finish - from, out + (begin - start));
+    };
+
+    for (size_t b = firstBlock; b <= lastBlock;) {
+        if (const BlockCache::Block &block = blocks[b - firstBlock]) {
+            overlap(b * BLOCK_SIZE, b * BLOCK_SIZE + block->size(), [&](size_t from, size_t to, uint8_t *into) { block->unpack(from, to, into); });
+            ++b;
+            continue;
+        }
+
+        /**
+         * NOTE: consecutive missing blocks are regenerated as one span so a region covering several of them is filled once;
+         * the caller's bases come straight from the span, the cache gets packed copies
+         */
+        size_t runEnd = b;
+        while (runEnd <= lastBlock && !blocks[runEnd - firstBlock]) ++runEnd;
+
+        size_t from = b * BLOCK_SIZE;
+        size_t to = std::min(runEnd * BLOCK_SIZE, chromosome.length);
+        std::vector<uint8_t> span(to - from);
+        generateSpan(c, from, to, span.data());
+        overlap(from, to, [&](size_t first, size_t last, uint8_t *into) { std::copy(span.begin() + first, span.begin() + last, into); });
+
+        for (; b < runEnd; ++b) {
+            size_t blockStart = b * BLOCK_SIZE - from;
+            size_t blockEnd = std::min(blockStart + BLOCK_SIZE, span.size());
+            cache.insert(static_cast<uint32_t>(c), b, std::make_shared<const PackedBlock>(span.data() + blockStart, blockEnd - blockStart));
+        }
+    }
+}
+
+std::string ProceduralGenome::fetch(const std::string &name, size_t start, size_t end) const {
+
+    size_t c = chromosomeIndex(name);
+    std::vector<uint8_t> codes(end > start ? end - start : 0);
+    fetchCodes(c, start, end, codes.data());
+
+    std::string bases(codes.size(), 'A');
+    for (size_t i = 0; i < codes.size(); ++i) bases[i] = decodeBase(codes[i]);
+    return bases;
+}
+
+FastaRegion ProceduralGenome::resolve(const std::string &region) const {
+    return parseRegion(region, [this](const std::string &name) -> std::optional<uint64_t> {
+        auto found = byName.find(name);
+        if (found == byName.end()) return std::nullopt;
+        return genome.getChromosomes()[found->second].length;
+    }, "the genome");
+}
+
+std::string ProceduralGenome::fetch(const std::string &region) const {
+    FastaRegion resolved = resolve(region);
+    return fetch(resolved.name, resolved.start, resolved.end);
+}
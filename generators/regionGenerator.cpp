@@ -3,13 +3,101 @@
 #include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <stdexcept>
+#include <algorithm>
 
-RegionGenerator::RegionGenerator() {
+RegionGenerator::RegionGenerator()
+    : config(&GenerationConfig::defaults())
+{
     rng.seed(static_cast<unsigned>(time(0))); // Seed with system clock
 }
 
+RegionGenerator::RegionGenerator(uint64_t seed, const GenerationConfig &config)
+    : config(&config)
+{
+    rng.seed(seed);
+}
+
 RegionInfo RegionGenerator::createRegion(size_t currentGenomeLength, size_t genomeLength) {
+
+    if (genomeLength < 100) {
+        throw std::invalid_argument("createRegion: genomeLength must be at least 100");
+    }
+    if (currentGenomeLength >= genomeLength) {
+        throw std::invalid_argument("createRegion: currentGenomeLength must be below genomeLength");
+    }
+
+    const AliasTable &typeTable = previousType < REGION_TYPE_COUNT ? config->transitionTables[previousType]
+                                                                   : config->compositionTable;
+    size_t typeIndex = typeTable.sample(rng());
+    previousType = typeIndex;
+    FeatureType type = static_cast<FeatureType>(typeIndex);
+
+    size_t length = std::min(config->lengthDistributions[typeIndex].sample(rng()), genomeLength - currentGenomeLength);
+    double gcMean = config->gcContent[typeIndex];
+
+    /**
+     * NOTE: coding regions are kept codon aligned whenever the remaining space allows it
+     */
+    if (type == FeatureType::coding && length >= 3) {
+        length -= length % 3;
+    }
+
+    std::bernoulli_distribution strandDist(config->plusStrandBias);
+    StrandInfo strand = strandDist(rng) ? StrandInfo::plus : StrandInfo::minus;
+
+    std::normal_distribution<double> gcJitter(0.0, 0.03);
+    double gc = std::clamp(gcMean + gcJitter(rng), 0.0, 1.0);
+
+    RegionInfo region;
+    region.base.type = type;
+    region.base.region_plan = RegionPlan{currentGenomeLength, currentGenomeLength + length - 1, strand};
+    region.base.GC_CONTENT = gc;
+    region.base.AT_CONTENT = 1.0 - gc;
+
+    if (type == FeatureType::coding) {
+        std::uniform_int_distribution<int> frameDist(1, 3);
+        int frame = frameDist(rng);
+        region.coding = CodingMetaData{static_cast<int8_t>(strand == StrandInfo::plus ? frame : -frame)};
+    }
+    if (type == FeatureType::regulatory) {
+        std::uniform_real_distribution<double> accessibilityDist(0.0, 1.0);
+        region.regulatory_meta_data = RegulatoryMetaData{accessibilityDist(rng)};
+    }
+
+    return region;
+}
+
+RegionMap RegionGenerator::planRegions(size_t startIndex, size_t endIndex) {
+
+    RegionMap regions;
+    size_t position = startIndex;
+
+    while (position < endIndex) {
+        regions.push_back(createRegion(position, endIndex));
+        position = regions.back().base.region_plan.region_end_index + 1;
+    }
+
+    return regions;
+}
+
+void RegionGenerator::setMarkovContext(size_t type) {
+    if (type > REGION_TYPE_COUNT) {
+        throw std::invalid_argument("setMarkovContext: unknown region type index");
+    }
+    previousType = type;
 }
 
 std::array<double, 4> RegionGenerator::regionBasedBaseProbabilities(const RegionInfo &region) {
-}
\ No newline at end of file
+
+    double gc = region.base.GC_CONTENT;
+    double at = region.base.AT_CONTENT;
+
+    if (gc + at <= 0.0) {
+        gc = 0.5;
+        at = 0.5;
+    }
+
+    double total = gc + at;
+    return {at / (2.0 * total), at / (2.0 * total), gc / (2.0 * total), gc / (2.0 * total)};
+}
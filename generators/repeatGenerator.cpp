@@ -0,0 +1,120 @@
+#include "repeatGenerator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * NOTE: substitution partner -> one of the three codes different from `code`, pick in [0, 2]
+ */
+uint8_t substitute(uint8_t code, unsigned pick) {
+    return static_cast<uint8_t>((code + 1 + pick) & 3);
+}
+
+}
+
+RepeatGenerator::RepeatGenerator() {
+    rng.seed(static_cast<unsigned>(time(0))); // Seed with system clock
+}
+
+RepeatGenerator::RepeatGenerator(uint64_t seed) {
+    rng.seed(static_cast<std::mt19937::result_type>(seed ^ (seed >> 32)));
+}
+
+void RepeatGenerator::mutate(uint8_t *out, size_t length, double rate) {
+
+    if (rate <= 0.0 || length == 0) return;
+
+    std::geometric_distribution<size_t> skip(std::min(rate, 1.0));
+    std::uniform_int_distribution<unsigned> pick(0, 2);
+
+    for (size_t i = skip(rng); i < length; i += skip(rng) + 1) {
+        out[i] = substitute(out[i], pick(rng));
+    }
+}
+
+RepeatLibrary RepeatGenerator::createFamilies(size_t count, double gcContent) {
+
+    RepeatLibrary library;
+    library.reserve(count);
+
+    std::bernoulli_distribution isLine(0.35);
+    std::uniform_int_distribution<size_t> sineLength(150, 350);
+    std::uniform_int_distribution<size_t> lineLength(1000, 6000);
+    std::uniform_real_distribution<double> divergence(0.02, 0.30);
+    std::discrete_distribution<int> baseDist({(1.0 - gcContent) / 2, gcContent / 2, gcContent / 2, (1.0 - gcContent) / 2});
+
+    for (size_t f = 0; f < count; ++f) {
+        bool line = isLine(rng);
+        size_t length = line ? lineLength(rng) : sineLength(rng);
+
+        RepeatFamily family;
+        family.name = (line ? "LINE_" : "SINE_") + std::to_string(f);
+        family.consensus.resize(length);
+        for (uint8_t &code : family.consensus) code = static_cast<uint8_t>(baseDist(rng));
+        family.divergence = divergence(rng);
+
+        library.push_back(std::move(family));
+    }
+
+    return library;
+}
+
+void RepeatGenerator::insertCopy(const RepeatFamily &family, uint8_t *out, size_t length) {
+
+    const std::vector<uint8_t> &consensus = family.consensus;
+    if (consensus.empty()) {
+        throw std::invalid_argument("insertCopy: repeat family " + family.name + " has an empty consensus");
+    }
+
+    size_t written = 0;
+    while (written < length) {
+        size_t chunk = std::min(consensus.size(), length - written);
+        std::memcpy(out + written, consensus.data() + (consensus.size() - chunk), chunk);
+        written += chunk;
+    }
+
+    mutate(out, length, family.divergence);
+}
+
+void RepeatGenerator::fillTandem(const std::vector<uint8_t> &unit, uint8_t *out, size_t length, double divergence) {
+
+    if (unit.empty()) {
+        throw std::invalid_argument("fillTandem: tandem unit must not be empty");
+    }
+    if (length == 0) return;
+
+    /**
+     * NOTE: doubling copy -> out[0, filled) is always a whole number of units, so copying it onto itself
+     * keeps the period while the number of memcpy calls grows only logarithmically with length.
+     */
+    size_t filled = std::min(unit.size(), length);
+    std::memcpy(out, unit.data(), filled);
+    while (filled < length) {
+        size_t chunk = std::min(filled, length - filled);
+        std::memcpy(out + filled, out, chunk);
+        filled += chunk;
+    }
+
+    mutate(out, length, divergence);
+}
+
+std::vector<uint8_t> RepeatGenerator::randomTandemUnit() {
+    std::vector<uint8_t> unit;
+    randomTandemUnit(unit);
+    return unit;
+}
+
+void RepeatGenerator::randomTandemUnit(std::vector<uint8_t> &unit) {
+
+    std::bernoulli_distribution microsatellite(0.8);
+    std::uniform_int_distribution<size_t> microLength(1, 6);
+    std::uniform_int_distribution<size_t> miniLength(10, 60);
+    std::uniform_int_distribution<int> baseDist(0, 3);
+
+    unit.resize(microsatellite(rng) ? microLength(rng) : miniLength(rng));
+    for (uint8_t &code : unit) code = static_cast<uint8_t>(baseDist(rng));
+}
@@ -0,0 +1,142 @@
+#include "rnaSeqSimulator.hpp"
+#include "outputPipeline.hpp"
+#include "baseCodes.hpp"
+#include "blockRng.hpp"
+#include "kernels.hpp"
+#include "metrics.hpp"
+#include "parallel.hpp"
+#include "rngUtils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+
+constexpr char      READ_QUALITY =      'I';
+
+/**
+ * @brief Uniform double in [0, 1) from the top 53 bits of a random word.
+ */
+inline double unitInterval(uint64_t random) {
+    return static_cast<double>(random >> 11) * 0x1.0p-53;
+}
+
+}
+
+RnaSeqSimulator::RnaSeqSimulator(const Transcriptome &transcriptome, const RnaSeqSpec &spec, uint64_t seed)
+    : transcriptome(transcriptome), spec(spec), seed(seed), expression(transcriptome.size(), 0.0)
+{
+    if (spec.readLength == 0) throw std::invalid_argument("read length must be positive");
+    if (!(spec.expressionSigma >= 0.0)) throw std::invalid_argument("expression sigma must not be negative");
+    if (!(spec.errorRate >= 0.0 && spec.errorRate <= 1.0)) throw std::invalid_argument("error rate must be in [0, 1]");
+
+    std::mt19937_64 rng(deriveSeed(seed, RNASEQ_STREAM));
+    std::lognormal_distribution<double> level(0.0, spec.expressionSigma);
+
+    std::vector<double> weights;
+    for (size_t i = 0; i < transcriptome.size(); ++i) {
+        double drawn = level(rng);
+        size_t length = transcriptome[i].length;
+        if (length < spec.readLength) continue;
+
+        expression[i] = drawn;
+        sources.push_back(static_cast<uint32_t>(i));
+        weights.push_back(drawn * static_cast<double>(length - spec.readLength + 1));
+    }
+    if (sources.empty()) {
+        throw std::invalid_argument("no transcript is at least " + std::to_string(spec.readLength) + " bases long");
+    }
+    readSource = AliasTable(weights);
+}
+
+void RnaSeqSimulator::simulateBatch(size_t batch, std::string &out) const {
+
+    BlockRng rng(deriveSeed(seed, RNASEQ_STREAM, batch + 1));
+    std::vector<uint8_t> read(spec.readLength);
+    std::vector<uint8_t> reverse(spec.readLength);
+
+    /**
+     * NOTE: substitution errors are placed by geometric skips (one draw per error, not per base);
+     * the skip carries over from read to read, so errors stay a Poisson process over the whole batch. A rate of 1
+     * substitutes every base and 0 none; the distribution only exists in between, where its p is valid
+     */
+    std::optional<std::geometric_distribution<size_t>> gap;
+    if (spec.errorRate > 0.0 && spec.errorRate < 1.0) gap.emplace(spec.errorRate);
+    std::mt19937_64 errorRng(rng.next());
+    auto nextGap = [&]() -> size_t { return gap ? (*gap)(errorRng) : 0; };
+    size_t untilError = spec.errorRate > 0.0 ? nextGap() : SIZE_MAX;
+
+    size_t first = batch * BATCH_READS;
+    size_t last = std::min(spec.reads, first + BATCH_READS);
+    out.reserve(out.size() + (last - first) * (2 * spec.readLength + 64));
+
+    for (size_t index = first; index < last; ++index) {
+        const Transcript &transcript = transcriptome[sources[readSource.sample(rng.next())]];
+        size_t positions = transcript.length - spec.readLength + 1;
+        size_t offset = static_cast<size_t>(unitInterval(rng.next()) * static_cast<double>(positions));
+        bool antisense = rng.next() >> 63;
+
+        transcriptome.extract(transcript, offset, spec.readLength, read.data());
+        const uint8_t *bases = read.data();
+        if (antisense) {
+            kernels().reverseComplementCodes(read.data(), spec.readLength, reverse.data());
+            bases = reverse.data();
+        }
+
+        out += "@r";
+        out += std::to_string(index);
+        out += ' ';
+        out += transcriptome.name(transcript);
+        out += ':';
+        out += std::to_string(offset + 1);
+        out += '-';
+        out += std::to_string(offset + spec.readLength);
+        out += antisense ? ":-\n" : ":+\n";
+
+        size_t sequenceStart = out.size();
+        for (size_t i = 0; i < spec.readLength; ++i) out += decodeBase(bases[i]);
+        while (untilError < spec.readLength) {
+            char &base = out[sequenceStart + untilError];
+            base = decodeBase(static_cast<uint8_t>(encodeBase(base) + 1 + errorRng() % 3));
+            untilError += 1 + nextGap();
+        }
+        if (untilError != SIZE_MAX) untilError -= spec.readLength;
+
+        out += "\n+\n";
+        out.append(spec.readLength, READ_QUALITY);
+        out += '\n';
+    }
+}
+
+void RnaSeqSimulator::writeFastq(const std::string &path, unsigned threads, const IoOptions &io) const {
+
+    std::unique_ptr<OutputFile> file = openOutputFile(path, io);
+    SinkStats &stats = Metrics::instance().sink("fastq");
+
+    /**
+     * NOTE: workers simulate batches straight into pooled chunks of an OrderedWriter, whose thread writes them in batch
+     * order while the next batches are simulated; memory stays bounded by the pool (a few chunks per worker)
+     */
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    OrderedWriter writer(4 * static_cast<size_t>(threads), "fastq", [&](OutputChunk &chunk) {
+        GENOMORPH_SINK_WRITE(stats, chunk.bytes.size());
+        file->write(chunk.bytes);
+    });
+
+    parallelFor(batchCount(), threads, [&](size_t b) {
+        OutputChunk *chunk = writer.acquire(b);
+        try {
+            simulateBatch(b, chunk->bytes);
+        } catch (...) {
+            writer.abort(std::current_exception());
+            throw;
+        }
+        writer.submit(chunk);
+    });
+    writer.finish();
+
+    file->close();
+}
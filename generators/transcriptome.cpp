@@ -0,0 +1,71 @@
+#include "transcriptome.hpp"
+#include "kernels.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+Transcriptome::Transcriptome(const std::vector<Chromosome> &chromosomes) {
+
+    uint32_t regionId = 0;
+    for (uint32_t c = 0; c < chromosomes.size(); ++c) {
+        const Chromosome &chromosome = chromosomes[c];
+        chromosomeNames.push_back(chromosome.name);
+        if (chromosome.sequence.size() != chromosome.length) {
+            throw std::invalid_argument("Transcriptome: chromosome " + chromosome.name + " has no generated sequence");
+        }
+
+        for (const RegionInfo &region : chromosome.regions) {
+            uint32_t id = regionId++;
+            if (region.base.type != FeatureType::coding) continue;
+
+            const RegionPlan &plan = region.base.region_plan;
+            Transcript transcript {c, id, region.gene.has_value(), plan.strand, spans.size(), 0, 0};
+
+            if (region.gene) {
+                for (size_t f = *region.gene, end = geneRunEnd(chromosome.genes, *region.gene); f < end; ++f) {
+                    const GeneFeature &feature = chromosome.genes[f];
+                    if (feature.type != GeneFeatureType::exon) continue;
+                    spans.push_back(ExonSpan{chromosome.sequence.codes() + feature.start, feature.start, feature.Length()});
+                }
+            } else {
+                spans.push_back(ExonSpan{chromosome.sequence.codes() + plan.region_start_index, plan.region_start_index, plan.RegionLength()});
+            }
+
+            transcript.spanCount = spans.size() - transcript.firstSpan;
+            for (size_t s = transcript.firstSpan; s < spans.size(); ++s) transcript.length += spans[s].length;
+            transcripts.push_back(transcript);
+        }
+    }
+}
+
+std::string Transcriptome::name(const Transcript &transcript) const {
+    return "region" + std::to_string(transcript.regionId) + (transcript.spliced ? ".mrna" : "");
+}
+
+void Transcriptome::extract(const Transcript &transcript, size_t offset, size_t count, uint8_t *out) const {
+
+    if (offset > transcript.length || count > transcript.length - offset) {
+        throw std::out_of_range("Transcriptome::extract: range runs past the transcript");
+    }
+
+    /**
+     * NOTE: spans are in transcription order; on the minus strand the sense bases of a span are the reverse complement
+     * of its genomic bases, so sense range [a, b) of a span of length n is genomic [n - b, n - a)
+     */
+    size_t spanStart = 0;
+    for (size_t s = transcript.firstSpan; count > 0 && s < transcript.firstSpan + transcript.spanCount; ++s) {
+        const ExonSpan &span = spans[s];
+        if (offset < spanStart + span.length) {
+            size_t a = offset - spanStart;
+            size_t take = std::min(count, span.length - a);
+            if (transcript.strand == StrandInfo::plus) {
+                std::copy_n(span.codes + a, take, out);
+            } else {
+                kernels().reverseComplementCodes(span.codes + (span.length - a - take), take, out);
+            }
+            out += take;
+            offset += take;
+            count -= take;
+        }
+        spanStart += span.length;
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class AliasTable
+ * @brief Walker/Vose alias table: O(n) build, O(1) draw from a discrete distribution.
+ *
+ * One 64-bit random word drives a draw: the high 32 bits pick a column, the low 32 bits are the biased coin.
+ * Thresholds are stored as 32-bit fixed point so a column costs 8 bytes and the table stays cache resident.
+ */
+
+class AliasTable {
+private:
+    std::vector<uint32_t>   threshold;  /**< keep column i when coin < threshold[i] */
+    std::vector<uint32_t>   alias;      /**< otherwise take alias[i] */
+
+public:
+    AliasTable() = default;
+
+    /**
+     * @brief Builds the table from non-negative weights (need not be normalised).
+     * Throws std::invalid_argument if weights is empty, contains a negative value or sums to zero.
+     */
+    explicit AliasTable(const std::vector<double> &weights) { assign(weights.data(), weights.size()); }
+
+    /**
+     * @brief Rebuilds the table in place from count weights. Storage and build scratch are reused, so rebuilding a
+     * table of the same size does not allocate. Throws like the constructor and then leaves the table unchanged.
+     */
+    void assign(const double *weights, size_t count);
+
+    size_t size() const { return threshold.size(); }
+
+    bool empty() const { return threshold.empty(); }
+
+    /**
+     * @brief Maps one uniformly random 64-bit word to an outcome index.
+     */
+    size_t sample(uint64_t random) const {
+        size_t column = static_cast<size_t>(((random >> 32) * threshold.size()) >> 32);
+        return static_cast<uint32_t>(random) < threshold[column] ? column : alias[column];
+    }
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "metrics.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * NOTE: ALLOCATION PROFILE -> building with -DGENOMORPH_ALLOC_PROFILE (make ALLOC_PROFILE=1) replaces the global
+ * operator new / delete with counting versions (src/allocationProfile.cpp). Counting starts with
+ * AllocationProfile::start() (--alloc-profile) and is charged to the stage the allocating thread is in, set with
+ * GENOMORPH_ALLOC_STAGE; parallelFor workers inherit the stage of the thread that started them. Every other build
+ * keeps the default allocator and turns the stage sites into no-ops.
+ */
+
+/**
+ * @enum AllocationStage
+ * @brief pipeline stage an allocation is charged to; `other` covers everything outside a marked scope.
+ */
+
+enum class AllocationStage {
+    other,
+    region_planning,
+    base_generation,
+    strand_complement,
+    output,
+    COUNT
+};
+
+class AllocationProfile {
+public:
+    /**
+     * @brief Distinct (stage, call site) pairs tracked; further sites are only counted in the stage totals.
+     */
+    static constexpr size_t MAX_SITES = 4096;
+
+    /**
+     * @brief True when the binary was built with GENOMORPH_ALLOC_PROFILE.
+     */
+    static constexpr bool enabled() {
+#ifdef GENOMORPH_ALLOC_PROFILE
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static AllocationStage stage();
+
+    /**
+     * @brief Sets the calling thread's stage and returns the previous one.
+     */
+    static AllocationStage enter(AllocationStage stage);
+
+    /**
+     * @brief Resets every count and starts counting.
+     */
+    static void start();
+
+    static void stop();
+
+    /**
+     * @brief Writes per-stage allocations, bytes, frees, peak live bytes and allocations per Mbp of `bases`, then the
+     * top `sitesPerStage` call sites of each stage (symbolized where the binary exports symbols). Stops counting.
+     */
+    static void report(std::ostream &out, uint64_t bases, size_t sitesPerStage = 5);
+};
+
+/**
+ * @class AllocationScope
+ * @brief charges the calling thread's allocations to a stage for the lifetime of the object.
+ */
+
+class AllocationScope {
+private:
+    AllocationStage     previous;
+
+public:
+    explicit AllocationScope(AllocationStage stage) : previous(AllocationProfile::enter(stage)) {}
+
+    ~AllocationScope() { AllocationProfile::enter(previous); }
+
+    AllocationScope(const AllocationScope &) = delete;
+    AllocationScope& operator=(const AllocationScope &) = delete;
+};
+
+#ifdef GENOMORPH_ALLOC_PROFILE
+#define GENOMORPH_ALLOC_STAGE(stage) AllocationScope GENOMORPH_CONCAT(genomorphAllocationScope, __LINE__)(AllocationStage::stage)
+#else
+#define GENOMORPH_ALLOC_STAGE(stage) ((void)0)
+#endif
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * NOTE: BASE CODES -> every in-memory sequence stores one 2-bit code per base, A=0 C=1 G=2 T=3.
+ * with this order the complement of a code is 3 - code, and C/G are the two codes whose bits differ.
+ */
+
+constexpr char BASE_CHARS[4] = {'A', 'C', 'G', 'T'};
+
+constexpr uint8_t BASE_A = 0;
+constexpr uint8_t BASE_C = 1;
+constexpr uint8_t BASE_G = 2;
+constexpr uint8_t BASE_T = 3;
+
+/**
+ * @brief ASCII -> code lookup; anything that is not A/C/G/T (either case) maps to A.
+ */
+constexpr std::array<uint8_t, 256> BASE_CODE_TABLE = [] {
+    std::array<uint8_t, 256> table {};
+    table['C'] = table['c'] = BASE_C;
+    table['G'] = table['g'] = BASE_G;
+    table['T'] = table['t'] = BASE_T;
+    return table;
+}();
+
+inline constexpr uint8_t encodeBase(char base) {
+    return BASE_CODE_TABLE[static_cast<unsigned char>(base)];
+}
+
+inline constexpr char decodeBase(uint8_t code) {
+    return BASE_CHARS[code & 3];
+}
+
+inline constexpr uint8_t complementCode(uint8_t code) {
+    return static_cast<uint8_t>(3 - code);
+}
+
+inline constexpr bool isGcCode(uint8_t code) {
+    return code == BASE_C || code == BASE_G;
+}
+
+/**
+ * NOTE: CODON INDEX -> a codon's three codes read as a base-4 number, first base most significant (AAA = 0 ... TTT = 63)
+ */
+
+inline constexpr uint8_t codonIndex(uint8_t first, uint8_t second, uint8_t third) {
+    return static_cast<uint8_t>((first << 4) | (second << 2) | third);
+}
+
+constexpr uint8_t START_CODON = codonIndex(BASE_A, BASE_T, BASE_G);
+constexpr uint8_t STOP_CODONS[3] = {codonIndex(BASE_T, BASE_A, BASE_A), codonIndex(BASE_T, BASE_A, BASE_G), codonIndex(BASE_T, BASE_G, BASE_A)};
+
+inline constexpr bool isStopCodon(uint8_t index) {
+    return index == STOP_CODONS[0] || index == STOP_CODONS[1] || index == STOP_CODONS[2];
+}
+
+/**
+ * NOTE: IUPAC MASK -> the base codes a (upper case) IUPAC symbol allows, bit c set for code c; 0 for anything else.
+ * complementing a mask reverses its 4 bits, since complementCode(c) = 3 - c.
+ */
+constexpr std::array<uint8_t, 256> IUPAC_MASK_TABLE = [] {
+    std::array<uint8_t, 256> table {};
+    table['A'] = 0b0001; table['C'] = 0b0010; table['G'] = 0b0100; table['T'] = 0b1000;
+    table['R'] = 0b0101; table['Y'] = 0b1010; table['S'] = 0b0110; table['W'] = 0b1001;
+    table['K'] = 0b1100; table['M'] = 0b0011; table['B'] = 0b1110; table['D'] = 0b1101;
+    table['H'] = 0b1011; table['V'] = 0b0111; table['N'] = 0b1111;
+    return table;
+}();
+
+inline constexpr uint8_t iupacMask(char symbol) {
+    return IUPAC_MASK_TABLE[static_cast<unsigned char>(symbol)];
+}
+
+inline constexpr uint8_t complementMask(uint8_t mask) {
+    return static_cast<uint8_t>(((mask & 1) << 3) | ((mask & 2) << 1) | ((mask & 4) >> 1) | ((mask & 8) >> 3));
+}
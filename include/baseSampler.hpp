@@ -0,0 +1,133 @@
+#pragma once
+
+#include "baseCodes.hpp"
+#include "blockRng.hpp"
+#include "kernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class BaseSampler
+ * @brief Draws base codes from a fixed A/C/G/T distribution using as few random bits per base as it allows.
+ *
+ * Probabilities are quantised to 32-bit fixed point cumulative thresholds. If every threshold is a multiple of
+ * 2^(32-k) for some k in 2..8 a base costs exactly k bits (uniform bases cost 2), otherwise k = 8 and the few
+ * slots straddling a threshold (at most 3 of 256) pull one extra word to resolve the base exactly.
+ * One 64-bit word therefore yields 64 / k bases instead of one generator call per base. The 2-bit (uniform) and
+ * 8-bit paths run through the dispatched unpackCodes / sampleBases kernels.
+ */
+
+class BaseSampler {
+public:
+    static constexpr unsigned MIN_BITS = 2;
+    static constexpr unsigned MAX_BITS = 8;
+
+private:
+    unsigned                                bits = MAX_BITS;
+    bool                                    identity = false;   /**< slot value is the base code (uniform bases) */
+    std::array<uint64_t, 3>                 thresholds {};      /**< base = number of thresholds <= 32-bit draw, up to 2^32 */
+    std::array<uint8_t, 1u << MAX_BITS>     slots {};           /**< leading k bits -> base code or SAMPLE_SPLIT */
+    SampleCutoffs                           cutoffs {};         /**< slots as compares, for the 8-bit kernel */
+
+    uint8_t resolve(uint64_t slot, uint64_t word) const;
+
+public:
+    /**
+     * @brief Builds the sampler from non-negative weights in base code order (A, C, G, T); they need not be normalised.
+     * Throws std::invalid_argument if a weight is negative or not finite, or all weights are zero.
+     */
+    explicit BaseSampler(const std::array<double, 4> &weights);
+
+    unsigned bitsPerDraw() const { return bits; }
+
+    uint8_t sample(BlockRng &rng) const;
+
+    /**
+     * @brief Base for one uniformly random byte (its leading bitsPerDraw() bits), or SAMPLE_SPLIT if that needs resolveByte.
+     */
+    uint8_t codeForByte(uint8_t byte) const { return slots[byte >> (MAX_BITS - bits)]; }
+
+    /**
+     * @brief Base for a byte whose codeForByte is SAMPLE_SPLIT; pulls one word from rng.
+     */
+    uint8_t resolveByte(uint8_t byte, BlockRng &rng) const { return resolve(byte, rng.next()); }
+
+    /**
+     * @brief Writes count base codes to out.
+     */
+    void fill(BlockRng &rng, uint8_t *out, size_t count) const;
+};
+
+/**
+ * @class MarkovSampler
+ * @brief Base sampler conditioned on the previous ORDER bases; the order is a template parameter so each region
+ * type's fill loop is compiled for exactly the context it needs.
+ *
+ * ORDER 0 forwards to BaseSampler::fill (the vectorised kernel path). ORDER 1 keeps one BaseSampler per previous base,
+ * with the weight of G after C scaled by the CpG ratio, flattened into a [previous base][random byte] -> code table.
+ */
+
+template <unsigned ORDER>
+class MarkovSampler;
+
+template <>
+class MarkovSampler<0> {
+private:
+    BaseSampler sampler;
+
+public:
+    MarkovSampler(const std::array<double, 4> &weights, double cpgRatio) : sampler(weights) { (void)cpgRatio; }
+
+    /**
+     * @param context Previous base code; ignored at order 0, updated to the last base written.
+     */
+    void fill(BlockRng &rng, uint8_t *out, size_t count, uint8_t &context) const {
+        sampler.fill(rng, out, count);
+        if (count > 0) context = out[count - 1];
+    }
+};
+
+template <>
+class MarkovSampler<1> {
+private:
+    static constexpr size_t WORD_BATCH = 64;
+
+    std::array<BaseSampler, 4>      rows;
+    std::array<uint8_t, 4 * 256>    codes;  /**< rows[previous].codeForByte(byte) at previous * 256 + byte */
+
+    static std::array<double, 4> afterBase(std::array<double, 4> weights, uint8_t previous, double cpgRatio) {
+        if (previous == BASE_C) weights[BASE_G] *= cpgRatio;
+        return weights;
+    }
+
+public:
+    MarkovSampler(const std::array<double, 4> &weights, double cpgRatio)
+        : rows{BaseSampler(afterBase(weights, BASE_A, cpgRatio)), BaseSampler(afterBase(weights, BASE_C, cpgRatio)),
+               BaseSampler(afterBase(weights, BASE_G, cpgRatio)), BaseSampler(afterBase(weights, BASE_T, cpgRatio))}
+    {
+        for (size_t previous = 0; previous < 4; ++previous) {
+            for (size_t byte = 0; byte < 256; ++byte) codes[previous * 256 + byte] = rows[previous].codeForByte(static_cast<uint8_t>(byte));
+        }
+    }
+
+    void fill(BlockRng &rng, uint8_t *out, size_t count, uint8_t &context) const {
+        uint64_t words[WORD_BATCH];
+        const uint8_t *randomBytes = reinterpret_cast<const uint8_t *>(words);
+        uint8_t previous = context;
+
+        for (size_t i = 0; i < count;) {
+            size_t n = std::min(count - i, WORD_BATCH * sizeof(uint64_t));
+            rng.fill(words, (n + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+            for (size_t j = 0; j < n; ++j) {
+                uint8_t code = codes[previous * 256 + randomBytes[j]];
+                if (code == SAMPLE_SPLIT) code = rows[previous].resolveByte(randomBytes[j], rng);
+                out[i + j] = previous = code;
+            }
+            i += n;
+        }
+        context = previous;
+    }
+};
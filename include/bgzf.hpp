@@ -0,0 +1,76 @@
+#pragma once
+
+#include "outputFile.hpp"
+#include "outputPipeline.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * NOTE: BGZF -> blocked gzip as written by bgzip / htslib: a series of independent gzip members of at most 64 KiB,
+ * each carrying its compressed size in a "BC" extra field, closed by an empty EOF member. Any gzip reader decompresses
+ * it; indexed readers seek to a block via the .gzi index (uint64 count, then uint64 compressed / uncompressed offset
+ * pairs of every block start after the first, all little-endian).
+ */
+
+constexpr size_t BGZF_BLOCK_DATA = 0xff00;  /**< uncompressed bytes per block, the bgzip default */
+constexpr size_t BGZF_MAX_BLOCK = 1 << 16;
+
+/**
+ * @class BgzfOutputFile
+ * @brief OutputFile decorator compressing into BGZF blocks on a pool of worker threads.
+ *
+ * The writing thread fills pooled chunks of BGZF_BLOCK_DATA bytes and queues them; workers deflate them in any order and
+ * an OrderedWriter appends the blocks to the wrapped file in sequence, so the output does not depend on the thread count.
+ * flush() closes the current block early (block boundaries then follow the flush points).
+ */
+
+class BgzfOutputFile : public OutputFile {
+private:
+    std::unique_ptr<OutputFile>                 inner;
+    std::string                                 indexPath;
+    int                                         level;
+
+    std::vector<std::pair<uint64_t, uint64_t>>  index;          /**< writer thread only: (compressed, uncompressed) block starts */
+    uint64_t                                    compressedBytes = 0;
+    uint64_t                                    uncompressedBytes = 0;
+    SinkStats                                   &stats;
+
+    OrderedWriter                               writer;
+    BoundedQueue<OutputChunk *>                 jobs;
+    std::atomic<uint32_t>                       posted {0};
+    std::atomic<bool>                           stopping {false};
+    std::vector<std::thread>                    workers;
+
+    OutputChunk                                 *current = nullptr;
+    uint64_t                                    nextBlock = 0;
+    bool                                        closed = false;
+
+    void compressJobs();
+    void post(OutputChunk *chunk);
+    void postCurrent();
+    void stopWorkers();
+
+public:
+
+    /**
+     * @param inner Destination of the compressed stream; closed by close().
+     * @param indexPath .gzi written on close(), "" -> none.
+     * @param threads Compression workers, 0 -> hardware concurrency.
+     * @param level zlib level 0..9. Throws std::invalid_argument outside that range.
+     */
+    BgzfOutputFile(std::unique_ptr<OutputFile> inner, const std::string &indexPath, unsigned threads, int level);
+
+    ~BgzfOutputFile() override;
+
+    void write(const char *data, size_t size) override;
+    void flush() override;
+    void close() override;
+
+    IoBackend backend() const override { return inner->backend(); }
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "metrics.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class PackedBlock
+ * @brief immutable run of base codes stored 2 bits per base, 32 bases per word (field i = bits 2(i % 32) of word i / 32).
+ */
+
+class PackedBlock {
+private:
+    size_t                  length;
+    std::vector<uint64_t>   words;
+
+public:
+    PackedBlock(const uint8_t *codes, size_t count);
+
+    size_t size() const { return length; }
+
+    size_t bytes() const { return words.size() * sizeof(uint64_t); }
+
+    /**
+     * @brief Writes codes [from, to) to out; whole words go through the dispatched unpackCodes kernel.
+     */
+    void unpack(size_t from, size_t to, uint8_t *out) const;
+};
+
+/**
+ * @class BlockCache
+ * @brief bounded cache of PackedBlocks keyed by (chromosome, block index), shared by concurrent readers.
+ *
+ * Keys are spread over SHARDS independently locked shards, so readers hitting different blocks rarely contend. Each
+ * shard evicts with CLOCK: a hit only sets the slot's reference bit (no list splicing under the lock), and insertion
+ * sweeps the hand past referenced slots, clearing their bits, to the first unreferenced one. Blocks are handed out as
+ * shared pointers, so an evicted block stays valid for readers still copying from it.
+ *
+ * Hits, misses and evictions are always counted per shard (stats()) and also reported through the cache_* metrics.
+ */
+
+class BlockCache {
+public:
+    static constexpr size_t SHARDS = 16;
+
+    using Block = std::shared_ptr<const PackedBlock>;
+
+    struct Stats {
+        uint64_t    hits = 0;
+        uint64_t    misses = 0;
+        uint64_t    evictions = 0;
+        uint64_t    blocks = 0;
+        uint64_t    bytes = 0;          /**< packed bases held */
+        uint64_t    capacityBytes = 0;
+    };
+
+private:
+    struct Slot {
+        uint64_t    key = 0;
+        Block       block;
+        bool        referenced = false;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex                              mutex;
+        std::vector<Slot>                       slots;
+        std::unordered_map<uint64_t, size_t>    index;  /**< key -> slot */
+        size_t                                  capacity = 0;
+        size_t                                  hand = 0;
+        uint64_t                                bytes = 0;
+        std::atomic<uint64_t>                   hits {0};
+        std::atomic<uint64_t>                   misses {0};
+        std::atomic<uint64_t>                   evictions {0};
+    };
+
+    uint64_t                                    capacityBytes;
+    std::array<Shard, SHARDS>                   shards;
+    std::atomic<uint64_t>                       totalBytes {0};
+    GaugeStats                                  &heldBytes;
+
+    static uint64_t key(uint32_t chromosome, uint64_t block) { return (static_cast<uint64_t>(chromosome) << 40) | block; }
+
+    Shard& shardFor(uint64_t key);
+
+public:
+
+    /**
+     * @param blockBases Bases per block; only used to turn capacityBytes into a block count per shard.
+     * @param capacityBytes Upper bound for the packed bases held; 0 disables caching (every find misses).
+     */
+    BlockCache(size_t blockBases, uint64_t capacityBytes);
+
+    BlockCache(const BlockCache &) = delete;
+    BlockCache& operator=(const BlockCache &) = delete;
+
+    /**
+     * @brief The cached block or nullptr; counts a hit or a miss.
+     */
+    Block find(uint32_t chromosome, uint64_t block);
+
+    /**
+     * @brief Caches a block, evicting as needed. A block already present is kept (concurrent regenerations are identical).
+     */
+    void insert(uint32_t chromosome, uint64_t block, Block codes);
+
+    Stats stats();
+};
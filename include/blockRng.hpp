@@ -0,0 +1,52 @@
+#pragma once
+
+#include "kernels.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class BlockRng
+ * @brief xoshiro256++ run as LANES independent streams in lock step, producing random words a block at a time.
+ *
+ * State is stored lane-major (state[word][lane]) so one step is the same few shifts / xors / adds across all lanes,
+ * run by the dispatched xoshiroBlocks kernel (one AVX-512 register or two AVX2 registers per state word). Words come out interleaved: block i holds the i-th output
+ * of lane 0, 1, ..., LANES - 1. next() and fill() read the same stream, so callers may mix them freely.
+ */
+
+class BlockRng {
+public:
+    static constexpr size_t LANES =         KERNEL_RNG_LANES;
+    static constexpr size_t BUFFER_WORDS =  64 * LANES;
+
+private:
+    alignas(64) uint64_t    state[4][LANES];
+    alignas(64) uint64_t    buffer[BUFFER_WORDS];
+    size_t                  cursor = BUFFER_WORDS;
+
+    /**
+     * @brief Advances every lane `blocks` times, writing LANES * blocks words to out.
+     */
+    void generateBlocks(uint64_t *out, size_t blocks);
+
+public:
+    explicit BlockRng(uint64_t seed = 0) { reseed(seed); }
+
+    /**
+     * @brief Restarts the stream; each lane's 256-bit state is expanded from deriveSeed(seed, lane).
+     */
+    void reseed(uint64_t seed);
+
+    uint64_t next() {
+        if (cursor == BUFFER_WORDS) {
+            generateBlocks(buffer, BUFFER_WORDS / LANES);
+            cursor = 0;
+        }
+        return buffer[cursor++];
+    }
+
+    /**
+     * @brief Writes the next count words of the stream; whole blocks bypass the internal buffer.
+     */
+    void fill(uint64_t *out, size_t count);
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+/**
+ * @class BoundedQueue
+ * @brief lock-free bounded multi-producer / multi-consumer ring (Vyukov's sequence-numbered slots).
+ *
+ * Every slot carries a sequence number telling producers and consumers whose turn it is, so a push or pop is one
+ * CAS on the shared position plus one release store on the slot; nothing ever takes a lock. tryPush / tryPop fail
+ * instead of waiting, callers decide how to back off. Serves as SPSC, SPMC and MPSC queue alike.
+ */
+
+template <typename T>
+class BoundedQueue {
+private:
+    struct Slot {
+        std::atomic<size_t>     turn;
+        T                       value;
+    };
+
+    std::unique_ptr<Slot[]>     slots;
+    size_t                      mask;
+
+    /**
+     * NOTE: producer and consumer positions on separate cache lines, they are written by different threads
+     */
+    alignas(64) std::atomic<size_t>     pushPosition {0};
+    alignas(64) std::atomic<size_t>     popPosition {0};
+
+public:
+
+    /**
+     * @brief Creates a queue holding at least `capacity` values (rounded up to a power of two).
+     * Throws std::invalid_argument for a zero capacity.
+     */
+    explicit BoundedQueue(size_t capacity) {
+        if (capacity == 0) throw std::invalid_argument("BoundedQueue: capacity must be positive");
+        size_t size = 1;
+        while (size < capacity) size <<= 1;
+        slots = std::make_unique<Slot[]>(size);
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i) slots[i].turn.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue& operator=(const BoundedQueue &) = delete;
+
+    size_t capacity() const { return mask + 1; }
+
+    /**
+     * @brief Appends value; false when the queue is full.
+     */
+    bool tryPush(T value) {
+        size_t position = pushPosition.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot &slot = slots[position & mask];
+            size_t turn = slot.turn.load(std::memory_order_acquire);
+            if (turn == position) {
+                if (pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = std::move(value);
+                    slot.turn.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (turn < position) {
+                return false;
+            } else {
+                position = pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes the oldest value into `value`; false when the queue is empty.
+     */
+    bool tryPop(T &value) {
+        size_t position = popPosition.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot &slot = slots[position & mask];
+            size_t turn = slot.turn.load(std::memory_order_acquire);
+            if (turn == position + 1) {
+                if (popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    value = std::move(slot.value);
+                    slot.turn.store(position + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (turn < position + 1) {
+                return false;
+            } else {
+                position = popPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
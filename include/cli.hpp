@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @struct CliOptions
+ * @brief parsed command line of `genomorph generate`, `stream`, `orfs`, `rnaseq`, `motifs`, `pwmscan`, `fetch` and `serve`.
+ */
+
+struct CliOptions {
+    std::string                 command;
+    size_t                      length = 0;             /**< total genome length; 0 -> chromosomes from the config file */
+    size_t                      chromosomeCount = 1;    /**< --length is split into this many chromosomes */
+    std::optional<uint64_t>     seed;                   /**< unset -> seeded from the clock and reported on stderr */
+    unsigned                    threads = 0;            /**< 0 -> hardware concurrency */
+    std::string                 format = "fasta";
+    std::string                 annotations;            /**< "" (none) or "gff3" */
+    bool                        proteins = false;       /**< also write <out>.faa */
+    bool                        accessibility = false;  /**< also write <out>.accessibility.bedgraph */
+    std::string                 out = "genomorph";      /**< output prefix; "-" streams FASTA to stdout */
+    std::string                 configPath;
+    size_t                      lineWidth = 60;
+    std::string                 metricsFormat;          /**< "" (off), "json" or "prometheus" */
+    std::string                 metricsOut = "-";       /**< metrics file; "-" -> stderr */
+    double                      metricsInterval = 0.0;  /**< seconds between periodic dumps; 0 -> only at the end */
+    std::string                 io = "auto";            /**< output backend: auto, uring, threads or sync (see outputFile.hpp) */
+    bool                        direct = false;         /**< open outputs with O_DIRECT */
+    size_t                      ioDepth = 4;            /**< chunk buffers per output file */
+    std::string                 compress = "none";      /**< "none" or "bgzf": compress FASTA / FASTQ output (adds .gz and a .gzi) */
+    int                         compressLevel = 6;      /**< zlib level for --compress */
+    std::string                 sequenceName = "chr1";  /**< stream: FASTA record name */
+    size_t                      chunkSize = 1 << 22;    /**< stream: bases per append */
+    std::string                 checkpointPath;         /**< stream: checkpoint file, "" -> none */
+    size_t                      checkpointEvery = 1ULL << 26; /**< stream: bases between checkpoints */
+    bool                        resume = false;         /**< stream: continue from checkpointPath */
+    size_t                      minCodons = 300;        /**< orfs: ORFs this long (codons, stop included) are reported */
+    std::optional<double>       maxSpuriousPerMbp;      /**< orfs: failure threshold for unplanned long ORFs, unset -> none */
+    std::string                 orfBedPath;             /**< orfs: BED6 of long ORFs, "" -> none */
+    size_t                      reads = 1000000;        /**< rnaseq: number of reads */
+    size_t                      readLength = 100;       /**< rnaseq: bases per read */
+    double                      expressionSigma = 1.0;  /**< rnaseq: sd of log transcript expression */
+    double                      errorRate = 0.001;      /**< rnaseq: per-base substitution rate */
+    std::vector<std::string>    motifs;                 /**< motifs: NAME=IUPAC patterns, empty -> the built-in motif library */
+    std::string                 hitsBedPath;            /**< motifs / pwmscan: BED of every hit, "" -> none */
+    double                      minScoreFraction = 0.8; /**< pwmscan: threshold within each motif's score range */
+    std::optional<double>       minRecovery;            /**< pwmscan: failure threshold for recovered planted sites, unset -> none */
+    std::string                 fastaPath;              /**< fetch: indexed FASTA to read, "" -> socket or regenerated */
+    std::vector<std::string>    regions;                /**< fetch: samtools-style regions, printed in order */
+    std::string                 socketPath;             /**< serve: socket to listen on; fetch: server to ask */
+    size_t                      cacheMb = 256;          /**< serve / fetch: block cache cap in MiB of packed bases */
+    uint64_t                    maxMemory = 0;          /**< generate / stream / fetch / serve: byte budget, 0 -> unbounded */
+    std::string                 tmpDir;                 /**< spilled region plans, "" -> $TMPDIR or /tmp */
+    bool                        allocProfile = false;   /**< report allocations per stage on stderr (ALLOC_PROFILE=1 builds) */
+    bool                        help = false;
+};
+
+/**
+ * @brief Parses argv. Throws std::invalid_argument on unknown options or malformed values.
+ */
+CliOptions parseArguments(int argc, char **argv);
+
+void printUsage(std::ostream &out);
+
+/**
+ * @brief Entry point behind main(); returns the process exit code.
+ */
+int runCli(int argc, char **argv);
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "aliasTable.hpp"
+#include "blockRng.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class CodonModel
+ * @brief Samples protein-coding sequence a codon at a time: every codon's weight is the product of its base weights,
+ * stop codons are excluded in-frame, so a generated reading frame is open from its ATG to its final stop codon.
+ */
+
+class CodonModel {
+private:
+    AliasTable senseCodons; /**< 64 columns indexed by codonIndex, stop codons weighted 0 */
+    AliasTable stopCodons;  /**< STOP_CODONS order */
+
+public:
+    CodonModel() = default;
+
+    /**
+     * @brief Builds the codon tables from per-base weights in base code order (A, C, G, T).
+     * Throws std::invalid_argument if a weight is negative or all weights are zero.
+     */
+    explicit CodonModel(const std::array<double, 4> &baseWeights) { assign(baseWeights); }
+
+    /**
+     * @brief Rebuilds the codon tables in place (no allocation once they have been built); throws like the constructor.
+     */
+    void assign(const std::array<double, 4> &baseWeights);
+
+    /**
+     * @brief Writes codonCount * 3 bases of sense strand: ATG, codonCount - 2 sense codons, then a stop codon.
+     * codonCount must be at least 2.
+     */
+    void fillOpenReadingFrame(BlockRng &rng, uint8_t *out, size_t codonCount) const;
+};
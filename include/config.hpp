@@ -0,0 +1,158 @@
+#pragma once
+
+#include "aliasTable.hpp"
+#include "lengthDistribution.hpp"
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+/**
+ * NOTE: REGION_TYPE_COUNT -> number of FeatureTypes the region planner draws from (coding, non_coding, regulatory, repeat);
+ * per-type tables below are indexed by static_cast<size_t>(FeatureType).
+ */
+constexpr size_t REGION_TYPE_COUNT = 4;
+
+/**
+ * @struct ChromosomeSpec
+ * @brief name and length requested for one chromosome / scaffold of the genome.
+ */
+
+struct ChromosomeSpec {
+    std::string     name;
+    size_t          length;
+};
+
+/**
+ * @struct GeneSpec
+ * @brief exon / intron structure given to spliced genes (see geneModel.hpp).
+ */
+
+struct GeneSpec {
+    double          splicedFraction = 0.0;  /**< share of coding regions laid out as spliced genes; 0 keeps every CDS unspliced */
+    double          meanExons = 6.0;        /**< mean exons per spliced gene (at least 2); short regions get fewer */
+    LengthSpec      intron {LengthModel::log_normal,   60, 30000,  1500.0, 1.0, {}};
+    LengthSpec      utr {LengthModel::log_normal,      10, 2000,   200.0,  0.8, {}};
+};
+
+/**
+ * @struct RegulatorySpec
+ * @brief promoter / enhancer / silencer roles of regulatory regions and the binding sites planted into them (see motifLibrary.hpp).
+ */
+
+struct RegulatorySpec {
+    double                  motifDensity = 0.0;             /**< planted sites per kb of regulatory region; 0 plants none */
+    std::array<double, 3>   kindWeights {0.40, 0.45, 0.15}; /**< promoter, enhancer, silencer */
+};
+
+/**
+ * @struct GenerationConfig
+ * @brief declarative description of a synthetic genome, parsed once and then shared read-only by all worker threads.
+ *
+ * File format (INI style, '#' or ';' comments):
+ *
+ *     [composition]          relative weight of each region type (normalised on load)
+ *     coding = 0.20
+ *     [length.coding]        region length distribution per type, truncated to [min, max]
+ *     distribution = lognormal                 uniform | lognormal | geometric | histogram
+ *     min = 150
+ *     max = 15000
+ *     mean = 1200                              lognormal, geometric
+ *     sigma = 0.7                              lognormal (sd of log length)
+ *     bins = 500:0.2, 2000:0.5, 15000:0.3      histogram (upper edge : weight)
+ *     [transitions]          Markov chain over region types: from = to:weight, ...
+ *     regulatory = coding:0.7, non_coding:0.15, regulatory:0.05, repeat:0.1
+ *     [gc]                   mean GC fraction per type
+ *     coding = 0.52
+ *     [cpg]                  observed / expected CpG per type; a value other than 1 makes that type an order-1 Markov chain
+ *     non_coding = 0.25
+ *     [genes]                spliced genes (gene -> mRNA -> exons / CDS / UTRs / GT..AG introns) for a share of coding regions
+ *     spliced = 0.6
+ *     exons = 6                                mean exon count
+ *     [length.intron]        intron and UTR length distributions, same keys as [length.<type>]
+ *     [length.utr]
+ *     [regulatory]           binding sites from a PWM library planted into regulatory regions
+ *     motif_density = 2                        sites per kb
+ *     kinds = promoter:0.4, enhancer:0.45, silencer:0.15
+ *     [strand]
+ *     plus_bias = 0.5        probability that a region lies on the plus strand
+ *     [genome]
+ *     chromosomes = chr1:5000000, chr2:3000000
+ *
+ * Every key is optional and falls back to defaults(); unknown sections or keys are rejected.
+ * A file that sets [composition] but no [transitions] gets independent draws from its composition.
+ */
+
+struct GenerationConfig {
+    using TypeMatrix = std::array<std::array<double, REGION_TYPE_COUNT>, REGION_TYPE_COUNT>;
+
+    std::array<double, REGION_TYPE_COUNT>       composition {0.20, 0.45, 0.15, 0.20};
+    std::array<LengthSpec, REGION_TYPE_COUNT>   lengths {{
+        {LengthModel::log_normal,   150,    15000,  1200.0, 0.7, {}},
+        {LengthModel::log_normal,   200,    200000, 6000.0, 1.0, {}},
+        {LengthModel::log_normal,   100,    5000,   800.0,  0.5, {}},
+        {LengthModel::geometric,    50,     8000,   600.0,  0.0, {}}
+    }};
+
+    /**
+     * NOTE: TRANSITIONS -> row = previous region type, column = next region type (promoter -> gene -> intergenic ...)
+     */
+    TypeMatrix                                  transitions {{
+        {0.10, 0.60, 0.10, 0.20},
+        {0.10, 0.30, 0.30, 0.30},
+        {0.70, 0.15, 0.05, 0.10},
+        {0.10, 0.55, 0.15, 0.20}
+    }};
+    bool                                        transitionsFromComposition = false;
+
+    std::array<double, REGION_TYPE_COUNT>       gcContent {0.52, 0.38, 0.60, 0.42};
+
+    /**
+     * NOTE: CPG RATIO -> the weight of G after a C is multiplied by this factor; 1.0 keeps bases independent (Markov order 0)
+     */
+    std::array<double, REGION_TYPE_COUNT>       cpgRatio {1.0, 1.0, 1.0, 1.0};
+    GeneSpec                                    genes;
+    RegulatorySpec                              regulatory;
+    double                                      plusStrandBias = 0.5;
+    std::vector<ChromosomeSpec>                 chromosomes;
+
+    /**
+     * NOTE: derived sampling tables, rebuilt by finalize(); immutable afterwards and safe to share between threads
+     */
+    AliasTable                                              compositionTable;
+    std::array<AliasTable, REGION_TYPE_COUNT>               transitionTables;
+    std::array<LengthDistribution, REGION_TYPE_COUNT>       lengthDistributions;
+    LengthDistribution                                      intronLengths;
+    LengthDistribution                                      utrLengths;
+    AliasTable                                              regulatoryKindTable;    /**< index + 1 = RegulatoryKind */
+
+    /**
+     * @brief Built-in configuration used when no config file is given.
+     */
+    static const GenerationConfig& defaults();
+
+    /**
+     * @brief Parses a config file.
+     * Throws std::runtime_error if the file cannot be read and std::invalid_argument (with line number) on malformed input.
+     */
+    static GenerationConfig fromFile(const std::string &path);
+
+    static GenerationConfig parse(std::istream &in, const std::string &sourceName);
+
+    /**
+     * @brief Hash of every generation-relevant value (not the chromosome list); checkpoints refuse to resume under a different config.
+     */
+    uint64_t fingerprint() const;
+
+    /**
+     * @brief Base-level Markov order used when sampling a region of this type (0 or 1).
+     */
+    unsigned markovOrder(size_t type) const { return cpgRatio[type] != 1.0 ? 1 : 0; }
+
+    /**
+     * @brief Validates the tables and builds the derived sampling tables. Throws std::invalid_argument on inconsistent values.
+     */
+    void finalize();
+};
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "config.hpp"
+#include "regionGenerator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+/**
+ * @enum GeneFeatureType
+ * @brief Sequence Ontology kinds a spliced gene is made of (the GENE -> TRANSCRIPT -> EXON / INTRON / UTR levels of METADATA.MD).
+ */
+
+enum class GeneFeatureType : uint8_t {
+    gene,
+    mrna,
+    exon,
+    cds,
+    intron,
+    five_prime_utr,
+    three_prime_utr
+};
+
+constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+/**
+ * @struct GeneFeature
+ * @brief one node of a gene hierarchy, 0-based inclusive chromosome coordinates like RegionPlan.
+ */
+
+struct GeneFeature {
+    size_t              start;
+    size_t              end;
+    uint32_t            parent;     /**< index of the parent feature in the same GeneModel, NO_PARENT for a gene */
+    GeneFeatureType     type;
+    StrandInfo          strand;
+    uint8_t             phase;      /**< CDS: bases before its first whole codon (GFF3 phase); 0 for other kinds */
+
+    size_t Length() const { return end - start + 1; }
+};
+
+/**
+ * NOTE: GeneModel -> every gene feature of one chromosome in a flat parent-index array. a gene is one contiguous run:
+ * the gene, its mRNA, then per exon the exon followed by the UTR / CDS pieces inside it, with the intron after it,
+ * all in transcription (5' -> 3') order. parents therefore precede their children, and the leaves (UTR, CDS, intron)
+ * tile the gene in sense-strand order.
+ */
+using GeneModel = std::vector<GeneFeature>;
+
+/**
+ * @brief One past the last feature of the gene whose gene feature is at index `gene`.
+ */
+size_t geneRunEnd(const GeneModel &genes, size_t gene);
+
+/**
+ * @brief Lays a spliced gene over a planned coding region and appends its features to `genes`.
+ * The gene spans the whole region: 5' UTR, then exon CDS pieces separated by GT..AG introns, then 3' UTR. Exon, intron and
+ * UTR lengths come from config.genes; the CDS pieces add up to a whole number of codons (ATG ... stop once spliced).
+ * @return Index of the new gene feature, or nullopt (nothing appended) when the region is too short for two exons.
+ */
+std::optional<uint32_t> planSplicedGene(const RegionInfo &region, const GenerationConfig &config, std::mt19937_64 &rng, GeneModel &genes);
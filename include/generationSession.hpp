@@ -0,0 +1,129 @@
+#pragma once
+
+#include "config.hpp"
+#include "genomeGenerator.hpp"
+#include "regionGenerator.hpp"
+#include "repeatGenerator.hpp"
+#include "sequenceBlock.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class GenerationSession
+ * @brief incremental generator for one long sequence: append() any chunk size, checkpoint, resume elsewhere.
+ *
+ * Every region is created and filled from its own seed (master seed + region index), so the whole generator state
+ * reduces to a few integers: the current region index and start, the Markov context that preceded it, the number of
+ * bases emitted and the GC window. A checkpoint is that state plus the packed GC window (~300 bytes); resume replays the
+ * current region from its seed and skips the bases already emitted. Output is identical for any chunking and any
+ * number of checkpoint/resume cycles.
+ *
+ * Checkpoint layout (little-endian):
+ *
+ *     "GMCP" | u32 version | u64 seed | u64 target length | u64 generated | u64 region index | u64 region start
+ *     | u32 markov context | u64 config fingerprint | u32 line width | u32 name length | record name
+ *     | u32 window fill | u32 window head | u32 window gc | ceil(GC_WINDOW / 4) packed window codes
+ *
+ * The record name and line width describe the output the session is written to (see setRecordLayout); version 1
+ * checkpoints predate them and resume with an empty name and a line width of 0.
+ */
+
+class GenerationSession {
+private:
+    uint64_t                                    seed;
+    size_t                                      targetLength;
+    std::shared_ptr<const GenerationConfig>     config;
+    RepeatLibrary                               repeatLibrary;
+    RegionGenerator                             planner;
+
+    size_t                                      generatedBases = 0;
+    uint64_t                                    regionIndex = 0;
+    size_t                                      contextBeforeRegion = REGION_TYPE_COUNT;
+    RegionInfo                                  region {};
+    std::vector<uint8_t>                        regionCodes;
+    GenomeGenerator                             filler;     /**< reset per region, keeps its scratch buffers */
+    bool                                        hasRegion = false;
+    RegionMap                                   startedRegions;
+
+    std::vector<uint8_t>                        gcWindow;
+    size_t                                      windowFill = 0;
+    size_t                                      windowHead = 0;
+    size_t                                      windowGc = 0;
+
+    std::string                                 recordName;
+    size_t                                      lineWidth = 0;
+
+    /**
+     * @brief Creates region `regionIndex` at `start` from the stored Markov context and fills its codes.
+     */
+    void materializeRegion(size_t start);
+
+    void pushWindow(const uint8_t *codes, size_t count);
+
+public:
+
+    /**
+     * @brief Bases covered by the sliding GC window.
+     */
+    static constexpr size_t GC_WINDOW = 1000;
+
+    /**
+     * @param seed Master seed of the stream.
+     * @param targetLength Total bases the stream will have; bounds the last region. Must be at least 100.
+     * @param config Region tables (defaults when null).
+     */
+    GenerationSession(uint64_t seed, size_t targetLength, std::shared_ptr<const GenerationConfig> config = nullptr);
+
+    /**
+     * @brief Emits the next min(length, remaining()) bases.
+     * @return SequenceBlock starting at the previous generated() value; its region column holds global region indices.
+     */
+    SequenceBlock append(size_t length);
+
+    size_t generated() const { return generatedBases; }
+
+    size_t remaining() const { return targetLength - generatedBases; }
+
+    size_t getTargetLength() const { return targetLength; }
+
+    uint64_t getSeed() const { return seed; }
+
+    /**
+     * @brief GC fraction of the last GC_WINDOW emitted bases (fewer at the very start).
+     */
+    double windowGcFraction() const { return windowFill ? static_cast<double>(windowGc) / windowFill : 0.0; }
+
+    /**
+     * @brief Records the FASTA record name and line width the stream is written with, so a resume lays out the rest of
+     * the file the same way.
+     */
+    void setRecordLayout(const std::string &name, size_t width) {
+        recordName = name;
+        lineWidth = width;
+    }
+
+    const std::string& getRecordName() const { return recordName; }
+
+    size_t getLineWidth() const { return lineWidth; }
+
+    /**
+     * @brief Returns and forgets the regions started since the previous call (for streaming annotations).
+     */
+    RegionMap takeStartedRegions();
+
+    /**
+     * @brief Writes the session state to `path` atomically (temporary file + rename).
+     * Throws std::runtime_error on I/O failure.
+     */
+    void saveCheckpoint(const std::string &path) const;
+
+    /**
+     * @brief Rebuilds a session from a checkpoint.
+     * Throws std::runtime_error if the file is unreadable or malformed and std::invalid_argument if `config`
+     * differs from the one the checkpoint was written with.
+     */
+    static GenerationSession resume(const std::string &path, std::shared_ptr<const GenerationConfig> config = nullptr);
+};
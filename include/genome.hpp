@@ -0,0 +1,175 @@
+#pragma once
+
+#include "config.hpp"
+#include "geneModel.hpp"
+#include "genomeGenerator.hpp"
+#include "motifLibrary.hpp"
+#include "regionGenerator.hpp"
+#include "repeatGenerator.hpp"
+#include "sequenceBlock.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @struct Chromosome
+ * @brief one named sequence of the genome with its own RegionMap.
+ *
+ * NOTE: coordinates in regions and sequence are 0-based and local to the chromosome (the SCAFFOLD_ID of METADATA.MD is `name`).
+ * sequence.regionColumn() maps every base to its index in `regions`; spliced coding regions point into `genes`,
+ * regulatory regions into `motifSites`.
+ */
+
+struct Chromosome {
+    std::string             name;
+    size_t                  length = 0;
+    RegionMap               regions;
+    GeneModel               genes;
+    std::vector<MotifSite>  motifSites;
+    SequenceBlock           sequence;
+};
+
+class Genome {
+private:
+    uint64_t                                    seed;
+    std::shared_ptr<const GenerationConfig>     config;
+    std::vector<Chromosome>                     chromosomes;
+    RepeatLibrary                               repeatLibrary;
+
+    /**
+     * NOTE: PLAN SPILL -> plans past planBudget bytes are written to an unlinked temporary file in spillDirectory and
+     * read back while their chromosome is filled (see limitPlanMemory); spills[c].size == 0 -> plan c is in memory
+     */
+    struct PlanSpill {
+        uint64_t    offset = 0;
+        uint64_t    size = 0;
+    };
+
+    uint64_t                                    planBudget = UINT64_MAX;
+    std::string                                 spillDirectory;
+    std::atomic<uint64_t>                       planBytesHeld {0};
+    std::vector<PlanSpill>                      spills;
+    std::mutex                                  spillMutex;
+    int                                         spillFd = -1;
+    uint64_t                                    spillEnd = 0;
+
+    void spillPlan(size_t c);
+
+    void loadPlan(size_t c);
+
+    void releasePlan(size_t c);
+
+    /**
+     * @brief Lays out telomere - p arm - centromere - q arm - telomere for one chromosome.
+     */
+    RegionMap planChromosome(size_t chromosomeIndex) const;
+
+    /**
+     * @brief Turns a config.genes.spliced share of the chromosome's coding regions into spliced genes (sets RegionInfo::gene).
+     */
+    GeneModel planGenes(size_t chromosomeIndex, RegionMap &regions) const;
+
+    /**
+     * @brief Gives every regulatory region a kind and plants config.regulatory.motif_density binding sites into it;
+     * a no-op (kinds stay unspecified) when the density is 0.
+     */
+    std::vector<MotifSite> planMotifs(size_t chromosomeIndex, RegionMap &regions) const;
+
+    /**
+     * @brief Fills region r of chromosome c into its sequence (the whole chromosome or a window holding the region);
+     * safe to call concurrently for distinct regions.
+     */
+    void fillRegion(size_t c, size_t r);
+
+    /**
+     * @brief Allocates the base codes of chromosome c and annotates them with region ids.
+     */
+    void allocateSequence(size_t c);
+
+public:
+
+    /**
+     * @brief Number of interspersed repeat families shared by all chromosomes.
+     */
+    static constexpr size_t REPEAT_FAMILIES = RepeatGenerator::DEFAULT_FAMILY_COUNT;
+
+    /**
+     * @brief Smallest chromosome the planner accepts: room for both telomeres, the centromere and one region per arm.
+     */
+    static constexpr size_t MIN_CHROMOSOME_LENGTH = 1000;
+
+    /**
+     * @brief Creates an empty genome; call generate() to plan and fill it.
+     * @param specs Chromosomes in output order.
+     * @param seed Master seed, every chromosome and region derives its own stream from it.
+     * @param config Region tables shared read-only by all workers (defaults when null).
+     * Throws std::invalid_argument for an empty spec list, duplicate names or chromosomes shorter than MIN_CHROMOSOME_LENGTH.
+     */
+    Genome(std::vector<ChromosomeSpec> specs, uint64_t seed, std::shared_ptr<const GenerationConfig> config = nullptr);
+
+    ~Genome();
+
+    Genome(const Genome &) = delete;
+    Genome& operator=(const Genome &) = delete;
+
+    /**
+     * @brief Keeps at most `bytes` of chromosome plans (regions, genes, motif sites) in memory during plan(); the others
+     * are spilled to an unlinked temporary file in `directory` and loaded back one chromosome at a time by the
+     * streaming generate(). Results do not change. Call before generate().
+     */
+    void limitPlanMemory(uint64_t bytes, const std::string &directory);
+
+    /**
+     * @brief Bytes of plans spilled by the last plan().
+     */
+    uint64_t spilledPlanBytes() const { return spillEnd; }
+
+    /**
+     * @brief Upper bound for any planned region of a chromosome this long: the longest telomere, centromere or
+     * config region length. Windows and per-worker scratch are sized from it.
+     */
+    static size_t maxRegionLength(size_t chromosomeLength, const GenerationConfig &config);
+
+    /**
+     * @brief Plans every chromosome, then fills all regions of all chromosomes concurrently.
+     * @param threads Worker thread count (0 -> hardware concurrency).
+     * The result depends only on the seed, never on the thread count.
+     */
+    void generate(unsigned threads);
+
+    /**
+     * @brief Streaming variant: chromosomes are filled one after another (regions in parallel), handed to
+     * onChromosome in order and their sequence released afterwards, so peak memory is one chromosome.
+     * Produces exactly the same bases as generate().
+     * @param windowBases 0 -> one call per chromosome. Otherwise a chromosome is filled in windows of whole regions of at
+     * most windowBases bases (a longer region is a window of its own), one call per window with chromosome.sequence
+     * holding just that window (sequence.start() is its offset), so peak memory is one window. The plan is complete
+     * in every call; a chromosome starts with the window at offset 0 and ends with the one reaching its length.
+     */
+    void generate(unsigned threads, const std::function<void(const Chromosome &)> &onChromosome, size_t windowBases = 0);
+
+    /**
+     * @brief Builds the repeat library and plans every chromosome in parallel (regions, genes, motif sites) without
+     * filling any base; generate() starts with this, ProceduralGenome stops here and fills regions on demand.
+     * @param threads Worker thread count (0 -> hardware concurrency).
+     */
+    void plan(unsigned threads);
+
+    /**
+     * @brief Fills region r of a planned chromosome c into out (room for the region's length), exactly as generate() would.
+     * Every region has its own seed and starts from a fixed Markov context, so any region can be filled alone, in any
+     * order and concurrently with others.
+     */
+    void fillRegion(size_t c, size_t r, uint8_t *out) const;
+
+    const std::vector<Chromosome>& getChromosomes() const { return chromosomes; }
+
+    const RepeatLibrary& getRepeatLibrary() const { return repeatLibrary; }
+
+    size_t totalLength() const;
+};
@@ -1,35 +1,124 @@
 #pragma once
 
+#include "baseSampler.hpp"
+#include "blockRng.hpp"
+#include "codonModel.hpp"
+#include "geneModel.hpp"
+#include "motifLibrary.hpp"
 #include "regionGenerator.hpp"
+#include "repeatGenerator.hpp"
+#include "sequenceBlock.hpp"
 
 #include <vector>
 #include <string>
 #include <random>
 #include <ctime>
 
-/**
- * @struct BaseInfo
- * @brief conatins information regard position of base in the sequence as well as base type amongst [A,T,G,C]
- */
+class GenomeGenerator {
+private:
+    std::mt19937 rng; /**< Random number generator seeded with system clock; drives per-region decisions. */
 
-struct BaseInfo {
+    BlockRng baseRng; /**< Block generator feeding the per-base samplers. */
 
-    char        base;
-    size_t      position;
-};
+    RegionGenerator regionGenerator; /**< Plans regions for generate_sequence and supplies base probabilities. */
 
-class GenomeGenerator {
-private:
-    std::mt19937 rng; /**< Random number generator seeded with system clock. */
+    const GenerationConfig *config; /**< CpG ratios / Markov orders per region type; shared, never owned. */
+
+    const RepeatLibrary *repeatLibrary = nullptr; /**< Families copied into interspersed repeat regions, not owned. */
+
+    const GeneModel *geneModel = nullptr; /**< Exon / intron layouts of spliced coding regions, not owned. */
+
+    const std::vector<MotifSite> *motifSites = nullptr; /**< Binding sites regulatory regions index into, not owned. */
+
+    std::vector<uint8_t> senseScratch; /**< Sense strand of a minus-strand coding region before reverse complementing. */
+
+    std::vector<uint8_t> codingScratch; /**< Unspliced ORF of a spliced gene before it is cut into exons. */
+
+    std::vector<uint8_t> tandemUnit; /**< Unit of the tandem repeat region being filled. */
+
+    CodonModel codonModel; /**< Codon tables of the coding region being filled, rebuilt in place per region. */
 
-    char generate_base(RegionInfo region);
+    /**
+     * @brief Base weights of a sampled region in base code order (AT / GC split evenly between the two bases of each pair).
+     */
+    std::array<double, 4> baseWeights(const RegionInfo &region);
+
+    /**
+     * NOTE: FILL PATHS -> one fully specialised fill loop per (region type, Markov order), chosen once per region by
+     * selectFillPath; nothing inside the loops branches on the region type again.
+     */
+    using FillPath = void (GenomeGenerator::*)(const RegionInfo &, uint8_t *);
+
+    template <FeatureType KIND, unsigned ORDER>
+    void fillRegion(const RegionInfo &region, uint8_t *out);
+
+    static FillPath selectFillPath(FeatureType type, unsigned order);
+
+    /**
+     * @brief Writes the sense strand of a spliced gene: one ORF (from codonModel) cut into its CDS pieces, GT..AG introns,
+     * sampled UTRs.
+     */
+    template <unsigned ORDER>
+    void fillSplicedGene(uint32_t gene, const MarkovSampler<ORDER> &sampler, uint8_t *sense);
 
 public:
 
     GenomeGenerator();
 
-    std::vector<BaseInfo> generate_sequence(size_t currentGenomeLength, size_t length);
+    /**
+     * @brief Constructs a GenomeGenerator with a fixed seed; region planning and base sampling become reproducible.
+     * @param config Region tables used by generate_sequence; must outlive the generator.
+     */
+    explicit GenomeGenerator(uint64_t seed, const GenerationConfig &config = GenerationConfig::defaults());
+
+    /**
+     * @brief Puts the generator in the state GenomeGenerator(seed, config) starts in (no repeat library, gene model or
+     * motif sites) while keeping its scratch buffers and codon tables, so a reused generator fills regions without allocating.
+     */
+    void reset(uint64_t seed, const GenerationConfig &config);
+
+    /**
+     * @brief Plans and fills [currentGenomeLength, currentGenomeLength + length).
+     * @return SequenceBlock starting at currentGenomeLength; iterating it yields BaseInfo with absolute positions.
+     */
+    SequenceBlock generate_sequence(size_t currentGenomeLength, size_t length);
+
+    /**
+     * @brief Fills every base of an already planned region.
+     * @param region Region to fill; positions written are region_start_index .. region_end_index.
+     * @param out Destination base codes with room for region.base.region_plan.RegionLength() bases.
+     * Telomeres, centromeres and repeats are filled by copying repeat units. Coding regions are an open reading frame
+     * (ATG ... stop) in their reading frame and strand, drawn codon by codon, or with RegionInfo::gene set the spliced
+     * gene of the model given to useGeneModel; the remaining types are sampled base by base with the type's Markov order
+     * (see GenerationConfig::cpgRatio), regulatory regions then get their planted binding sites (see useMotifSites).
+     */
+    void generate_region(const RegionInfo &region, uint8_t *out);
+
+    /**
+     * @brief Makes repeat regions insert diverged copies of these families; without a library repeats are tandem only.
+     * @param library Must outlive the generator.
+     */
+    void useRepeatLibrary(const RepeatLibrary &library) { repeatLibrary = &library; }
+
+    /**
+     * @brief Gene layouts RegionInfo::gene indexes into; without a model every coding region is filled unspliced.
+     * @param genes Must outlive the generator.
+     */
+    void useGeneModel(const GeneModel &genes) { geneModel = &genes; }
+
+    /**
+     * @brief Binding sites RegulatoryMetaData::firstSite indexes into; each is overwritten with a sample of its motif's PWM
+     * (reverse complemented on the minus strand). Without sites regulatory regions are background only.
+     * @param sites Must outlive the generator.
+     */
+    void useMotifSites(const std::vector<MotifSite> &sites) { motifSites = &sites; }
+
+    SequenceBlock complementary_strand(const SequenceBlock &original); 
 
-    std::vector<BaseInfo> complementary_strand(const std::vector<BaseInfo> &original); 
+    /**
+     * @brief Minus strand read 5' -> 3': base i is the complement of original base size() - 1 - i.
+     * The block keeps original.start(); its region column is left empty.
+     */
+    SequenceBlock reverse_complement(const SequenceBlock &original);
 
 };
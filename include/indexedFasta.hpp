@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @struct FaiRecord
+ * @brief one line of a samtools .fai index: where a record's bases start and how its lines are laid out.
+ */
+
+struct FaiRecord {
+    std::string     name;
+    uint64_t        length = 0;     /**< bases */
+    uint64_t        offset = 0;     /**< byte offset of the first base (uncompressed) */
+    uint64_t        lineBases = 0;  /**< bases per full line */
+    uint64_t        lineWidth = 0;  /**< bytes per full line, newline included */
+};
+
+/**
+ * @brief `name length offset lineBases lineWidth`, tab separated, newline terminated.
+ */
+std::string faiLine(const FaiRecord &record);
+
+/**
+ * @brief Parses a .fai file. Throws std::runtime_error if it cannot be read or a line is malformed.
+ */
+std::vector<FaiRecord> readFai(const std::string &path);
+
+/**
+ * @struct FastaRegion
+ * @brief a resolved samtools-style region: bases [start, end) (0-based) of sequence `name`.
+ */
+
+struct FastaRegion {
+    std::string     name;
+    uint64_t        start = 0;
+    uint64_t        end = 0;
+};
+
+/**
+ * @brief Resolves `name`, `name:start` or `name:start-end` (1-based, inclusive, commas allowed); end is clipped to the sequence.
+ * @param lengthOf Length of a sequence by name, nullopt when there is no such sequence; a name containing ':' wins over
+ * the name:range reading, as in samtools.
+ * @param source Named in the error for an unknown sequence (a path, "the genome", ...).
+ * Throws std::invalid_argument for malformed regions and unknown sequences.
+ */
+FastaRegion parseRegion(const std::string &region, const std::function<std::optional<uint64_t>(const std::string &)> &lengthOf,
+                        const std::string &source);
+
+/**
+ * @class IndexedFasta
+ * @brief random access into an uncompressed FASTA through its .fai and a read-only mapping of the file.
+ *
+ * A fetch computes the byte offset of its first base from the index and copies line by line, skipping newlines;
+ * nothing is read before or after the requested range, and pages are only faulted in for the bases returned.
+ */
+
+class IndexedFasta {
+private:
+    std::string                                 path;
+    const char                                  *data = nullptr;
+    size_t                                      size = 0;
+    std::vector<FaiRecord>                      records;
+    std::unordered_map<std::string, size_t>     byName;
+
+public:
+
+    /**
+     * @brief Maps path and loads path + ".fai".
+     * Throws std::runtime_error if either is missing, the file is compressed or the index does not fit the file.
+     */
+    explicit IndexedFasta(const std::string &path);
+
+    ~IndexedFasta();
+
+    IndexedFasta(const IndexedFasta &) = delete;
+    IndexedFasta& operator=(const IndexedFasta &) = delete;
+
+    const std::vector<FaiRecord>& getRecords() const { return records; }
+
+    /**
+     * @brief Index entry of a record. Throws std::invalid_argument for an unknown name.
+     */
+    const FaiRecord& record(const std::string &name) const;
+
+    /**
+     * @brief Bases [start, end) (0-based) of a record, as stored in the file.
+     * Throws std::invalid_argument for an unknown name or a range outside the record.
+     */
+    std::string fetch(const std::string &name, uint64_t start, uint64_t end) const;
+
+    /**
+     * @brief Bases of a samtools-style region (see parseRegion). Throws std::invalid_argument for malformed regions.
+     */
+    std::string fetch(const std::string &region) const;
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * NOTE: KERNELS -> the hot per-base loops (random word generation, base sampling, complement, GC counting, 2-bit packing,
+ * bit-plane packing for codon matching, codon translation, Shift-And motif matching, PWM window scoring)
+ * exist once per instruction set; kernels() picks the widest set the CPU supports on first use, so a single
+ * generic x86-64 binary still runs AVX2 / AVX-512 code where available.
+ *
+ * GENOMORPH_ISA=scalar|sse4.2|avx2|avx512 overrides the choice (for benchmarking); asking for a set the CPU lacks
+ * falls back to the best supported one with a warning. Non-x86 builds only have the scalar kernels.
+ */
+
+enum class Isa {
+    scalar,
+    sse42,
+    avx2,
+    avx512,
+};
+
+constexpr size_t KERNEL_RNG_LANES = 8;
+
+/**
+ * @struct SampleCutoffs
+ * @brief An 8-bit slot -> base code map expressed as compares, so the sampling kernel vectorises.
+ *
+ * base = number of j with (slot >= cutoff[j]) & active[j]; a slot equal to split[j] with straddles[j] set is
+ * SAMPLE_SPLIT instead (its base depends on more than 8 bits and is resolved by the caller).
+ */
+
+struct SampleCutoffs {
+    uint8_t cutoff[3];
+    uint8_t active[3];      /**< 0xFF, or 0 when the threshold lies above every slot */
+    uint8_t split[3];
+    uint8_t straddles[3];   /**< 0xFF when threshold j is not slot aligned */
+};
+
+constexpr uint8_t SAMPLE_SPLIT = 0xFF;
+
+constexpr size_t SHIFT_AND_LANES = 8;
+
+/**
+ * @struct ShiftAndProgram
+ * @brief Bit-parallel Shift-And automaton for up to SHIFT_AND_LANES x 64 pattern positions (see motifSearch.hpp).
+ *
+ * Each pattern owns a run of consecutive bits inside one 64-bit lane, first position lowest. Per base with code c:
+ * state = ((state << 1) | initial) & masks[c], lane by lane; a pattern ends here when its accept bit survives.
+ * Unused lanes are all zero.
+ */
+
+struct ShiftAndProgram {
+    uint64_t masks[4][SHIFT_AND_LANES];     /**< bit set where the pattern position allows base code c */
+    uint64_t initial[SHIFT_AND_LANES];      /**< first position of every pattern */
+    uint64_t accept[SHIFT_AND_LANES];       /**< last position of every pattern */
+};
+
+/**
+ * NOTE: PWM_COLUMN_STRIDE -> bytes per quantised PWM column handed to scoreWindows; entry c (0..3) is the score of base
+ * code c, the rest is padding so one column is a 16-byte shuffle table.
+ */
+constexpr size_t PWM_COLUMN_STRIDE = 16;
+
+/**
+ * @struct KernelTable
+ * @brief One implementation of every dispatched kernel. Input and output ranges never overlap; codes are 0..3.
+ */
+
+struct KernelTable {
+    Isa isa;
+
+    /**
+     * @brief Advances KERNEL_RNG_LANES xoshiro256++ lanes (state[word][lane]) `blocks` times, block b -> out[b * LANES + lane].
+     */
+    void (*xoshiroBlocks)(uint64_t (*state)[KERNEL_RNG_LANES], uint64_t *out, size_t blocks);
+
+    /**
+     * @brief out[i] = 2-bit field i of the word array (field 0 = low bits of words[0]).
+     */
+    void (*unpackCodes)(const uint64_t *words, size_t count, uint8_t *out);
+
+    /**
+     * @brief Maps each random byte (an 8-bit slot) to a base code or SAMPLE_SPLIT.
+     */
+    void (*sampleBases)(const uint8_t *random, size_t count, const SampleCutoffs &cutoffs, uint8_t *out);
+
+    void (*complementCodes)(const uint8_t *in, size_t count, uint8_t *out);
+
+    /**
+     * @brief out[i] = complement of in[count - 1 - i].
+     */
+    void (*reverseComplementCodes)(const uint8_t *in, size_t count, uint8_t *out);
+
+    size_t (*countGc)(const uint8_t *codes, size_t count);
+
+    /**
+     * @brief Packs four codes per byte, first code in the low bits; writes ceil(count / 4) bytes, missing codes are 0.
+     */
+    void (*packCodes)(const uint8_t *codes, size_t count, uint8_t *out);
+
+    /**
+     * @brief Splits codes into two bit planes, 64 bases per word: bit i % 64 of high / low word i / 64 is bit 1 / bit 0
+     * of code i. Writes ceil(count / 64) words to each plane; bits past count are 0.
+     */
+    void (*bitPlanes)(const uint8_t *codes, size_t count, uint64_t *high, uint64_t *low);
+
+    /**
+     * @brief out[i] = table[codonIndex of codes[3i .. 3i + 2]] for `codons` codons; table has 64 entries (see baseCodes.hpp).
+     */
+    void (*translateCodons)(const uint8_t *codes, size_t codons, const char *table, char *out);
+
+    /**
+     * @brief Runs the automaton over `count` codes from `state` (SHIFT_AND_LANES words, updated in place) and writes the
+     * offsets i at which any pattern ends to hits (room for count entries, count < 2^32). Returns the number of hits.
+     */
+    size_t (*shiftAnd)(const uint8_t *codes, size_t count, const ShiftAndProgram &program, uint64_t *state, uint32_t *hits);
+
+    /**
+     * @brief Scores `windows` windows of `width` bases: score(i) = sum over k of columns[k * PWM_COLUMN_STRIDE + codes[i + k]].
+     * Writes i to hits and score(i) to scores for every window with score(i) >= threshold (room for `windows` entries,
+     * windows < 2^32) and returns their number. Reads codes[0, windows + width - 1); width <= 256.
+     */
+    size_t (*scoreWindows)(const uint8_t *codes, size_t windows, const int8_t *columns, size_t width, int16_t threshold,
+                           uint32_t *hits, int16_t *scores);
+};
+
+/**
+ * @brief Kernels selected for this process (CPUID, then GENOMORPH_ISA); chosen once, thread-safe.
+ */
+const KernelTable &kernels();
+
+/**
+ * @brief Kernels for a specific instruction set, or nullptr if this build or CPU cannot run them.
+ */
+const KernelTable *kernelsFor(Isa isa);
+
+const char *isaName(Isa isa);
+
+/**
+ * NOTE: per-ISA tables, defined in kernelsX86.cpp (nullptr on other architectures); they do not check the CPU.
+ * the vector kernels hand their tails to scalarKernels().
+ */
+const KernelTable &scalarKernels();
+const KernelTable *sse42Kernels();
+const KernelTable *avx2Kernels();
+const KernelTable *avx512Kernels();
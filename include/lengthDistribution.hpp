@@ -0,0 +1,87 @@
+#pragma once
+
+#include "aliasTable.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @enum LengthModel
+ * @brief shape of a region length distribution.
+ */
+
+enum class LengthModel {
+    uniform,
+    log_normal,
+    geometric,
+    histogram
+};
+
+/**
+ * @struct HistogramBin
+ * @brief one bin of an empirical length histogram: lengths in (previous upper, upper] drawn with relative weight.
+ */
+
+struct HistogramBin {
+    size_t      upper;
+    double      weight;
+};
+
+/**
+ * @struct LengthSpec
+ * @brief declarative description of one length distribution as written in the config file.
+ *
+ * NOTE: MEAN -> arithmetic mean in bases (log_normal, geometric); SIGMA -> standard deviation of log(length) (log_normal)
+ */
+
+struct LengthSpec {
+    LengthModel                 model = LengthModel::uniform;
+    size_t                      min = 100;
+    size_t                      max = 1000;
+    double                      mean = 0.0;
+    double                      sigma = 0.0;
+    std::vector<HistogramBin>   bins;
+};
+
+/**
+ * @class LengthDistribution
+ * @brief immutable sampler for a LengthSpec, truncated to [min, max].
+ *
+ * Continuous models are tabulated once as INVERSE_CDF_SIZE + 1 quantiles; a draw is one table lookup plus a linear
+ * interpolation driven by a single 64-bit random word, so no transcendental function runs per draw.
+ * Histograms draw their bin from an AliasTable and a length uniformly inside the bin.
+ */
+
+class LengthDistribution {
+private:
+    LengthSpec              spec;
+    std::vector<double>     quantiles;
+    AliasTable              binTable;
+    std::vector<size_t>     binLower;
+
+public:
+    static constexpr size_t INVERSE_CDF_BITS = 12;
+    static constexpr size_t INVERSE_CDF_SIZE = size_t{1} << INVERSE_CDF_BITS;
+
+    LengthDistribution() = default;
+
+    /**
+     * @brief Validates the spec and precomputes its sampling tables.
+     * Throws std::invalid_argument on inconsistent parameters (min > max, non-positive mean or sigma, bad bins).
+     */
+    explicit LengthDistribution(const LengthSpec &spec);
+
+    const LengthSpec& getSpec() const { return spec; }
+
+    /**
+     * @brief Maps one uniformly random 64-bit word to a length in [min, max].
+     */
+    size_t sample(uint64_t random) const;
+};
+
+/**
+ * @brief Parses a config model name (uniform, lognormal, geometric, histogram). Throws std::invalid_argument otherwise.
+ */
+LengthModel parseLengthModel(const std::string &name);
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Parses a byte size such as 512M, 1.5G or 4096 (K/M/G/T are binary, an optional trailing B or iB is accepted).
+ * Throws std::invalid_argument for anything else or a zero size.
+ */
+uint64_t parseByteSize(const std::string &text);
+
+/**
+ * @brief Formats a byte count with a binary unit, e.g. "1.5 GiB".
+ */
+std::string formatByteSize(uint64_t bytes);
+
+/**
+ * @struct MemoryDemand
+ * @brief what a run would hold at once with its requested settings; the input of planMemory.
+ */
+
+struct MemoryDemand {
+    unsigned    threads = 1;
+    size_t      largestChromosome = 0;  /**< bases; 0 for runs that never hold a chromosome */
+    size_t      longestRegion = 0;      /**< bases; a window can never be shorter than one region */
+    size_t      outputFiles = 0;        /**< files written through OutputFile */
+    size_t      ioChunkBytes = 0;
+    size_t      ioDepth = 0;
+    size_t      pipelineChunks = 0;     /**< 0 when the FASTA is not pipelined */
+    size_t      pipelineChunkBytes = 0;
+    uint64_t    cacheBytes = 0;         /**< block cache of the procedural genome */
+};
+
+/**
+ * @struct MemoryPlan
+ * @brief settings that fit a budget; the caller applies every field.
+ */
+
+struct MemoryPlan {
+    unsigned    threads = 1;
+    size_t      ioDepth = 0;
+    size_t      pipelineChunks = 0;
+    size_t      windowBases = 0;        /**< bases generated per step; 0 -> whole chromosomes */
+    uint64_t    cacheBytes = 0;
+    uint64_t    planBytes = 0;          /**< region plans kept in memory; the rest spills to disk */
+    uint64_t    estimatedBytes = 0;     /**< everything above except planBytes */
+};
+
+constexpr uint64_t MEMORY_OVERHEAD_BYTES = 64ULL << 20;   /**< code, config, repeat library, allocator slack */
+constexpr uint64_t MEMORY_THREAD_BYTES = 2ULL << 20;      /**< resident stack and per-task scratch */
+constexpr size_t MIN_WINDOW_BASES = 1 << 20;
+
+/**
+ * @brief Bytes a run holds with the given settings, excluding region plans.
+ */
+uint64_t estimateMemory(const MemoryDemand &demand, const MemoryPlan &plan);
+
+/**
+ * NOTE: MEMORY PLANNING -> the estimate is the fixed overhead plus the buffers a run sizes itself: per-thread scratch,
+ * OutputFile chunk pools, the pipelined FASTA's chunk pool, the generated window and the block cache. Over budget,
+ * knobs shrink in order of how little they cost in throughput: pipeline chunks (to 2), io depth (to 2), cache (to an
+ * eighth of the budget), window (to the longer of MIN_WINDOW_BASES and the longest region), cache (to 0) and finally
+ * threads (to 1). What is left goes to region plans.
+ *
+ * Throws std::invalid_argument when even the smallest settings do not fit the budget.
+ */
+MemoryPlan planMemory(uint64_t budget, const MemoryDemand &demand);
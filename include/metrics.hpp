@@ -0,0 +1,262 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * NOTE: METRICS -> built-in counters and timers for the generation pipeline.
+ *
+ * Instrumentation sites use the GENOMORPH_* macros at the bottom of this file; building without
+ * -DGENOMORPH_METRICS (make METRICS=0) turns every site into a no-op while the Metrics API itself stays linkable.
+ * Sites are placed per region / per chunk / per task, never per base.
+ */
+
+/**
+ * @enum Counter
+ * @brief monotonically increasing event counts summed over all threads.
+ *
+ * NOTE: BUFFER_ALLOCATIONS -> sequence, chunk and scratch buffers sized by the engine, counted by hand at each site;
+ * other heap traffic is only seen by the allocation profile (see allocationProfile.hpp).
+ * PIPELINE_STALLS -> times a producer waited for an output chunk (see outputPipeline.hpp).
+ * CACHE_* -> lookups and evictions of the regenerated block cache (see blockCache.hpp).
+ */
+
+enum class Counter {
+    bases_generated,
+    regions_planned,
+    regions_filled,
+    buffer_allocations,
+    genes_planned,
+    motifs_planted,
+    pipeline_stalls,
+    cache_hits,
+    cache_misses,
+    cache_evictions,
+    COUNT
+};
+
+/**
+ * @enum Timer
+ * @brief pipeline stages with accumulated wall time and call count.
+ */
+
+enum class Timer {
+    region_planning,
+    base_sampling,
+    strand_complement,
+    sink_write,
+    COUNT
+};
+
+/**
+ * @struct SinkStats
+ * @brief per output sink totals, registered once per sink by name.
+ */
+
+struct SinkStats {
+    std::string             name;
+    std::atomic<uint64_t>   bytes {0};
+    std::atomic<uint64_t>   writes {0};
+    std::atomic<uint64_t>   nanoseconds {0};
+};
+
+/**
+ * @struct GaugeStats
+ * @brief last and peak value of a sampled quantity such as a queue depth.
+ */
+
+struct GaugeStats {
+    std::string             name;
+    std::atomic<uint64_t>   current {0};
+    std::atomic<uint64_t>   peak {0};
+};
+
+class Metrics {
+private:
+
+    static constexpr size_t COUNTERS = static_cast<size_t>(Counter::COUNT);
+    static constexpr size_t TIMERS = static_cast<size_t>(Timer::COUNT);
+
+    /**
+     * NOTE: ThreadShard -> per-thread slice of the counters so hot sites never share a cache line;
+     * shards are recycled when their thread exits and summed at report time.
+     */
+    struct alignas(64) ThreadShard {
+        std::array<std::atomic<uint64_t>, COUNTERS>     counters {};
+        std::array<std::atomic<uint64_t>, TIMERS>       timerNanoseconds {};
+        std::array<std::atomic<uint64_t>, TIMERS>       timerCalls {};
+    };
+
+    struct WorkerSlot {
+        std::atomic<uint64_t>   busyNanoseconds {0};
+        std::atomic<uint64_t>   idleNanoseconds {0};
+        std::atomic<uint64_t>   tasks {0};
+    };
+
+    mutable std::mutex                              registryMutex;
+    std::vector<std::unique_ptr<ThreadShard>>       shards;
+    std::vector<ThreadShard *>                      freeShards;
+    std::deque<SinkStats>                           sinks;
+    std::deque<GaugeStats>                          gauges;
+    std::deque<WorkerSlot>                          workers;
+    std::chrono::steady_clock::time_point           start = std::chrono::steady_clock::now();
+
+    Metrics() = default;
+
+    ThreadShard& shard();
+
+    friend struct ShardLease;
+
+public:
+
+    static Metrics& instance();
+
+    /**
+     * @brief True when the binary was built with GENOMORPH_METRICS (instrumentation sites active).
+     */
+    static constexpr bool enabled() {
+#ifdef GENOMORPH_METRICS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void add(Counter counter, uint64_t amount) {
+        shard().counters[static_cast<size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    void addTime(Timer timer, uint64_t nanoseconds) {
+        ThreadShard &local = shard();
+        local.timerNanoseconds[static_cast<size_t>(timer)].fetch_add(nanoseconds, std::memory_order_relaxed);
+        local.timerCalls[static_cast<size_t>(timer)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Returns the stats block for a sink, creating it on first use; the reference stays valid for the process.
+     */
+    SinkStats& sink(const std::string &name);
+
+    GaugeStats& gauge(const std::string &name);
+
+    void recordGauge(GaugeStats &gauge, uint64_t value);
+
+    /**
+     * @brief Adds busy and idle time of worker slot `worker` (index inside a parallelFor pool).
+     */
+    void addWorkerTime(size_t worker, uint64_t busyNanoseconds, uint64_t idleNanoseconds, uint64_t tasks);
+
+    /**
+     * @brief Marks the start of a run; rates are computed against this point.
+     */
+    void markStart() { start = std::chrono::steady_clock::now(); }
+
+    uint64_t total(Counter counter) const;
+
+    std::string toJson() const;
+
+    std::string toPrometheus() const;
+
+    /**
+     * @brief Renders in "json" or "prometheus". Throws std::invalid_argument for any other format.
+     */
+    std::string render(const std::string &format) const;
+};
+
+/**
+ * @class ScopedTimer
+ * @brief adds the lifetime of the object to a Timer.
+ */
+
+class ScopedTimer {
+private:
+    Timer                                       timer;
+    std::chrono::steady_clock::time_point       begin;
+
+public:
+    explicit ScopedTimer(Timer timer) : timer(timer), begin(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+        Metrics::instance().addTime(timer, static_cast<uint64_t>(elapsed.count()));
+    }
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer& operator=(const ScopedTimer &) = delete;
+};
+
+/**
+ * @class ScopedSinkWrite
+ * @brief times one sink write and credits its bytes.
+ */
+
+class ScopedSinkWrite {
+private:
+    SinkStats                                   &stats;
+    uint64_t                                    bytes;
+    std::chrono::steady_clock::time_point       begin;
+
+public:
+    ScopedSinkWrite(SinkStats &stats, uint64_t bytes) : stats(stats), bytes(bytes), begin(std::chrono::steady_clock::now()) {}
+
+    ~ScopedSinkWrite() {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+        stats.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        stats.writes.fetch_add(1, std::memory_order_relaxed);
+        stats.nanoseconds.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+        Metrics::instance().addTime(Timer::sink_write, static_cast<uint64_t>(elapsed.count()));
+    }
+
+    ScopedSinkWrite(const ScopedSinkWrite &) = delete;
+    ScopedSinkWrite& operator=(const ScopedSinkWrite &) = delete;
+};
+
+/**
+ * @class MetricsReporter
+ * @brief background thread that rewrites a metrics file every `interval` seconds and once more on stop().
+ * The file is replaced atomically (write to <path>.tmp, then rename) so scrapers never see a partial report.
+ */
+
+class MetricsReporter {
+private:
+    std::string                 path;
+    std::string                 format;
+    std::chrono::milliseconds   interval;
+    std::thread                 worker;
+    std::mutex                  mutex;
+    std::condition_variable     wake;
+    bool                        stopping = false;
+
+    void writeReport() const;
+
+public:
+    MetricsReporter(std::string path, std::string format, std::chrono::milliseconds interval);
+
+    ~MetricsReporter();
+
+    void stop();
+};
+
+#define GENOMORPH_CONCAT_INNER(a, b) a##b
+#define GENOMORPH_CONCAT(a, b) GENOMORPH_CONCAT_INNER(a, b)
+
+#ifdef GENOMORPH_METRICS
+#define GENOMORPH_COUNT(counter, amount) Metrics::instance().add(Counter::counter, (amount))
+#define GENOMORPH_TIME(timer) ScopedTimer GENOMORPH_CONCAT(genomorphTimer, __LINE__)(Timer::timer)
+#define GENOMORPH_SINK_WRITE(stats, bytes) ScopedSinkWrite GENOMORPH_CONCAT(genomorphSinkWrite, __LINE__)((stats), (bytes))
+#define GENOMORPH_GAUGE(stats, value) Metrics::instance().recordGauge((stats), (value))
+#else
+#define GENOMORPH_COUNT(counter, amount) ((void)sizeof(amount))
+#define GENOMORPH_TIME(timer) ((void)0)
+#define GENOMORPH_SINK_WRITE(stats, bytes) ((void)(stats), (void)sizeof(bytes))
+#define GENOMORPH_GAUGE(stats, value) ((void)(stats), (void)sizeof(value))
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "aliasTable.hpp"
+#include "blockRng.hpp"
+#include "config.hpp"
+#include "regionGenerator.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * @class PositionWeightMatrix
+ * @brief per-position base probabilities of a transcription factor binding motif.
+ *
+ * Every column keeps a 4-entry AliasTable, so planting a site costs one random word per base and no per-base search.
+ */
+
+class PositionWeightMatrix {
+private:
+    std::string                             name;
+    std::vector<std::array<double, 4>>      columns;    /**< base code order */
+    std::vector<AliasTable>                 columnTables;
+    std::string                             consensus;  /**< IUPAC consensus it was built from, empty otherwise */
+
+public:
+    /**
+     * @brief Builds the matrix from rows of base weights (A, C, G, T); rows need not be normalised.
+     * Throws std::invalid_argument for an empty matrix or a row without positive weight.
+     */
+    PositionWeightMatrix(std::string name, std::vector<std::array<double, 4>> columns);
+
+    /**
+     * @brief Matrix of an IUPAC consensus: each position puts CONSENSUS_MATCH of its weight on the bases its symbol
+     * allows and spreads the rest over the others (N is uniform). Throws std::invalid_argument for a non-IUPAC symbol.
+     */
+    static PositionWeightMatrix fromConsensus(std::string name, const std::string &consensus);
+
+    static constexpr double CONSENSUS_MATCH = 0.88;
+
+    const std::string& getName() const { return name; }
+
+    const std::string& getConsensus() const { return consensus; }
+
+    size_t length() const { return columns.size(); }
+
+    const std::array<double, 4>& column(size_t i) const { return columns[i]; }
+
+    /**
+     * @brief Writes one site (length() codes, motif orientation) drawn column by column.
+     */
+    void sample(BlockRng &rng, uint8_t *out) const;
+};
+
+/**
+ * @struct MotifSite
+ * @brief one planted binding site: chromosome coordinates [start, start + motif length), strand of the motif.
+ */
+
+struct MotifSite {
+    size_t          start;
+    uint16_t        motif;      /**< index into motifLibrary() */
+    StrandInfo      strand;
+};
+
+/**
+ * @brief Built-in PWM library (promoter, enhancer and silencer factors from their published consensus sequences).
+ */
+const std::vector<PositionWeightMatrix>& motifLibrary();
+
+/**
+ * @brief Library indices of the motifs planted into regulatory regions of one kind.
+ */
+const std::vector<uint16_t>& motifsFor(RegulatoryKind kind);
+
+/**
+ * @brief Picks the region's regulatory kind and plants config.regulatory.motifDensity sites per kb (Poisson count,
+ * uniform non-overlapping positions, random strand) into a regulatory region; appends them to `sites` in position order
+ * and records the range in the region's RegulatoryMetaData.
+ */
+void planMotifSites(RegionInfo &region, const GenerationConfig &config, std::mt19937_64 &rng, std::vector<MotifSite> &sites);
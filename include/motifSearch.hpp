@@ -0,0 +1,103 @@
+#pragma once
+
+#include "kernels.hpp"
+#include "regionGenerator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct MotifPattern
+ * @brief one named search pattern in IUPAC notation (A C G T, R Y S W K M, B D H V, N), at most 64 positions.
+ */
+
+struct MotifPattern {
+    std::string     name;
+    std::string     consensus;
+};
+
+constexpr uint32_t NO_REGION = UINT32_MAX;
+
+/**
+ * @struct MotifHit
+ * @brief occurrence of a pattern: plus-strand coordinates [start, start + pattern length), the strand it reads on
+ * and the RegionMap index of the region covering its first base (NO_REGION when searched without a map).
+ */
+
+struct MotifHit {
+    size_t          start;
+    uint32_t        pattern;
+    StrandInfo      strand;
+    uint32_t        region;
+};
+
+/**
+ * @brief Index of the region covering `position` in a map ordered by region_start_index; NO_REGION for an empty map.
+ */
+uint32_t regionAt(const RegionMap &regions, size_t position);
+
+/**
+ * @class MotifSearcher
+ * @brief exact / degenerate multi-pattern search over base codes, both strands in one pass.
+ *
+ * Every pattern and (unless it is its own reverse complement) its reverse complement become bit runs of a Shift-And
+ * automaton (KernelTable::shiftAnd), so IUPAC classes cost nothing extra and all patterns advance with a handful of
+ * vector ops per base; patterns beyond SHIFT_AND_LANES x 64 positions spill into further passes. The kernel only
+ * reports where something ended, the pattern is then confirmed position by position.
+ * Palindromic patterns are reported once, on the plus strand.
+ */
+
+class MotifSearcher {
+private:
+    /**
+     * NOTE: ENTRY -> one strand of one pattern inside a pass; allowed[k] is the 4-bit base mask of position k (strand order)
+     */
+    struct Entry {
+        uint32_t                pattern;
+        StrandInfo              strand;
+        std::vector<uint8_t>    allowed;
+    };
+
+    struct Pass {
+        ShiftAndProgram         program {};
+        std::vector<Entry>      entries;
+    };
+
+    std::vector<MotifPattern>   patterns;
+    std::vector<bool>           palindromes;
+    std::vector<Pass>           passes;
+    size_t                      longestPattern = 0;
+
+public:
+
+    /**
+     * @brief Bases scanned per task; neighbouring tasks re-read longest() - 1 bases so hits across the cut are found once.
+     */
+    static constexpr size_t CHUNK_BASES = 1 << 20;
+
+    /**
+     * @brief Compiles the patterns. Throws std::invalid_argument for an empty list, an empty or over-long pattern
+     * or a non-IUPAC symbol.
+     */
+    explicit MotifSearcher(std::vector<MotifPattern> patterns);
+
+    size_t size() const { return patterns.size(); }
+
+    const MotifPattern& pattern(size_t i) const { return patterns[i]; }
+
+    size_t longest() const { return longestPattern; }
+
+    /**
+     * @brief Whether pattern i equals its reverse complement (its hits are all reported on the plus strand).
+     */
+    bool palindromic(size_t i) const { return palindromes[i]; }
+
+    /**
+     * @brief Every hit of every pattern in codes[0, length), sorted by (start, pattern, strand).
+     * @param regions Map covering the sequence, used to fill MotifHit::region.
+     * @param threads Worker threads over CHUNK_BASES chunks; the result does not depend on it.
+     */
+    std::vector<MotifHit> search(const uint8_t *codes, size_t length, const RegionMap &regions, unsigned threads = 1) const;
+};
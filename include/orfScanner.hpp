@@ -0,0 +1,54 @@
+#pragma once
+
+#include "regionGenerator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * @struct OpenReadingFrame
+ * @brief ATG ... stop span in plus-strand coordinates: [start, end), end includes the stop codon on either strand.
+ */
+
+struct OpenReadingFrame {
+    size_t      start;
+    size_t      end;
+    StrandInfo  strand;
+
+    size_t codons() const { return (end - start) / 3; }
+};
+
+/**
+ * @struct OrfReport
+ * @brief ORFs found in one sequence, checked against the coding regions planned for it.
+ */
+
+struct OrfReport {
+    size_t                  scannedBases = 0;
+    size_t                  plannedCoding = 0;      /**< coding regions with room for a start and a stop codon */
+    size_t                  intactCoding = 0;       /**< ... whose planned ATG ... stop is an ORF on the planned strand and frame */
+    size_t                  longOrfs = 0;           /**< ORFs of at least minCodons codons */
+    size_t                  spuriousLongOrfs = 0;   /**< long ORFs that do not end at a planned coding stop */
+    std::vector<size_t>     brokenRegions;          /**< RegionMap indices of planned coding regions that are not intact */
+};
+
+/**
+ * @brief The ORF GenomeGenerator writes for a coding region: |reading_frame| - 1 bases of phase on the sense strand,
+ * then as many whole codons as fit. nullopt for non-coding regions, regions too short for start + stop and spliced genes
+ * (RegionInfo::gene), whose ORF only exists once the introns are removed.
+ */
+std::optional<OpenReadingFrame> plannedOpenReadingFrame(const RegionInfo &region);
+
+/**
+ * @brief Six-frame ORF scan of one sequence (both strands in parallel), compared against its planned regions.
+ *
+ * An ORF runs from the first ATG after an in-frame stop (or the sequence start) to the next in-frame stop, so a
+ * planned region is intact when some ORF on its strand ends at its stop codon and starts at or before its ATG.
+ * Codons are matched 64 positions at a time on bit planes (see KernelTable::bitPlanes), all three frames at once.
+ *
+ * @param longOrfs If non-null, receives every ORF of at least minCodons codons (plus strand first, each by end position).
+ */
+OrfReport scanOpenReadingFrames(const uint8_t *codes, size_t length, const RegionMap &regions, size_t minCodons,
+                                unsigned threads = 2, std::vector<OpenReadingFrame> *longOrfs = nullptr);
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @enum IoBackend
+ * @brief how output files reach the disk.
+ *
+ * NOTE: uring -> writes queued on a per-file io_uring (Linux 5.1+), threads -> pwrite on a shared worker pool,
+ * sync -> buffered std::ofstream writes on the calling thread; automatic picks uring when the kernel allows it, else threads.
+ */
+
+enum class IoBackend {automatic, uring, threads, sync};
+
+/**
+ * @struct IoOptions
+ * @brief write-behind settings shared by every output file of a run (--io, --direct).
+ */
+
+struct IoOptions {
+    IoBackend   backend = IoBackend::automatic;
+
+    /**
+     * NOTE: DIRECT -> open with O_DIRECT, bypassing the page cache; chunks are 4 KiB aligned and the padded tail is
+     * truncated away. Ignored by the sync backend, for appends at unaligned offsets and where the filesystem refuses it.
+     */
+    bool        direct = false;
+
+    size_t      chunkBytes = 1 << 20;   /**< bytes per write, rounded up to 4 KiB */
+    size_t      depth = 4;              /**< chunk buffers per file = writes in flight per file, minus the one being filled */
+
+    /**
+     * NOTE: BGZF -> compress through a BgzfOutputFile (bgzf.hpp) on compressionThreads workers (0 -> all cores) and
+     * write <path>.gzi next to the file
+     */
+    bool        bgzf = false;
+    int         compressionLevel = 6;
+    unsigned    compressionThreads = 0;
+};
+
+/**
+ * @class OutputFile
+ * @brief append-only output stream; the async backends copy into pooled, aligned chunk buffers and write full chunks
+ * in the background at their file offsets, so the caller only waits when every buffer of the file is still in flight.
+ *
+ * Not thread-safe: one thread writes a file (the I/O itself runs elsewhere). Errors surface as std::runtime_error
+ * from the next write, flush or close.
+ */
+
+class OutputFile {
+public:
+    virtual ~OutputFile() = default;
+
+    virtual void write(const char *data, size_t size) = 0;
+
+    void write(const std::string &block) { write(block.data(), block.size()); }
+
+    /**
+     * @brief Returns once everything written so far has reached the OS (used before checkpoints).
+     */
+    virtual void flush() = 0;
+
+    /**
+     * @brief Flushes and closes the file; later calls do nothing.
+     */
+    virtual void close() = 0;
+
+    virtual IoBackend backend() const = 0;
+};
+
+/**
+ * @brief Opens path for writing ("-" = stdout, always sync, no .gzi); truncates it unless `append` is set.
+ * Throws std::runtime_error if the file cannot be opened, std::invalid_argument for appending to BGZF output.
+ */
+std::unique_ptr<OutputFile> openOutputFile(const std::string &path, const IoOptions &options = {}, bool append = false);
+
+/**
+ * @brief Backend openOutputFile uses for `requested`: automatic becomes uring or threads, uring falls back to threads
+ * with a warning when io_uring is unavailable (old kernel, seccomp). The probe runs once.
+ */
+IoBackend resolveIoBackend(IoBackend requested);
+
+/**
+ * @brief Parses an --io value (auto, uring, threads, sync). Throws std::invalid_argument for anything else.
+ */
+IoBackend parseIoBackend(const std::string &name);
+
+const char *ioBackendName(IoBackend backend);
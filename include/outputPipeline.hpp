@@ -0,0 +1,134 @@
+#pragma once
+
+#include "boundedQueue.hpp"
+#include "metrics.hpp"
+#include "outputSinks.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @struct OutputChunk
+ * @brief pooled unit of output travelling from producers to an OrderedWriter; `bytes` keeps its capacity between uses.
+ */
+
+struct OutputChunk {
+    uint64_t        sequence = 0;   /**< position in the output order, set by acquire() */
+    uint32_t        tag = 0;        /**< meaning of the payload, defined by the consumer */
+    uint64_t        value = 0;
+    std::string     bytes;
+};
+
+/**
+ * @class OrderedWriter
+ * @brief hands pooled chunks from any number of producer threads to one writer thread that consumes them in sequence order.
+ *
+ * Producers acquire(sequence) a chunk, fill it and submit() it in any order; the writer thread parks early chunks in a
+ * reorder window and consumes them strictly by sequence, then recycles the chunk. Free chunks and submitted chunks
+ * travel through lock-free rings (BoundedQueue), waiting is done on atomics (futex wait / notify), never on a mutex.
+ *
+ * NOTE: BACKPRESSURE -> only sequences inside [next, next + chunks) are admitted, so at most `chunks` buffers exist and the
+ * sequence the writer waits for always finds a free one; every sequence in [0, N) must be acquired exactly once.
+ */
+
+class OrderedWriter {
+private:
+    std::vector<std::unique_ptr<OutputChunk>>   storage;
+    BoundedQueue<OutputChunk *>                 freeChunks;
+    BoundedQueue<OutputChunk *>                 submitted;
+    std::vector<OutputChunk *>                  reorder;        /**< writer thread only, slot = sequence % chunks */
+    std::function<void(OutputChunk &)>          consume;
+    GaugeStats                                  &inFlight;
+
+    std::atomic<uint64_t>                       nextSequence {0};   /**< first sequence not yet consumed */
+    std::atomic<uint32_t>                       released {0};       /**< bumped whenever a chunk returns to the pool */
+    std::atomic<uint32_t>                       arrivals {0};       /**< bumped on every submit and on close */
+    std::atomic<bool>                           closing {false};
+    std::atomic<bool>                           failed {false};
+    std::exception_ptr                          failure;
+    std::thread                                 writer;
+
+    void run();
+
+public:
+
+    /**
+     * @brief Starts the writer thread.
+     * @param chunks Pool size (and reorder window); more chunks let producers run further ahead of the writer.
+     * @param name Prefix of the gauge reporting how many chunks wait in the reorder window for a predecessor.
+     * @param consume Called on the writer thread for every chunk, in sequence order.
+     * Throws std::invalid_argument for an empty pool.
+     */
+    OrderedWriter(size_t chunks, const std::string &name, std::function<void(OutputChunk &)> consume);
+
+    ~OrderedWriter();
+
+    OrderedWriter(const OrderedWriter &) = delete;
+    OrderedWriter& operator=(const OrderedWriter &) = delete;
+
+    /**
+     * @brief Returns an empty chunk for `sequence`, waiting while the sequence is outside the window or the pool is empty.
+     * Throws std::runtime_error once the consumer has failed.
+     */
+    OutputChunk *acquire(uint64_t sequence);
+
+    void submit(OutputChunk *chunk);
+
+    /**
+     * @brief Marks the output as failed (the first error wins) and wakes every waiting producer, whose acquire then throws.
+     * A producer that cannot deliver its sequence must call this, or producers of later sequences wait forever.
+     */
+    void abort(std::exception_ptr error);
+
+    /**
+     * @brief Waits until every sequence below `sequence` has been consumed. Throws std::runtime_error once the consumer has failed.
+     */
+    void waitConsumed(uint64_t sequence);
+
+    /**
+     * @brief Stops the writer once everything submitted is consumed and rethrows a consumer exception.
+     * Throws std::runtime_error when submitted chunks are still waiting for a missing sequence.
+     */
+    void finish();
+};
+
+/**
+ * NOTE: PipelinedSequenceSink -> SequenceSink decorator moving formatting and writing of the wrapped sink onto an
+ * OrderedWriter thread: writeBases copies the codes into pooled chunks and returns, so generation of the next
+ * chromosome overlaps with output of the previous one; flush() and finish() wait for the writer.
+ */
+
+class PipelinedSequenceSink : public SequenceSink {
+private:
+    std::unique_ptr<SequenceSink>   inner;
+    OrderedWriter                   writer;
+    uint64_t                        nextSequence = 0;
+
+    void post(uint32_t tag, uint64_t value, const void *data, size_t size);
+
+public:
+
+    /**
+     * @brief Bases per chunk and pool size: up to CHUNK_BASES x CHUNKS bytes are buffered ahead of the writer.
+     */
+    static constexpr size_t CHUNK_BASES = 1 << 22;
+    static constexpr size_t CHUNKS = 16;
+
+    /**
+     * @param chunks Pool size (at least 2); fewer chunks trade overlap for memory under --max-memory.
+     */
+    explicit PipelinedSequenceSink(std::unique_ptr<SequenceSink> inner, size_t chunks = CHUNKS);
+
+    void beginGenome(const std::vector<ChromosomeSpec> &records) override;
+    void beginSequence(const std::string &name, size_t length) override;
+    void writeBases(const uint8_t *codes, size_t count) override;
+    void endSequence() override;
+    void flush() override;
+    void finish() override;
+};
@@ -0,0 +1,236 @@
+#pragma once
+
+#include "config.hpp"
+#include "genome.hpp"
+#include "indexedFasta.hpp"
+#include "metrics.hpp"
+#include "outputFile.hpp"
+#include "regionGenerator.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @class SequenceSink
+ * @brief streaming destination for generated sequences.
+ *
+ * Call order: beginGenome once, then per chromosome beginSequence -> writeBases* -> endSequence, then finish.
+ * Bases are passed as base codes (baseCodes.hpp, one per byte) in chunks of any size.
+ */
+
+class SequenceSink {
+public:
+    virtual ~SequenceSink() = default;
+
+    /**
+     * @brief Announces every record up front; formats with a leading index (2bit, packed) lay it out here.
+     */
+    virtual void beginGenome(const std::vector<ChromosomeSpec> &records) { (void)records; }
+
+    virtual void beginSequence(const std::string &name, size_t length) = 0;
+
+    virtual void writeBases(const uint8_t *codes, size_t count) = 0;
+
+    virtual void endSequence() = 0;
+
+    /**
+     * @brief Pushes everything written so far to the OS (used before checkpoints).
+     */
+    virtual void flush() {}
+
+    virtual void finish() {}
+};
+
+/**
+ * @class AnnotationSink
+ * @brief streaming destination for the planned layout (regions, genes, binding sites) of each chromosome; the sequence is not read.
+ */
+
+class AnnotationSink {
+public:
+    virtual ~AnnotationSink() = default;
+
+    virtual void beginGenome(const std::vector<ChromosomeSpec> &records) { (void)records; }
+
+    virtual void writeRegions(const Chromosome &chromosome) = 0;
+
+    virtual void finish() {}
+};
+
+/**
+ * NOTE: FastaSink -> plain FASTA, fixed line width ("-" writes to stdout).
+ * a file output also gets <path>.fai (samtools faidx layout, uncompressed offsets), built while writing since every
+ * offset follows from the header and line width.
+ */
+
+class FastaSink : public SequenceSink {
+private:
+    std::unique_ptr<OutputFile> file;
+    SinkStats      &stats;
+    size_t          lineWidth;
+    size_t          column = 0;
+    std::string     buffer;
+
+    std::string     indexPath;          /**< "" for stdout */
+    std::string     index;              /**< .fai lines of the finished records */
+    FaiRecord       record;             /**< record being written, name empty between records */
+    uint64_t        written = 0;        /**< bytes handed to file */
+
+    void writeBuffer();
+
+    FastaSink(const std::string &path, size_t lineWidth, const IoOptions &io, bool append);
+
+public:
+    FastaSink(const std::string &path, size_t lineWidth, const IoOptions &io = {});
+
+    /**
+     * @brief Continues a single-record FASTA cut short by an interrupted run: truncates `path` right after
+     * `basesWritten` bases of record `name` and returns a sink positioned to append the rest of that record.
+     * Throws std::runtime_error if the file is shorter than that or does not start with record `name` in lines of
+     * `lineWidth` bases.
+     */
+    static std::unique_ptr<FastaSink> resume(const std::string &path, size_t lineWidth, const std::string &name, size_t basesWritten,
+                                             const IoOptions &io = {});
+
+    void beginSequence(const std::string &name, size_t length) override;
+    void writeBases(const uint8_t *codes, size_t count) override;
+    void endSequence() override;
+    void flush() override;
+    void finish() override;
+};
+
+/**
+ * NOTE: TwoBitSink -> UCSC .2bit (version 0, 32-bit offsets, no N or mask blocks).
+ * record offsets are computed from the announced lengths, so records stream straight to disk.
+ */
+
+class TwoBitSink : public SequenceSink {
+private:
+    std::unique_ptr<OutputFile> file;
+    SinkStats      &stats;
+    uint8_t         pending = 0;
+    size_t          pendingCount = 0;
+    std::string     buffer;
+
+    void flushPacked(bool force);
+
+public:
+    explicit TwoBitSink(const std::string &path, const IoOptions &io = {});
+
+    void beginGenome(const std::vector<ChromosomeSpec> &records) override;
+    void beginSequence(const std::string &name, size_t length) override;
+    void writeBases(const uint8_t *codes, size_t count) override;
+    void endSequence() override;
+    void finish() override;
+};
+
+/**
+ * NOTE: PackedSink -> genomorph's raw packed format, 2 bits per base with A=0 C=1 G=2 T=3, first base in the low bits.
+ *
+ *     "GMPK" | uint32 version | uint32 record count
+ *     per record: uint32 name length | name | uint64 base count | ceil(count / 4) packed bytes
+ *
+ * all integers little-endian.
+ */
+
+class PackedSink : public SequenceSink {
+private:
+    std::unique_ptr<OutputFile> file;
+    SinkStats      &stats;
+    uint8_t         pending = 0;
+    size_t          pendingCount = 0;
+    std::string     buffer;
+
+    void flushPacked(bool force);
+
+public:
+    explicit PackedSink(const std::string &path, const IoOptions &io = {});
+
+    void beginGenome(const std::vector<ChromosomeSpec> &records) override;
+    void beginSequence(const std::string &name, size_t length) override;
+    void writeBases(const uint8_t *codes, size_t count) override;
+    void endSequence() override;
+    void finish() override;
+};
+
+/**
+ * NOTE: Gff3Sink -> one GFF3 feature line per planned region (1-based, inclusive coordinates); a spliced coding region
+ * is written as its gene -> mRNA -> exon / CDS / UTR / intron hierarchy instead, linked by ID / Parent.
+ * regulatory regions with a kind are typed promoter / enhancer / silencer and followed by their TF_binding_site lines.
+ */
+
+class Gff3Sink : public AnnotationSink {
+private:
+    std::unique_ptr<OutputFile> file;
+    SinkStats      &stats;
+    size_t          nextId = 0;
+
+public:
+    explicit Gff3Sink(const std::string &path, const IoOptions &io = {});
+
+    void beginGenome(const std::vector<ChromosomeSpec> &records) override;
+    void writeRegions(const Chromosome &chromosome) override;
+    void finish() override;
+};
+
+/**
+ * NOTE: AccessibilityBedGraphSink -> chromatin accessibility track (bedGraph, 0-based half-open): the accessibility of
+ * every regulatory region, run-length encoded: adjacent intervals with the same printed value become one line and
+ * inaccessible (0) stretches are left out, so the track has at most one line per regulatory region.
+ */
+
+class AccessibilityBedGraphSink : public AnnotationSink {
+private:
+    std::unique_ptr<OutputFile> file;
+    SinkStats      &stats;
+
+public:
+    explicit AccessibilityBedGraphSink(const std::string &path, const IoOptions &io = {});
+
+    void beginGenome(const std::vector<ChromosomeSpec> &records) override;
+    void writeRegions(const Chromosome &chromosome) override;
+    void finish() override;
+};
+
+/**
+ * NOTE: ProteinFastaSink -> proteome FASTA (.faa), one record per planned coding region long enough for an ORF
+ * (spliced genes are translated from their joined CDS pieces).
+ * records are named region<N> like the GFF3 feature of the same region (N counts every region, coding or not),
+ * so a protein can be joined back to its annotation and DNA.
+ */
+
+class ProteinFastaSink {
+private:
+    std::unique_ptr<OutputFile> file;
+    SinkStats      &stats;
+    size_t          lineWidth;
+    size_t          nextId = 0;
+
+public:
+    ProteinFastaSink(const std::string &path, size_t lineWidth, const IoOptions &io = {});
+
+    /**
+     * @brief Translates the planned ORF of every coding region covered by chromosome.sequence: the whole chromosome or
+     * one window of whole regions (see Genome::generate); its region column names the regions.
+     */
+    void writeProteins(const Chromosome &chromosome);
+    void finish();
+};
+
+/**
+ * @brief GFF3 feature type of an unspliced region (promoter / enhancer / silencer for regulatory regions with a kind).
+ */
+const char* annotationTypeName(const RegionInfo &region);
+
+/**
+ * @brief Creates the sequence sink for a --format value (fasta, 2bit, packed).
+ * Throws std::invalid_argument for an unknown format.
+ */
+std::unique_ptr<SequenceSink> makeSequenceSink(const std::string &format, const std::string &path, size_t lineWidth,
+                                               const IoOptions &io = {});
+
+/**
+ * @brief File extension used for a --format value, including the dot.
+ */
+std::string sequenceExtension(const std::string &format);
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "allocationProfile.hpp"
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Runs task(i) for every i in [0, count) on up to `threads` worker threads.
+ *
+ * Work is handed out through a shared atomic counter so long and short tasks balance themselves.
+ * The first exception thrown by any task is rethrown on the calling thread once all workers stop.
+ * With metrics enabled, each worker slot reports its busy time and the idle time it spent waiting for the pool to drain.
+ * With the allocation profile compiled in, workers charge their allocations to the caller's AllocationStage.
+ */
+template <typename Task>
+void parallelFor(size_t count, unsigned threads, Task &&task) {
+
+    size_t workers = std::min<size_t>(std::max(threads, 1u), std::max<size_t>(count, 1));
+
+#ifdef GENOMORPH_METRICS
+    using Clock = std::chrono::steady_clock;
+    auto poolStart = Clock::now();
+    std::vector<uint64_t> busy(workers, 0);
+    std::vector<uint64_t> tasksRun(workers, 0);
+#endif
+
+    std::atomic<size_t>     next{0};
+    std::exception_ptr      failure;
+    std::mutex              failureMutex;
+
+#ifdef GENOMORPH_ALLOC_PROFILE
+    AllocationStage stage = AllocationProfile::stage();
+#endif
+
+    auto worker = [&](size_t slot) {
+        (void)slot;
+#ifdef GENOMORPH_ALLOC_PROFILE
+        AllocationScope scope(stage);
+#endif
+        for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+#ifdef GENOMORPH_METRICS
+            auto taskStart = Clock::now();
+#endif
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(failureMutex);
+                if (!failure) failure = std::current_exception();
+                next.store(count);
+            }
+#ifdef GENOMORPH_METRICS
+            busy[slot] += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - taskStart).count());
+            ++tasksRun[slot];
+#endif
+        }
+    };
+
+    if (workers <= 1) {
+        worker(0);
+    } else {
+        std::vector<std::thread> pool;
+        pool.reserve(workers - 1);
+        for (size_t t = 1; t < workers; ++t) pool.emplace_back(worker, t);
+        worker(0);
+        for (auto &thread : pool) thread.join();
+    }
+
+#ifdef GENOMORPH_METRICS
+    uint64_t wall = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - poolStart).count());
+    for (size_t slot = 0; slot < workers; ++slot) {
+        Metrics::instance().addWorkerTime(slot, busy[slot], wall > busy[slot] ? wall - busy[slot] : 0, tasksRun[slot]);
+    }
+#endif
+
+    if (failure) std::rethrow_exception(failure);
+}
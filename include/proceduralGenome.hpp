@@ -0,0 +1,99 @@
+#pragma once
+
+#include "blockCache.hpp"
+#include "config.hpp"
+#include "genome.hpp"
+#include "indexedFasta.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class ProceduralGenome
+ * @brief a genome that is planned but never stored: fetch() regenerates exactly the requested window from the seed.
+ *
+ * Planning (regions, genes, motif sites, repeat library) is cheap and kept in memory. Every region is filled from its own
+ * seed and starts from a fixed Markov context (see Genome::fillRegion), so a window only needs the regions overlapping
+ * it; the bases are identical to what `genomorph generate` writes for the same seed and config.
+ *
+ * Regenerated bases are kept 2-bit packed in a sharded BlockCache of BLOCK_SIZE-base blocks. A fetch takes what is
+ * cached, regenerates each run of missing blocks in one pass (regions of the run in parallel) and copies out; no cache
+ * lock is held while generating, so readers hitting the same hotspots pay the regeneration once.
+ */
+
+class ProceduralGenome {
+public:
+
+    /**
+     * @brief Bases per cache block.
+     */
+    static constexpr size_t BLOCK_SIZE = 1 << 16;
+
+    /**
+     * @brief Default cache cap in packed bytes (4 bases per byte, so 1 Gbp).
+     */
+    static constexpr size_t DEFAULT_CACHE_BYTES = 256ULL << 20;
+
+private:
+    Genome                                      genome;
+    std::unordered_map<std::string, size_t>     byName;
+    unsigned                                    threads;
+    mutable BlockCache                          cache;
+
+    /**
+     * @brief Fills bases [from, to) of chromosome c into out by filling every region overlapping the span.
+     */
+    void generateSpan(size_t c, size_t from, size_t to, uint8_t *out) const;
+
+public:
+
+    /**
+     * @brief Plans the genome; no base is generated until the first fetch.
+     * @param threads Worker threads for planning and for regenerating long windows (0 -> hardware concurrency).
+     * @param cacheBytes Upper bound for cached packed bases (4 per byte); 0 disables the cache.
+     * Throws std::invalid_argument like Genome's constructor.
+     */
+    ProceduralGenome(std::vector<ChromosomeSpec> specs, uint64_t seed, std::shared_ptr<const GenerationConfig> config = nullptr,
+                     unsigned threads = 0, size_t cacheBytes = DEFAULT_CACHE_BYTES);
+
+    ProceduralGenome(const ProceduralGenome &) = delete;
+    ProceduralGenome& operator=(const ProceduralGenome &) = delete;
+
+    /**
+     * @brief Planned chromosomes; their `sequence` stays empty.
+     */
+    const std::vector<Chromosome>& getChromosomes() const { return genome.getChromosomes(); }
+
+    /**
+     * @brief Index of a chromosome by name. Throws std::invalid_argument for an unknown name.
+     */
+    size_t chromosomeIndex(const std::string &name) const;
+
+    /**
+     * @brief Writes base codes [start, end) (0-based) of chromosome c to out. Safe to call from several threads.
+     * Throws std::invalid_argument for a range outside the chromosome.
+     */
+    void fetchCodes(size_t c, size_t start, size_t end, uint8_t *out) const;
+
+    /**
+     * @brief Bases [start, end) (0-based) of a chromosome as A/C/G/T.
+     * Throws std::invalid_argument for an unknown name or a range outside the chromosome.
+     */
+    std::string fetch(const std::string &name, size_t start, size_t end) const;
+
+    /**
+     * @brief Resolves a samtools-style region against the chromosomes (see parseRegion).
+     */
+    FastaRegion resolve(const std::string &region) const;
+
+    /**
+     * @brief Bases of a samtools-style region.
+     */
+    std::string fetch(const std::string &region) const;
+
+    BlockCache::Stats cacheStats() const { return cache.stats(); }
+};
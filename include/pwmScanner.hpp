@@ -0,0 +1,91 @@
+#pragma once
+
+#include "motifLibrary.hpp"
+#include "regionGenerator.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct PwmHit
+ * @brief window scoring at or above its motif's threshold: plus-strand coordinates [start, start + motif length),
+ * strand the motif reads on, log-odds score in bits and the RegionMap index of the region covering its first base.
+ */
+
+struct PwmHit {
+    size_t          start;
+    uint32_t        motif;
+    StrandInfo      strand;
+    double          score;
+    uint32_t        region;
+};
+
+/**
+ * @class PwmScanner
+ * @brief log-odds scan of every window on both strands for a set of position weight matrices.
+ *
+ * Column scores log2(p / 0.25) against a uniform background are quantised to SCORE_SCALE steps per bit and stored as
+ * 16-byte tables indexed by the 2-bit base code, so KernelTable::scoreWindows sums 16 - 64 windows per instruction.
+ * The minus strand is scored on the plus strand with the reverse-complemented matrix; self-complementary matrices are
+ * scored once and reported on the plus strand.
+ */
+
+class PwmScanner {
+private:
+    struct Strand {
+        uint32_t                motif;
+        StrandInfo              strand;
+        std::vector<int8_t>     columns;    /**< width x PWM_COLUMN_STRIDE */
+        int16_t                 threshold;
+    };
+
+    std::vector<std::string>    names;
+    std::vector<size_t>         widths;
+    std::vector<double>         maxScores;
+    std::vector<double>         thresholds;
+    std::vector<bool>           palindromes;
+    std::vector<Strand>         strands;
+
+public:
+
+    /**
+     * @brief Quantisation of column scores: 1 bit = SCORE_SCALE units (int8 per column, int16 per window).
+     */
+    static constexpr double SCORE_SCALE = 8.0;
+
+    /**
+     * @brief Windows scored per task; a task reads width - 1 bases past its last window.
+     */
+    static constexpr size_t CHUNK_BASES = 1 << 20;
+
+    static constexpr size_t MAX_WIDTH = 64;
+
+    /**
+     * @brief Quantises the matrices; a motif's threshold is min + minScoreFraction * (max - min) of its quantised score range.
+     * Throws std::invalid_argument for an empty list, a matrix wider than MAX_WIDTH or a fraction outside [0, 1].
+     */
+    PwmScanner(const std::vector<PositionWeightMatrix> &motifs, double minScoreFraction);
+
+    size_t size() const { return names.size(); }
+
+    const std::string& name(size_t motif) const { return names[motif]; }
+
+    size_t width(size_t motif) const { return widths[motif]; }
+
+    double maxScore(size_t motif) const { return maxScores[motif]; }
+
+    double threshold(size_t motif) const { return thresholds[motif]; }
+
+    /**
+     * @brief Whether the quantised matrix equals its reverse complement (hits are then all reported on the plus strand).
+     */
+    bool palindromic(size_t motif) const { return palindromes[motif]; }
+
+    /**
+     * @brief Every window of codes[0, length) scoring at least its motif's threshold, sorted by (start, motif, strand).
+     * @param threads Worker threads over CHUNK_BASES chunks; the result does not depend on it.
+     */
+    std::vector<PwmHit> scan(const uint8_t *codes, size_t length, const RegionMap &regions, unsigned threads = 1) const;
+};
@@ -1,10 +1,13 @@
 #pragma once
 
+#include "config.hpp"
+
 #include <string>
 #include <random>
 #include <array>
 #include <optional>
 #include <vector>
+#include <cstdint>
 
 /**
  * @struct CodingMetaData
@@ -20,6 +23,15 @@ struct CodingMetaData {
     int8_t reading_frame;
 };
 
+/**
+ * @enum RegulatoryKind
+ * @brief role of a regulatory region; unspecified unless motif planting is enabled ([regulatory] in the config).
+ */
+
+enum class RegulatoryKind : uint8_t {unspecified, promoter, enhancer, silencer};
+
+constexpr size_t REGULATORY_KIND_COUNT = 4;
+
 /**
  * @struct RegulatoryMetaData
  * @brief the struct refers to non-coding information embedded within genome that dictates [when, where and how much] a gene is "expressed". 
@@ -30,11 +42,22 @@ struct RegulatoryMetaData {
      * NOTE: ACCESSIBILITY -> between 0.0 - 1.0
      */
     double accessibility;
+
+    RegulatoryKind  kind = RegulatoryKind::unspecified;
+
+    /**
+     * NOTE: SITES -> planted binding sites are motifSites[firstSite, firstSite + siteCount) of the chromosome (see motifLibrary.hpp)
+     */
+    uint32_t        firstSite = 0;
+    uint32_t        siteCount = 0;
 };
 
 /**
  * @enum FeatureType
  * @brief enum FeatureType consists of integral constants to determine feature type of nucleotide bases.
+ *
+ * NOTE: telomere / centromere are structural elements placed by the chromosome planner (see genome.hpp),
+ * createRegion never emits them.
  */
 
 enum class FeatureType {
@@ -42,7 +65,9 @@ enum class FeatureType {
     coding,
     non_coding,
     regulatory,
-    repeat
+    repeat,
+    telomere,
+    centromere
 };
 
 /**
@@ -84,8 +109,20 @@ struct RegionInfo {
     BaseRegionInfo                                  base;
     std::optional<CodingMetaData>                   coding;
     std::optional<RegulatoryMetaData>               regulatory_meta_data;
+
+    /**
+     * NOTE: GENE -> index of the gene feature of a spliced coding region in its chromosome's GeneModel (see geneModel.hpp);
+     * unset for unspliced coding regions, which are a single ORF
+     */
+    std::optional<uint32_t>                         gene;
 };
 
+/**
+ * NOTE: RegionMap -> contiguous, non-overlapping regions ordered by region_start_index covering one sequence
+ */
+
+using RegionMap = std::vector<RegionInfo>;
+
 class RegionGenerator {
 private:
 
@@ -93,7 +130,14 @@ private:
      * @brief Random number generator seeded with system clock.
      * Used for stochastic decisions in region generation.
     */
-    std::mt19937 rng;
+    std::mt19937_64 rng;
+
+    const GenerationConfig *config; /**< Composition, length and GC tables; shared, never owned. */
+
+    /**
+     * NOTE: MARKOV CONTEXT -> type index of the last region created, REGION_TYPE_COUNT before the first one
+     */
+    size_t previousType = REGION_TYPE_COUNT;
 public:
 
     /**
@@ -102,15 +146,47 @@ public:
     */
     RegionGenerator();
 
+    /**
+     * @brief Constructs a RegionGenerator with a fixed seed so region layouts are reproducible.
+     * @param seed Seed for the internal RNG.
+     * @param config Region tables; must outlive the generator.
+    */
+    explicit RegionGenerator(uint64_t seed, const GenerationConfig &config = GenerationConfig::defaults());
+
     /**
      * @brief Creates a new genomic region based on the current genome length and total genome length.
      * @param currentGenomeLength The length of the genome generated so far.
      * @param genomeLength The total desired length of the genome.
      * @return A RegionInfo struct representing the newly created region.
-     * Throws std::invalid_argument if genomeLength is less than 100.
+     * The type follows the config's Markov chain from the previously created region (composition for the first one)
+     * and the length is drawn from that type's LengthDistribution, clipped to the remaining space.
+     * Throws std::invalid_argument if genomeLength is less than 100 or currentGenomeLength is not below genomeLength.
     */
     RegionInfo createRegion(size_t currentGenomeLength, size_t genomeLength);
 
+    /**
+     * @brief Tiles [startIndex, endIndex) with consecutive regions from createRegion.
+     * @param startIndex First position covered by the map.
+     * @param endIndex One past the last position covered by the map.
+     * @return RegionMap ordered by region_start_index.
+    */
+    RegionMap planRegions(size_t startIndex, size_t endIndex);
+
+    /**
+     * @brief Restarts the RNG stream; together with setMarkovContext this makes any single createRegion call replayable.
+     */
+    void reseed(uint64_t seed) { rng.seed(seed); }
+
+    /**
+     * @brief Type index of the last created region (REGION_TYPE_COUNT before the first one).
+     */
+    size_t getMarkovContext() const { return previousType; }
+
+    /**
+     * @brief Restores the Markov context, e.g. from a checkpoint. Throws std::invalid_argument for an index above REGION_TYPE_COUNT.
+     */
+    void setMarkovContext(size_t type);
+
     /**
      * @brief Provides base probabilities based on the region type.
      * @param region The RegionState providing context for base probability determination.
@@ -120,4 +196,4 @@ public:
      * The returned probabilities can be used in base generation to ensure the sequence adheres to the region's properties.
      */
     std::array<double, 4> regionBasedBaseProbabilities(const RegionInfo &region);
-};
\ No newline at end of file
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "baseCodes.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+/**
+ * @struct RepeatFamily
+ * @brief a family of interspersed repeats: one consensus sequence (base codes) plus the divergence of its genomic copies.
+ *
+ * NOTE: DIVERGENCE -> per-base substitution probability of an inserted copy relative to the consensus (0.0 - 1.0)
+ */
+
+struct RepeatFamily {
+    std::string             name;
+    std::vector<uint8_t>    consensus;
+    double                  divergence;
+};
+
+using RepeatLibrary = std::vector<RepeatFamily>;
+
+/**
+ * NOTE: RepeatGenerator -> builds repeats by copying rather than sampling.
+ * interspersed copies are memcpy'd from a family consensus and then mutated at geometrically skipped positions,
+ * tandem repeats are laid down by periodic (doubling) copy of a short unit. cost is O(length / 16 + mutations)
+ * instead of one RNG draw per base.
+ */
+
+class RepeatGenerator {
+private:
+    std::mt19937 rng;
+
+    /**
+     * @brief Substitutes bases of out[0, length) at positions drawn by geometric skip-sampling.
+     * @param rate Per-base substitution probability; 0 leaves the buffer untouched.
+     */
+    void mutate(uint8_t *out, size_t length, double rate);
+
+public:
+
+    /**
+     * @brief Library size used by Genome and GenerationSession.
+     */
+    static constexpr size_t DEFAULT_FAMILY_COUNT = 48;
+
+    RepeatGenerator();
+
+    explicit RepeatGenerator(uint64_t seed);
+
+    /**
+     * @brief Creates a library of interspersed repeat families (SINE-like and LINE-like consensus lengths).
+     * @param count Number of families.
+     * @param gcContent GC fraction of the consensus sequences.
+     */
+    RepeatLibrary createFamilies(size_t count, double gcContent);
+
+    /**
+     * @brief Writes one diverged copy of a family into out[0, length).
+     * Copies longer than the consensus are laid down as back-to-back copies; shorter ones are 5' truncated,
+     * i.e. taken from the 3' end of the consensus like most retrotransposed insertions.
+     */
+    void insertCopy(const RepeatFamily &family, uint8_t *out, size_t length);
+
+    /**
+     * @brief Fills out[0, length) with a tandem repeat of `unit`, then applies `divergence` substitutions.
+     * Throws std::invalid_argument if unit is empty.
+     */
+    void fillTandem(const std::vector<uint8_t> &unit, uint8_t *out, size_t length, double divergence);
+
+    /**
+     * @brief Draws a random microsatellite (1-6 bp) or minisatellite (10-60 bp) unit.
+     */
+    std::vector<uint8_t> randomTandemUnit();
+
+    /**
+     * @brief Same draw written into `unit`, reusing its storage.
+     */
+    void randomTandemUnit(std::vector<uint8_t> &unit);
+};
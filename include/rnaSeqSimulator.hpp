@@ -0,0 +1,72 @@
+#pragma once
+
+#include "aliasTable.hpp"
+#include "outputFile.hpp"
+#include "transcriptome.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct RnaSeqSpec
+ * @brief library parameters of a simulated single-end, unstranded RNA-seq run.
+ */
+
+struct RnaSeqSpec {
+    size_t      reads = 1000000;
+    size_t      readLength = 100;
+    double      expressionSigma = 1.0;  /**< sd of log expression; transcript expression ~ lognormal(0, sigma) */
+    double      errorRate = 0.001;      /**< per-base substitution probability; 1 substitutes every base */
+};
+
+/**
+ * @class RnaSeqSimulator
+ * @brief draws reads from a Transcriptome and writes them as FASTQ.
+ *
+ * A read picks its transcript from an AliasTable weighted by expression x start positions (so long, highly expressed
+ * transcripts get proportionally more reads), a uniform start inside it and a random orientation. Reads are made in
+ * fixed batches of BATCH_READS, each from its own derived seed, so the FASTQ is identical for every thread count.
+ *
+ * Read names carry the truth: @r<index> <transcript>:<first>-<last>:<+|-> (1-based transcript coordinates; '-' = the read
+ * is the reverse complement of the transcript).
+ */
+
+class RnaSeqSimulator {
+private:
+    const Transcriptome    &transcriptome;
+    RnaSeqSpec              spec;
+    uint64_t                seed;
+    std::vector<double>     expression;
+    std::vector<uint32_t>   sources;        /**< transcripts at least readLength long, indexed by readSource */
+    AliasTable              readSource;
+
+public:
+    static constexpr size_t BATCH_READS = 16384;
+
+    /**
+     * @brief Draws transcript expression levels. Throws std::invalid_argument for a zero read length, a negative sigma,
+     * an error rate outside [0, 1] or a transcriptome without a transcript of at least readLength bases.
+     * @param transcriptome Must outlive the simulator.
+     */
+    RnaSeqSimulator(const Transcriptome &transcriptome, const RnaSeqSpec &spec, uint64_t seed);
+
+    /**
+     * @brief Relative expression of transcript i (0 for transcripts shorter than a read).
+     */
+    double expressionOf(size_t i) const { return expression[i]; }
+
+    size_t batchCount() const { return (spec.reads + BATCH_READS - 1) / BATCH_READS; }
+
+    /**
+     * @brief Appends the FASTQ records of batch `batch` to out; safe to call concurrently for different batches.
+     */
+    void simulateBatch(size_t batch, std::string &out) const;
+
+    /**
+     * @brief Simulates every read on `threads` workers and streams the batches to path in order.
+     * Throws std::runtime_error if the file cannot be written.
+     */
+    void writeFastq(const std::string &path, unsigned threads, const IoOptions &io = {}) const;
+};
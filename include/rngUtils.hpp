@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * NOTE: SPLITMIX64 -> cheap 64-bit mixer used to turn one user seed into independent per-chromosome / per-region seeds
+ * so that parallel generation stays reproducible regardless of thread count or scheduling order.
+ */
+
+inline uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+/**
+ * NOTE: REPEAT_LIBRARY_STREAM -> stream id of the repeat family library, disjoint from every chromosome / region index
+ */
+constexpr uint64_t REPEAT_LIBRARY_STREAM = ~uint64_t{0};
+
+/**
+ * NOTE: GENE_MODEL_STREAM -> stream id of the spliced gene layouts (second id = chromosome index)
+ */
+constexpr uint64_t GENE_MODEL_STREAM = ~uint64_t{0} - 1;
+
+/**
+ * NOTE: RNASEQ_STREAM -> stream id of the RNA-seq simulator (second id 0 = expression levels, b + 1 = read batch b)
+ */
+constexpr uint64_t RNASEQ_STREAM = ~uint64_t{0} - 2;
+
+/**
+ * NOTE: MOTIF_STREAM -> stream id of the regulatory kinds and planted binding sites (second id = chromosome index)
+ */
+constexpr uint64_t MOTIF_STREAM = ~uint64_t{0} - 3;
+
+/**
+ * @brief Derives a child seed from a parent seed and two stream identifiers (e.g. chromosome index, region index).
+ */
+inline uint64_t deriveSeed(uint64_t seed, uint64_t streamA, uint64_t streamB = 0) {
+    return splitmix64(splitmix64(seed ^ splitmix64(streamA)) ^ streamB);
+}
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "baseCodes.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+/**
+ * @struct BaseInfo
+ * @brief conatins information regard position of base in the sequence as well as base type amongst [A,T,G,C]
+ *
+ * NOTE: BaseInfo is no longer stored; SequenceBlock hands out BaseInfo values on access, deriving position from its start offset.
+ */
+
+struct BaseInfo {
+
+    char        base;
+    size_t      position;
+};
+
+/**
+ * @struct AnnotationRun
+ * @brief `length` consecutive bases, starting at block index `start`, sharing one annotation value.
+ */
+
+struct AnnotationRun {
+    size_t      start;
+    size_t      length;
+    uint32_t    value;
+};
+
+/**
+ * @class RunLengthColumn
+ * @brief per-base annotation column (e.g. region id) stored as sorted, contiguous runs.
+ * Lookup is a binary search over runs, so a chromosome with a million regions costs ~24 bytes per region, not per base.
+ */
+
+class RunLengthColumn {
+private:
+    std::vector<AnnotationRun> runs;
+
+public:
+    /**
+     * @brief Appends `length` bases carrying `value`; merges with the previous run when the value repeats.
+     */
+    void append(uint32_t value, size_t length);
+
+    /**
+     * @brief Value at block index `index`. Throws std::out_of_range past the last run.
+     */
+    uint32_t at(size_t index) const;
+
+    const std::vector<AnnotationRun>& getRuns() const { return runs; }
+
+    bool empty() const { return runs.empty(); }
+
+    size_t coveredLength() const { return runs.empty() ? 0 : runs.back().start + runs.back().length; }
+
+    void clear() { runs.clear(); }
+};
+
+/**
+ * @class SequenceBlock
+ * @brief struct-of-arrays sequence: base codes contiguous (1 byte each, see baseCodes.hpp), the start offset stored once.
+ *
+ * The BaseInfo view is preserved: block[i], iteration and range-for yield BaseInfo{base, startOffset + i} proxies,
+ * while bulk consumers (sinks, kernels) stream through codes() at one byte per base instead of sizeof(BaseInfo).
+ */
+
+class SequenceBlock {
+private:
+    size_t                  startOffset = 0;
+    std::vector<uint8_t>    baseCodes;
+    RunLengthColumn         regionIds;
+
+public:
+
+    /**
+     * @class const_iterator
+     * @brief random access proxy iterator producing BaseInfo values.
+     */
+    class const_iterator {
+    private:
+        const SequenceBlock *block = nullptr;
+        size_t               index = 0;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = BaseInfo;
+        using difference_type   = std::ptrdiff_t;
+        using reference         = BaseInfo;
+        using pointer           = void;
+
+        const_iterator() = default;
+        const_iterator(const SequenceBlock *block, size_t index) : block(block), index(index) {}
+
+        BaseInfo operator*() const { return (*block)[index]; }
+        BaseInfo operator[](difference_type offset) const { return (*block)[index + offset]; }
+
+        const_iterator& operator++() { ++index; return *this; }
+        const_iterator operator++(int) { const_iterator copy = *this; ++index; return copy; }
+        const_iterator& operator--() { --index; return *this; }
+        const_iterator operator--(int) { const_iterator copy = *this; --index; return copy; }
+        const_iterator& operator+=(difference_type offset) { index += offset; return *this; }
+        const_iterator& operator-=(difference_type offset) { index -= offset; return *this; }
+
+        friend const_iterator operator+(const_iterator it, difference_type offset) { return it += offset; }
+        friend const_iterator operator+(difference_type offset, const_iterator it) { return it += offset; }
+        friend const_iterator operator-(const_iterator it, difference_type offset) { return it -= offset; }
+        friend difference_type operator-(const const_iterator &a, const const_iterator &b) {
+            return static_cast<difference_type>(a.index) - static_cast<difference_type>(b.index);
+        }
+
+        friend bool operator==(const const_iterator &a, const const_iterator &b) { return a.index == b.index; }
+        friend auto operator<=>(const const_iterator &a, const const_iterator &b) { return a.index <=> b.index; }
+    };
+
+    SequenceBlock() = default;
+
+    /**
+     * @brief Creates `length` bases (code A) starting at sequence position `startOffset`.
+     */
+    SequenceBlock(size_t startOffset, size_t length) : startOffset(startOffset), baseCodes(length, BASE_A) {}
+
+    size_t size() const { return baseCodes.size(); }
+    bool empty() const { return baseCodes.empty(); }
+    size_t start() const { return startOffset; }
+
+    BaseInfo operator[](size_t index) const { return BaseInfo{decodeBase(baseCodes[index]), startOffset + index}; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, baseCodes.size()); }
+
+    uint8_t* codes() { return baseCodes.data(); }
+    const uint8_t* codes() const { return baseCodes.data(); }
+
+    void setBase(size_t index, char base) { baseCodes[index] = encodeBase(base); }
+
+    /**
+     * @brief Frees the base storage (capacity included) and the annotation runs.
+     */
+    void release();
+
+    /**
+     * @brief Re-targets the block to `length` bases (code A) starting at `startOffset`, keeping the storage capacity,
+     * so a window walking a chromosome allocates once. Clears the annotation runs.
+     */
+    void reset(size_t startOffset, size_t length);
+
+    RunLengthColumn& regionColumn() { return regionIds; }
+    const RunLengthColumn& regionColumn() const { return regionIds; }
+
+    /**
+     * @brief Region id of block index `index`; requires a populated region column.
+     */
+    uint32_t regionId(size_t index) const { return regionIds.at(index); }
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "proceduralGenome.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+/**
+ * NOTE: SEQUENCE PROTOCOL -> newline-terminated text requests over a Unix stream socket, any number per connection:
+ *
+ *     <region>\n   samtools-style region (see parseRegion)  ->  "OK <bases>\n" + the bases on one line + "\n"
+ *     LIST\n                                               ->  "OK <count>\n" + count lines "<name>\t<length>\n"
+ *     STATS\n                                              ->  "OK <count>\n" + count lines "<counter>\t<value>\n" (block cache)
+ *
+ * Any failure answers "ERR <message>\n" and keeps the connection open. Fetches are capped at the server's maxFetch bases.
+ */
+
+/**
+ * @class SequenceServer
+ * @brief serves a ProceduralGenome on a local Unix socket, one thread per connection.
+ */
+
+class SequenceServer {
+public:
+    static constexpr size_t DEFAULT_MAX_FETCH = 64ULL << 20;
+
+    /**
+     * @brief Longest request line accepted; a longer one gets an ERR and the connection is closed.
+     */
+    static constexpr size_t MAX_REQUEST = 4096;
+
+private:
+    const ProceduralGenome          &genome;
+    std::string                     socketPath;
+    size_t                          maxFetch;
+    int                             listenFd = -1;
+    std::atomic<bool>               stopping {false};
+
+    std::mutex                      connectionMutex;
+    std::condition_variable         connectionsDone;
+    std::unordered_set<int>         connections;
+
+    void serve(int fd);
+
+    std::string answer(const std::string &request) const;
+
+public:
+
+    /**
+     * @brief Binds and listens on socketPath. A stale socket file left by a dead server is replaced.
+     * Throws std::runtime_error if the path is too long, another server answers on it or the socket cannot be bound.
+     */
+    SequenceServer(const ProceduralGenome &genome, const std::string &socketPath, size_t maxFetch = DEFAULT_MAX_FETCH);
+
+    /**
+     * @brief Closes the listening socket and removes the socket file; run() must have returned.
+     */
+    ~SequenceServer();
+
+    SequenceServer(const SequenceServer &) = delete;
+    SequenceServer& operator=(const SequenceServer &) = delete;
+
+    /**
+     * @brief Accepts connections until stop(), then closes the open ones and waits for their threads.
+     */
+    void run();
+
+    /**
+     * @brief Makes run() return within a fraction of a second; only stores a flag, so it is safe in a signal handler.
+     */
+    void stop() { stopping.store(true); }
+};
+
+/**
+ * @class SequenceClient
+ * @brief one connection to a SequenceServer.
+ */
+
+class SequenceClient {
+private:
+    int             fd = -1;
+    std::string     pending;    /**< bytes received past the last answer */
+
+    void receive();
+
+    std::string readLine();
+
+    std::string readBytes(size_t count);
+
+    /**
+     * @brief Sends one request and returns the count of its "OK <count>" header.
+     * Throws std::invalid_argument with the server's message for an ERR answer.
+     */
+    size_t request(const std::string &line);
+
+public:
+    /**
+     * @brief Connects to socketPath. Throws std::runtime_error if nothing is serving there.
+     */
+    explicit SequenceClient(const std::string &socketPath);
+
+    ~SequenceClient();
+
+    SequenceClient(const SequenceClient &) = delete;
+    SequenceClient& operator=(const SequenceClient &) = delete;
+
+    /**
+     * @brief Bases of a samtools-style region. Throws std::invalid_argument when the server rejects the region.
+     */
+    std::string fetch(const std::string &region);
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "genome.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @struct ExonSpan
+ * @brief one exon of a mature transcript as a view into its chromosome's base codes (plus-strand orientation).
+ */
+
+struct ExonSpan {
+    const uint8_t  *codes;      /**< first base of the exon inside Chromosome::sequence */
+    size_t          start;      /**< 0-based chromosome coordinate of codes[0] */
+    size_t          length;
+};
+
+/**
+ * @struct Transcript
+ * @brief a mature (spliced) transcript: spans [firstSpan, firstSpan + spanCount) of its Transcriptome in transcription order.
+ */
+
+struct Transcript {
+    uint32_t        chromosome;     /**< index into Genome::getChromosomes() */
+    uint32_t        regionId;       /**< genome-wide region number, the N of GFF3 ID=region<N> */
+    bool            spliced;        /**< from a GeneModel (mRNA region<N>.mrna) rather than an unspliced coding region */
+    StrandInfo      strand;
+    size_t          firstSpan;
+    size_t          spanCount;
+    size_t          length;         /**< sum of the exon lengths */
+};
+
+/**
+ * @class Transcriptome
+ * @brief every transcript of a generated genome, extracted without copying bases.
+ *
+ * Spliced genes contribute their exons, unspliced coding regions a single exon spanning the region. The spans point into
+ * the chromosomes' sequences, so the genome must be fully generated (Genome::generate(threads)) and outlive this object.
+ */
+
+class Transcriptome {
+private:
+    std::vector<ExonSpan>       spans;
+    std::vector<Transcript>     transcripts;
+    std::vector<std::string>    chromosomeNames;
+
+public:
+    explicit Transcriptome(const std::vector<Chromosome> &chromosomes);
+
+    size_t size() const { return transcripts.size(); }
+
+    const Transcript& operator[](size_t index) const { return transcripts[index]; }
+
+    const std::string& chromosomeName(const Transcript &transcript) const { return chromosomeNames[transcript.chromosome]; }
+
+    /**
+     * @brief Transcript identifier matching the GFF3: region<N>.mrna for spliced genes, region<N> otherwise.
+     */
+    std::string name(const Transcript &transcript) const;
+
+    /**
+     * @brief Copies sense-strand bases [offset, offset + count) of the mature transcript to out.
+     * Throws std::out_of_range if the range runs past the transcript.
+     */
+    void extract(const Transcript &transcript, size_t offset, size_t count, uint8_t *out) const;
+};
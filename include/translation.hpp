@@ -0,0 +1,47 @@
+#pragma once
+
+#include "geneModel.hpp"
+#include "orfScanner.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * NOTE: STANDARD_GENETIC_CODE -> one-letter amino acid per codonIndex (AAA = 0 ... TTT = 63), '*' for stop codons.
+ * built from NCBI translation table 1, which lists its codons in T C A G order.
+ */
+constexpr std::array<char, 64> STANDARD_GENETIC_CODE = [] {
+    constexpr char NCBI_TABLE_1[] = "FFLLSSSSYY**CC*WLLLLPPPPHHQQRRRRIIIMTTTTNNKKSSRRVVVVAAAADDEEGGGG";
+    constexpr size_t NCBI_ORDER[4] = {2, 1, 3, 0}; // A C G T -> position in T C A G
+
+    std::array<char, 64> table {};
+    for (size_t index = 0; index < 64; ++index) {
+        table[index] = NCBI_TABLE_1[16 * NCBI_ORDER[index >> 4] + 4 * NCBI_ORDER[(index >> 2) & 3] + NCBI_ORDER[index & 3]];
+    }
+    return table;
+}();
+
+/**
+ * @brief Translates `codons` whole codons starting at codes[0]; stop codons become '*'.
+ */
+std::string translateCodons(const uint8_t *codes, size_t codons);
+
+/**
+ * @brief One of the six reading frames: 1..3 read the plus strand from offset frame - 1, -1..-3 its reverse complement.
+ * Throws std::invalid_argument for any other frame.
+ */
+std::string translateFrame(const uint8_t *codes, size_t length, int frame);
+
+/**
+ * @brief Protein encoded by an ORF, read on the ORF's strand, without the terminal stop.
+ * @param offset Sequence position of codes[0] (a window of the chromosome); codes covers [offset, offset + length).
+ */
+std::string translateOpenReadingFrame(const uint8_t *codes, size_t length, const OpenReadingFrame &orf, size_t offset = 0);
+
+/**
+ * @brief Protein of a spliced gene: its CDS pieces joined in transcription order, without the terminal stop.
+ * @param offset Sequence position of codes[0], as for translateOpenReadingFrame.
+ */
+std::string translateSplicedGene(const uint8_t *codes, size_t length, const GeneModel &genes, size_t gene, size_t offset = 0);
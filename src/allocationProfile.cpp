@@ -0,0 +1,277 @@
+#include "allocationProfile.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <malloc.h>
+
+namespace {
+
+constexpr const char *STAGE_NAMES[] = {"other", "region_planning", "base_generation", "strand_complement", "output"};
+
+static_assert(sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]) == static_cast<size_t>(AllocationStage::COUNT));
+
+constexpr size_t STAGES = static_cast<size_t>(AllocationStage::COUNT);
+
+/**
+ * NOTE: every counter below is constant-initialized, so allocations made before main() (static constructors of other
+ * translation units) find them ready; nothing here allocates while counting
+ */
+struct StageCounts {
+    std::atomic<uint64_t>   allocations {0};
+    std::atomic<uint64_t>   bytes {0};
+    std::atomic<uint64_t>   frees {0};
+    std::atomic<int64_t>    peakLive {0};
+};
+
+struct Site {
+    std::atomic<uint64_t>   key {0};            /**< (return address << 3) | stage + 1, 0 -> free slot */
+    std::atomic<uint64_t>   allocations {0};
+    std::atomic<uint64_t>   bytes {0};
+};
+
+thread_local AllocationStage    currentStage = AllocationStage::other;
+
+std::atomic<bool>               counting {false};
+std::atomic<int64_t>            liveBytes {0};
+std::atomic<int64_t>            peakLiveBytes {0};
+std::atomic<uint64_t>           untrackedSites {0};
+StageCounts                     stages[STAGES];
+Site                            sites[AllocationProfile::MAX_SITES];
+
+void raise(std::atomic<int64_t> &peak, int64_t value) {
+    int64_t seen = peak.load(std::memory_order_relaxed);
+    while (value > seen && !peak.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+void recordSite(uint64_t key, size_t size) {
+
+    /**
+     * NOTE: open addressing with linear probing; a slot is claimed once by CAS and never released until start()
+     */
+    size_t slot = static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 52) % AllocationProfile::MAX_SITES;
+    for (size_t probe = 0; probe < AllocationProfile::MAX_SITES; ++probe, slot = (slot + 1) % AllocationProfile::MAX_SITES) {
+        Site &site = sites[slot];
+        uint64_t seen = site.key.load(std::memory_order_acquire);
+        if (seen == 0 && site.key.compare_exchange_strong(seen, key, std::memory_order_acq_rel)) seen = key;
+        if (seen != key) continue;
+        site.allocations.fetch_add(1, std::memory_order_relaxed);
+        site.bytes.fetch_add(size, std::memory_order_relaxed);
+        return;
+    }
+    untrackedSites.fetch_add(1, std::memory_order_relaxed);
+}
+
+void recordAllocation(void *pointer, size_t size, void *caller) {
+
+    if (!counting.load(std::memory_order_relaxed)) return;
+
+    size_t stage = static_cast<size_t>(currentStage);
+    StageCounts &counts = stages[stage];
+    counts.allocations.fetch_add(1, std::memory_order_relaxed);
+    counts.bytes.fetch_add(size, std::memory_order_relaxed);
+
+    int64_t usable = static_cast<int64_t>(malloc_usable_size(pointer));
+    int64_t live = liveBytes.fetch_add(usable, std::memory_order_relaxed) + usable;
+    raise(peakLiveBytes, live);
+    raise(counts.peakLive, live);
+
+    recordSite((reinterpret_cast<uint64_t>(caller) << 3) | (stage + 1), size);
+}
+
+void recordFree(void *pointer) {
+
+    if (!pointer || !counting.load(std::memory_order_relaxed)) return;
+
+    stages[static_cast<size_t>(currentStage)].frees.fetch_add(1, std::memory_order_relaxed);
+    liveBytes.fetch_sub(static_cast<int64_t>(malloc_usable_size(pointer)), std::memory_order_relaxed);
+}
+
+[[maybe_unused]] void *allocate(size_t size, size_t alignment, void *caller) {
+
+    if (size == 0) size = 1;
+    for (;;) {
+        void *pointer = nullptr;
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            pointer = std::malloc(size);
+        } else if (posix_memalign(&pointer, alignment, size) != 0) {
+            pointer = nullptr;
+        }
+        if (pointer) {
+            recordAllocation(pointer, size, caller);
+            return pointer;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) throw std::bad_alloc();
+        handler();
+    }
+}
+
+[[maybe_unused]] void deallocate(void *pointer) {
+    recordFree(pointer);
+    std::free(pointer);
+}
+
+std::string siteName(uint64_t key) {
+
+    void *address = reinterpret_cast<void *>(key >> 3);
+    char text[64];
+    Dl_info info;
+    if (!dladdr(address, &info) || !info.dli_fname) {
+        std::snprintf(text, sizeof(text), "%p", address);
+        return text;
+    }
+
+    /**
+     * NOTE: the module offset is what addr2line -f -C -e <module> expects when the binary exports no symbols
+     */
+    uintptr_t offset = reinterpret_cast<uintptr_t>(address) - reinterpret_cast<uintptr_t>(info.dli_fbase);
+    std::snprintf(text, sizeof(text), "+0x%zx", static_cast<size_t>(offset));
+    std::string module = info.dli_fname;
+    module = module.substr(module.find_last_of('/') + 1) + text;
+    if (!info.dli_sname) return module;
+
+    int status = 0;
+    char *demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+    std::string name = status == 0 && demangled ? demangled : info.dli_sname;
+    std::free(demangled);
+    return name + " (" + module + ")";
+}
+
+}
+
+AllocationStage AllocationProfile::stage() {
+    return currentStage;
+}
+
+AllocationStage AllocationProfile::enter(AllocationStage stage) {
+    AllocationStage previous = currentStage;
+    currentStage = stage;
+    return previous;
+}
+
+void AllocationProfile::start() {
+
+    counting.store(false);
+    for (StageCounts &counts : stages) {
+        counts.allocations = 0;
+        counts.bytes = 0;
+        counts.frees = 0;
+        counts.peakLive = 0;
+    }
+    for (Site &site : sites) {
+        site.key = 0;
+        site.allocations = 0;
+        site.bytes = 0;
+    }
+    liveBytes = 0;
+    peakLiveBytes = 0;
+    untrackedSites = 0;
+    counting.store(enabled());
+}
+
+void AllocationProfile::stop() {
+    counting.store(false);
+}
+
+void AllocationProfile::report(std::ostream &out, uint64_t bases, size_t sitesPerStage) {
+
+    stop();
+    if (!enabled()) {
+        out << "genomorph: built without GENOMORPH_ALLOC_PROFILE, no allocation profile (make ALLOC_PROFILE=1)\n";
+        return;
+    }
+
+    /**
+     * NOTE: live bytes are net of everything freed since start(), including blocks allocated before it, so they are
+     * a lower bound early in a run; peaks are the process-wide live bytes reached while a stage was allocating
+     */
+    auto perMbp = [&](uint64_t allocations) {
+        if (!bases) return std::string("-");
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.3f", static_cast<double>(allocations) * 1e6 / static_cast<double>(bases));
+        return std::string(text);
+    };
+
+    out << "# allocation profile, bases=" << bases << '\n';
+    out << "#stage\tallocations\tbytes\tfrees\tpeak_live_bytes\tallocations_per_mbp\n";
+    uint64_t totalAllocations = 0, totalBytes = 0, totalFrees = 0;
+    for (size_t s = 0; s < STAGES; ++s) {
+        const StageCounts &counts = stages[s];
+        out << STAGE_NAMES[s] << '\t' << counts.allocations << '\t' << counts.bytes << '\t' << counts.frees << '\t'
+            << std::max<int64_t>(counts.peakLive, 0) << '\t' << perMbp(counts.allocations) << '\n';
+        totalAllocations += counts.allocations;
+        totalBytes += counts.bytes;
+        totalFrees += counts.frees;
+    }
+    out << "total\t" << totalAllocations << '\t' << totalBytes << '\t' << totalFrees << '\t' << std::max<int64_t>(peakLiveBytes, 0)
+        << '\t' << perMbp(totalAllocations) << '\n';
+
+    struct Row {
+        uint64_t    key;
+        uint64_t    allocations;
+        uint64_t    bytes;
+    };
+    std::vector<Row> rows;
+    for (const Site &site : sites) {
+        if (site.key) rows.push_back(Row{site.key, site.allocations, site.bytes});
+    }
+    std::sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) { return a.allocations > b.allocations; });
+
+    out << "#stage\tsite_allocations\tsite_bytes\tsite\n";
+    for (size_t s = 0; s < STAGES; ++s) {
+        size_t shown = 0;
+        for (const Row &row : rows) {
+            if ((row.key & 7) != s + 1) continue;
+            if (shown++ == sitesPerStage) break;
+            out << STAGE_NAMES[s] << '\t' << row.allocations << '\t' << row.bytes << '\t' << siteName(row.key) << '\n';
+        }
+    }
+    if (untrackedSites) out << "# " << untrackedSites << " allocations beyond " << MAX_SITES << " sites are only in the stage totals\n";
+}
+
+#ifdef GENOMORPH_ALLOC_PROFILE
+
+void *operator new(size_t size) {
+    return allocate(size, 0, __builtin_return_address(0));
+}
+
+void *operator new[](size_t size) {
+    return allocate(size, 0, __builtin_return_address(0));
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<size_t>(alignment), __builtin_return_address(0));
+}
+
+void *operator new[](size_t size, std::align_val_t alignment) {
+    return allocate(size, static_cast<size_t>(alignment), __builtin_return_address(0));
+}
+
+/**
+ * NOTE: the nothrow and array forms of the standard library forward to the replaced ones
+ */
+void operator delete(void *pointer) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept {
+    deallocate(pointer);
+}
+
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept {
+    deallocate(pointer);
+}
+
+#endif
@@ -0,0 +1,224 @@
+#include "bgzf.hpp"
+#include "allocationProfile.hpp"
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <zlib.h>
+
+namespace {
+
+enum BlockTag : uint32_t {
+    data_block,
+    eof_block,
+};
+
+/**
+ * NOTE: gzip member header with the BGZF extra field; bytes 16-17 receive the block size - 1
+ */
+constexpr unsigned char BLOCK_HEADER[18] = {31, 139, 8, 4, 0, 0, 0, 0, 0, 255, 6, 0, 'B', 'C', 2, 0, 0, 0};
+constexpr size_t        BLOCK_FOOTER = 8;
+
+constexpr unsigned char EOF_BLOCK[28] = {31, 139, 8, 4, 0, 0, 0, 0, 0, 255, 6, 0, 'B', 'C', 2, 0, 27, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+void appendLE32(std::string &out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+void appendLE64(std::string &out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+/**
+ * @class Deflater
+ * @brief one raw-deflate stream per worker, reset for every block instead of reallocated.
+ */
+
+class Deflater {
+private:
+    z_stream    stream {};
+
+public:
+    explicit Deflater(int level) {
+        if (deflateInit2(&stream, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw std::runtime_error("cannot initialise zlib for BGZF output");
+        }
+    }
+
+    ~Deflater() { deflateEnd(&stream); }
+
+    Deflater(const Deflater &) = delete;
+    Deflater& operator=(const Deflater &) = delete;
+
+    /**
+     * @brief Replaces out with the BGZF block of data[0, size), size <= BGZF_BLOCK_DATA.
+     */
+    void block(const char *data, size_t size, std::string &out) {
+
+        out.resize(BGZF_MAX_BLOCK);
+        std::memcpy(out.data(), BLOCK_HEADER, sizeof(BLOCK_HEADER));
+
+        deflateReset(&stream);
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        stream.avail_in = static_cast<uInt>(size);
+        stream.next_out = reinterpret_cast<Bytef *>(out.data() + sizeof(BLOCK_HEADER));
+        stream.avail_out = static_cast<uInt>(BGZF_MAX_BLOCK - sizeof(BLOCK_HEADER) - BLOCK_FOOTER);
+        int result = deflate(&stream, Z_FINISH);
+
+        size_t payload = stream.total_out;
+        if (result != Z_STREAM_END) {
+            /**
+             * NOTE: incompressible data -> one stored deflate block (5 bytes of framing), which always fits
+             */
+            char *stored = out.data() + sizeof(BLOCK_HEADER);
+            stored[0] = 1;
+            stored[1] = static_cast<char>(size & 0xFF);
+            stored[2] = static_cast<char>(size >> 8);
+            stored[3] = static_cast<char>(~size & 0xFF);
+            stored[4] = static_cast<char>((~size >> 8) & 0xFF);
+            std::memcpy(stored + 5, data, size);
+            payload = size + 5;
+        }
+
+        size_t blockSize = sizeof(BLOCK_HEADER) + payload + BLOCK_FOOTER;
+        out[16] = static_cast<char>((blockSize - 1) & 0xFF);
+        out[17] = static_cast<char>((blockSize - 1) >> 8);
+        out.resize(sizeof(BLOCK_HEADER) + payload);
+        appendLE32(out, static_cast<uint32_t>(crc32(0L, reinterpret_cast<const Bytef *>(data), static_cast<uInt>(size))));
+        appendLE32(out, static_cast<uint32_t>(size));
+    }
+};
+
+unsigned workerCount(unsigned threads) {
+    return threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+}
+
+BgzfOutputFile::BgzfOutputFile(std::unique_ptr<OutputFile> inner, const std::string &indexPath, unsigned threads, int level)
+    : inner(std::move(inner)), indexPath(indexPath), level(level), stats(Metrics::instance().sink("bgzf")),
+      writer(4 * static_cast<size_t>(workerCount(threads)), "bgzf", [this](OutputChunk &chunk) {
+          GENOMORPH_SINK_WRITE(stats, chunk.bytes.size());
+          this->inner->write(chunk.bytes);
+          compressedBytes += chunk.bytes.size();
+          uncompressedBytes += chunk.value;
+          if (chunk.tag == data_block) index.emplace_back(compressedBytes, uncompressedBytes);
+      }),
+      jobs(4 * static_cast<size_t>(workerCount(threads)))
+{
+    if (level < 0 || level > 9) throw std::invalid_argument("BGZF compression level must be within 0..9, got " + std::to_string(level));
+    for (unsigned i = 0; i < workerCount(threads); ++i) workers.emplace_back([this] { compressJobs(); });
+}
+
+BgzfOutputFile::~BgzfOutputFile() {
+    stopWorkers();
+}
+
+void BgzfOutputFile::compressJobs() {
+
+    GENOMORPH_ALLOC_STAGE(output);
+
+    std::unique_ptr<Deflater> deflater;
+    std::string scratch;
+
+    for (;;) {
+        uint32_t seen = posted.load(std::memory_order_acquire);
+        OutputChunk *chunk = nullptr;
+        if (!jobs.tryPop(chunk)) {
+            if (stopping.load(std::memory_order_acquire)) return;
+            posted.wait(seen, std::memory_order_acquire);
+            continue;
+        }
+
+        /**
+         * NOTE: the compressed block is built in scratch and swapped in, so raw and compressed buffers keep trading capacity
+         */
+        try {
+            if (!deflater) deflater = std::make_unique<Deflater>(level);
+            deflater->block(chunk->bytes.data(), chunk->bytes.size(), scratch);
+            chunk->value = chunk->bytes.size();
+            std::swap(chunk->bytes, scratch);
+        } catch (...) {
+            writer.abort(std::current_exception());
+        }
+        writer.submit(chunk);
+    }
+}
+
+void BgzfOutputFile::post(OutputChunk *chunk) {
+    /**
+     * NOTE: the job ring holds as many slots as the writer has chunks, so a push always succeeds
+     */
+    jobs.tryPush(chunk);
+    posted.fetch_add(1, std::memory_order_release);
+    posted.notify_one();
+}
+
+void BgzfOutputFile::postCurrent() {
+    if (!current) return;
+    post(current);
+    current = nullptr;
+}
+
+void BgzfOutputFile::stopWorkers() {
+    if (workers.empty()) return;
+    stopping.store(true, std::memory_order_release);
+    posted.fetch_add(1, std::memory_order_release);
+    posted.notify_all();
+    for (auto &worker : workers) worker.join();
+    workers.clear();
+}
+
+void BgzfOutputFile::write(const char *data, size_t size) {
+    while (size > 0) {
+        if (!current) current = writer.acquire(nextBlock++);
+        size_t take = std::min(size, BGZF_BLOCK_DATA - current->bytes.size());
+        current->bytes.append(data, take);
+        data += take;
+        size -= take;
+        if (current->bytes.size() == BGZF_BLOCK_DATA) postCurrent();
+    }
+}
+
+void BgzfOutputFile::flush() {
+    postCurrent();
+    writer.waitConsumed(nextBlock);
+    inner->flush();
+}
+
+void BgzfOutputFile::close() {
+    if (closed) return;
+    closed = true;
+
+    /**
+     * NOTE: blocks still being compressed are not submitted yet, so the writer may only stop once everything is consumed;
+     * after a failure acquire / waitConsumed throw a generic error and finish() below rethrows the original one
+     */
+    postCurrent();
+    try {
+        OutputChunk *eof = writer.acquire(nextBlock++);
+        eof->tag = eof_block;
+        eof->bytes.assign(reinterpret_cast<const char *>(EOF_BLOCK), sizeof(EOF_BLOCK));
+        writer.submit(eof);
+        writer.waitConsumed(nextBlock);
+    } catch (const std::runtime_error &) {
+    }
+    stopWorkers();
+    writer.finish();
+    inner->close();
+
+    if (indexPath.empty()) return;
+    std::string gzi;
+    appendLE64(gzi, index.size());
+    for (const auto &[compressed, uncompressed] : index) {
+        appendLE64(gzi, compressed);
+        appendLE64(gzi, uncompressed);
+    }
+    IoOptions plain;
+    plain.backend = IoBackend::sync;
+    std::unique_ptr<OutputFile> indexFile = openOutputFile(indexPath, plain);
+    indexFile->write(gzi);
+    indexFile->close();
+}
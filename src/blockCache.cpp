@@ -0,0 +1,104 @@
+#include "blockCache.hpp"
+#include "kernels.hpp"
+#include "rngUtils.hpp"
+
+/**
+ * NOTE: packCodes writes bytes first-code-low, which on little-endian targets is exactly the word field layout
+ * unpackCodes reads
+ */
+PackedBlock::PackedBlock(const uint8_t *codes, size_t count) : length(count), words((count + 31) / 32) {
+    kernels().packCodes(codes, count, reinterpret_cast<uint8_t *>(words.data()));
+}
+
+void PackedBlock::unpack(size_t from, size_t to, uint8_t *out) const {
+
+    for (; from < to && from % 32 != 0; ++from) *out++ = static_cast<uint8_t>((words[from / 32] >> (2 * (from % 32))) & 3);
+    if (from < to) kernels().unpackCodes(words.data() + from / 32, to - from, out);
+}
+
+BlockCache::BlockCache(size_t blockBases, uint64_t capacityBytes)
+    : capacityBytes(capacityBytes), heldBytes(Metrics::instance().gauge("block_cache_bytes"))
+{
+    uint64_t blockBytes = (blockBases + 31) / 32 * sizeof(uint64_t);
+    uint64_t blocks = capacityBytes / blockBytes;
+    for (size_t s = 0; s < SHARDS; ++s) {
+        shards[s].capacity = static_cast<size_t>(blocks / SHARDS + (s < blocks % SHARDS ? 1 : 0));
+        shards[s].slots.reserve(shards[s].capacity);
+    }
+}
+
+BlockCache::Shard& BlockCache::shardFor(uint64_t key) {
+    return shards[splitmix64(key) % SHARDS];
+}
+
+BlockCache::Block BlockCache::find(uint32_t chromosome, uint64_t block) {
+
+    uint64_t k = key(chromosome, block);
+    Shard &shard = shardFor(k);
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.index.find(k);
+        if (found != shard.index.end()) {
+            Slot &slot = shard.slots[found->second];
+            slot.referenced = true;
+            shard.hits.fetch_add(1, std::memory_order_relaxed);
+            GENOMORPH_COUNT(cache_hits, 1);
+            return slot.block;
+        }
+    }
+    shard.misses.fetch_add(1, std::memory_order_relaxed);
+    GENOMORPH_COUNT(cache_misses, 1);
+    return nullptr;
+}
+
+void BlockCache::insert(uint32_t chromosome, uint64_t block, Block codes) {
+
+    uint64_t k = key(chromosome, block);
+    Shard &shard = shardFor(k);
+    if (shard.capacity == 0) return;
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.index.count(k)) return;
+
+    uint64_t added = codes->bytes();
+    uint64_t removed = 0;
+    if (shard.slots.size() < shard.capacity) {
+        shard.index.emplace(k, shard.slots.size());
+        shard.slots.push_back(Slot{k, std::move(codes), false});
+    } else {
+        /**
+         * NOTE: at most one full turn clears every bit, so the sweep always stops within two turns
+         */
+        while (shard.slots[shard.hand].referenced) {
+            shard.slots[shard.hand].referenced = false;
+            shard.hand = (shard.hand + 1) % shard.capacity;
+        }
+        Slot &victim = shard.slots[shard.hand];
+        shard.index.erase(victim.key);
+        removed = victim.block->bytes();
+        shard.index.emplace(k, shard.hand);
+        victim = Slot{k, std::move(codes), false};
+        shard.hand = (shard.hand + 1) % shard.capacity;
+
+        shard.evictions.fetch_add(1, std::memory_order_relaxed);
+        GENOMORPH_COUNT(cache_evictions, 1);
+    }
+    shard.bytes += added - removed;
+    uint64_t held = totalBytes.fetch_add(added - removed, std::memory_order_relaxed) + added - removed;
+    GENOMORPH_GAUGE(heldBytes, held);
+}
+
+BlockCache::Stats BlockCache::stats() {
+
+    Stats total;
+    total.capacityBytes = capacityBytes;
+    for (Shard &shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total.hits += shard.hits.load(std::memory_order_relaxed);
+        total.misses += shard.misses.load(std::memory_order_relaxed);
+        total.evictions += shard.evictions.load(std::memory_order_relaxed);
+        total.blocks += shard.slots.size();
+        total.bytes += shard.bytes;
+    }
+    return total;
+}
@@ -0,0 +1,991 @@
+#include "cli.hpp"
+#include "allocationProfile.hpp"
+#include "config.hpp"
+#include "generationSession.hpp"
+#include "genome.hpp"
+#include "indexedFasta.hpp"
+#include "kernels.hpp"
+#include "memoryBudget.hpp"
+#include "metrics.hpp"
+#include "motifSearch.hpp"
+#include "orfScanner.hpp"
+#include "outputPipeline.hpp"
+#include "proceduralGenome.hpp"
+#include "pwmScanner.hpp"
+#include "rnaSeqSimulator.hpp"
+#include "outputSinks.hpp"
+#include "sequenceServer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+double parseDouble(const std::string &option, const std::string &value) {
+    size_t used = 0;
+    double parsed = 0.0;
+    try {
+        parsed = std::stod(value, &used);
+    } catch (const std::exception &) {
+        used = 0;
+    }
+    if (used == 0 || used != value.size()) throw std::invalid_argument(option + " expects a number, got '" + value + "'");
+    return parsed;
+}
+
+uint64_t parseUnsigned(const std::string &option, const std::string &value) {
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+        throw std::invalid_argument(option + " expects a non-negative integer, got '" + value + "'");
+    }
+    try {
+        return std::stoull(value);
+    } catch (const std::out_of_range &) {
+        throw std::invalid_argument(option + " value is out of range: " + value);
+    }
+}
+
+/**
+ * @brief Splits total into `count` chromosomes of decreasing length (weights count, count-1, ..., 1).
+ */
+std::vector<ChromosomeSpec> splitGenome(size_t total, size_t count) {
+
+    if (count == 0) throw std::invalid_argument("--chromosomes must be at least 1");
+
+    size_t weightSum = count * (count + 1) / 2;
+    std::vector<ChromosomeSpec> specs;
+    size_t assigned = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        size_t length = (i + 1 == count) ? total - assigned : total / weightSum * (count - i) + (total % weightSum) * (count - i) / weightSum;
+        specs.push_back(ChromosomeSpec{"chr" + std::to_string(i + 1), length});
+        assigned += length;
+    }
+    return specs;
+}
+
+std::shared_ptr<GenerationConfig> loadConfig(const CliOptions &options) {
+    return std::make_shared<GenerationConfig>(
+        options.configPath.empty() ? GenerationConfig::defaults() : GenerationConfig::fromFile(options.configPath));
+}
+
+std::unique_ptr<MetricsReporter> startMetrics(const CliOptions &options) {
+    if (options.metricsFormat.empty()) return nullptr;
+    if (!Metrics::enabled()) {
+        std::cerr << "genomorph: built without GENOMORPH_METRICS, --metrics reports will be empty\n";
+    }
+    Metrics::instance().markStart();
+    return std::make_unique<MetricsReporter>(options.metricsOut, options.metricsFormat,
+        std::chrono::milliseconds(static_cast<long long>(options.metricsInterval * 1000.0)));
+}
+
+uint64_t chooseSeed(const CliOptions &options) {
+    return options.seed ? *options.seed : static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+}
+
+IoOptions ioOptions(const CliOptions &options) {
+    IoOptions io;
+    io.backend = parseIoBackend(options.io);
+    io.direct = options.direct;
+    if (options.ioDepth < 2) throw std::invalid_argument("--io-depth must be at least 2");
+    io.depth = options.ioDepth;
+    return io;
+}
+
+/**
+ * @brief IoOptions for the FASTA / FASTQ outputs: ioOptions plus BGZF compression when --compress bgzf is set.
+ */
+IoOptions compressedIoOptions(const CliOptions &options) {
+    IoOptions io = ioOptions(options);
+    if (options.compress == "none") return io;
+    if (options.compress != "bgzf") throw std::invalid_argument("unknown --compress '" + options.compress + "' (expected none or bgzf)");
+    if (options.format != "fasta") throw std::invalid_argument("--compress bgzf only applies to --format fasta");
+    if (options.compressLevel > 9) throw std::invalid_argument("--compress-level must be within 0..9");
+    io.bgzf = true;
+    io.compressionLevel = options.compressLevel;
+    io.compressionThreads = options.threads;
+    return io;
+}
+
+std::string compressedExtension(const CliOptions &options) {
+    return options.compress == "bgzf" ? ".gz" : "";
+}
+
+std::vector<ChromosomeSpec> genomeSpecs(const CliOptions &options, const GenerationConfig &config) {
+    if (options.length > 0) return splitGenome(options.length, options.chromosomeCount);
+    if (!config.chromosomes.empty()) return config.chromosomes;
+    throw std::invalid_argument(options.command + " needs --length or a [genome] chromosomes entry in --config");
+}
+
+std::string temporaryDirectory(const CliOptions &options) {
+    if (!options.tmpDir.empty()) return options.tmpDir;
+    const char *tmp = std::getenv("TMPDIR");
+    return tmp && *tmp ? tmp : "/tmp";
+}
+
+/**
+ * @brief MemoryDemand of a run over these chromosomes with the settings given on the command line.
+ */
+MemoryDemand memoryDemand(const CliOptions &options, const std::vector<ChromosomeSpec> &specs, const GenerationConfig &config) {
+    MemoryDemand demand;
+    demand.threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    for (const ChromosomeSpec &spec : specs) {
+        demand.largestChromosome = std::max(demand.largestChromosome, spec.length);
+        demand.longestRegion = std::max(demand.longestRegion, Genome::maxRegionLength(spec.length, config));
+    }
+    demand.ioChunkBytes = IoOptions{}.chunkBytes;
+    demand.ioDepth = options.ioDepth;
+    return demand;
+}
+
+/**
+ * @brief Fits the demand into --max-memory and reports the chosen settings on stderr.
+ */
+MemoryPlan budgetMemory(const CliOptions &options, const MemoryDemand &demand) {
+    MemoryPlan plan = planMemory(options.maxMemory, demand);
+    std::cerr << "genomorph: max-memory=" << formatByteSize(options.maxMemory) << " threads=" << plan.threads;
+    if (demand.outputFiles) std::cerr << " io-depth=" << plan.ioDepth;
+    if (demand.pipelineChunks) std::cerr << " pipeline-chunks=" << plan.pipelineChunks;
+    if (demand.largestChromosome) std::cerr << " window=" << (plan.windowBases ? std::to_string(plan.windowBases) : std::string("chromosome"));
+    if (demand.cacheBytes) std::cerr << " cache=" << formatByteSize(plan.cacheBytes);
+    std::cerr << " buffers=" << formatByteSize(plan.estimatedBytes) << '\n';
+    return plan;
+}
+
+int runGenerate(const CliOptions &options) {
+
+    auto config = loadConfig(options);
+    std::vector<ChromosomeSpec> specs = genomeSpecs(options, *config);
+
+    if (options.annotations != "" && options.annotations != "gff3") {
+        throw std::invalid_argument("unknown --annotations '" + options.annotations + "' (expected gff3)");
+    }
+    if (options.out == "-" && (options.format != "fasta" || !options.annotations.empty() || options.proteins || options.accessibility)) {
+        throw std::invalid_argument("--out - only supports --format fasta without --annotations, --proteins or --accessibility");
+    }
+
+    uint64_t seed = chooseSeed(options);
+
+    Genome genome(specs, seed, std::shared_ptr<const GenerationConfig>(config));
+
+    /**
+     * NOTE: under --max-memory the chromosomes are generated in windows of whole regions and the region plans beyond
+     * the budget wait in a temporary file; the output is identical to an unbounded run
+     */
+    IoOptions io = ioOptions(options);
+    IoOptions sequenceIo = compressedIoOptions(options);
+    unsigned threads = options.threads;
+    size_t pipelineChunks = PipelinedSequenceSink::CHUNKS;
+    size_t windowBases = 0;
+    if (options.maxMemory) {
+        MemoryDemand demand = memoryDemand(options, specs, *config);
+        demand.outputFiles = (options.out == "-" ? 0 : 1) + (options.annotations.empty() ? 0 : 1) + (options.proteins ? 1 : 0)
+                           + (options.accessibility ? 1 : 0);
+        demand.pipelineChunks = pipelineChunks;
+        demand.pipelineChunkBytes = PipelinedSequenceSink::CHUNK_BASES;
+        MemoryPlan plan = budgetMemory(options, demand);
+
+        threads = plan.threads;
+        io.depth = sequenceIo.depth = plan.ioDepth;
+        pipelineChunks = plan.pipelineChunks;
+        windowBases = plan.windowBases;
+        genome.limitPlanMemory(plan.planBytes, temporaryDirectory(options));
+    }
+
+    std::unique_ptr<MetricsReporter> reporter = startMetrics(options);
+
+    std::string sequencePath = options.out == "-" ? "-" : options.out + sequenceExtension(options.format) + compressedExtension(options);
+    auto sequenceSink = std::make_unique<PipelinedSequenceSink>(
+        makeSequenceSink(options.format, sequencePath, options.lineWidth, sequenceIo), pipelineChunks);
+    std::vector<std::unique_ptr<AnnotationSink>> annotationSinks;
+    if (options.annotations == "gff3") annotationSinks.push_back(std::make_unique<Gff3Sink>(options.out + ".gff3", io));
+    if (options.accessibility) annotationSinks.push_back(std::make_unique<AccessibilityBedGraphSink>(options.out + ".accessibility.bedgraph", io));
+    std::unique_ptr<ProteinFastaSink> proteinSink;
+    if (options.proteins) proteinSink = std::make_unique<ProteinFastaSink>(options.out + ".faa", options.lineWidth, io);
+
+    sequenceSink->beginGenome(specs);
+    for (auto &annotationSink : annotationSinks) annotationSink->beginGenome(specs);
+
+    genome.generate(threads, [&](const Chromosome &chromosome) {
+        GENOMORPH_ALLOC_STAGE(output);
+        const SequenceBlock &sequence = chromosome.sequence;
+        if (sequence.start() == 0) {
+            sequenceSink->beginSequence(chromosome.name, chromosome.length);
+            for (auto &annotationSink : annotationSinks) annotationSink->writeRegions(chromosome);
+        }
+
+        sequenceSink->writeBases(sequence.codes(), sequence.size());
+        if (proteinSink) proteinSink->writeProteins(chromosome);
+
+        if (sequence.start() + sequence.size() == chromosome.length) sequenceSink->endSequence();
+    }, windowBases);
+
+    {
+        GENOMORPH_ALLOC_STAGE(output);
+        sequenceSink->finish();
+        for (auto &annotationSink : annotationSinks) annotationSink->finish();
+        if (proteinSink) proteinSink->finish();
+    }
+
+    if (reporter) reporter->stop();
+
+    std::cerr << "genomorph: seed=" << seed << " isa=" << isaName(kernels().isa) << " io="
+              << ioBackendName(options.out == "-" ? IoBackend::sync : resolveIoBackend(io.backend))
+              << " bases=" << genome.totalLength() << " chromosomes=" << specs.size() << " -> " << sequencePath << '\n';
+    if (genome.spilledPlanBytes()) std::cerr << "genomorph: spilled " << formatByteSize(genome.spilledPlanBytes()) << " of region plans\n";
+    return 0;
+}
+
+/**
+ * @brief `genomorph stream`: one long FASTA record generated chunk by chunk through a GenerationSession,
+ * checkpointed every --checkpoint-every bases so a preempted run continues with --resume instead of restarting.
+ */
+int runStream(const CliOptions &options) {
+
+    auto config = loadConfig(options);
+    if (options.out == "-") throw std::invalid_argument("stream needs a file --out prefix");
+    if (options.chunkSize == 0) throw std::invalid_argument("--chunk must be positive");
+    if (options.resume && options.checkpointPath.empty()) throw std::invalid_argument("--resume needs --checkpoint");
+    if (options.compress != "none") throw std::invalid_argument("stream does not support --compress (resuming needs an uncompressed FASTA)");
+
+    /**
+     * NOTE: the session fills regions one at a time and never plans gene models or motif sites, so these settings
+     * would be dropped without a trace
+     */
+    if (config->genes.splicedFraction > 0.0) throw std::invalid_argument("stream does not support [genes] spliced, use generate");
+    if (config->regulatory.motifDensity > 0.0) throw std::invalid_argument("stream does not support [regulatory] motif_density, use generate");
+
+    size_t chunkSize = options.chunkSize;
+    IoOptions io = ioOptions(options);
+    if (options.maxMemory) {
+        MemoryDemand demand = memoryDemand(options, {}, *config);
+        demand.threads = 1;
+        demand.largestChromosome = chunkSize;
+        demand.outputFiles = 1;
+        MemoryPlan plan = budgetMemory(options, demand);
+        if (plan.windowBases) chunkSize = plan.windowBases;
+        io.depth = plan.ioDepth;
+    }
+
+    std::string sequencePath = options.out + ".fa";
+    std::unique_ptr<GenerationSession> session;
+    std::unique_ptr<FastaSink> sink;
+
+    if (options.resume) {
+        session = std::make_unique<GenerationSession>(GenerationSession::resume(options.checkpointPath, config));
+
+        /**
+         * NOTE: the checkpoint's record layout wins over the command line; older checkpoints carry none
+         */
+        if (session->getLineWidth() == 0) session->setRecordLayout(options.sequenceName, options.lineWidth);
+        if (session->getRecordName() != options.sequenceName || session->getLineWidth() != options.lineWidth) {
+            std::cerr << "genomorph: resuming record " << session->getRecordName() << " with line width " << session->getLineWidth()
+                      << " from the checkpoint, --name / --line-width are ignored\n";
+        }
+        sink = FastaSink::resume(sequencePath, session->getLineWidth(), session->getRecordName(), session->generated(), io);
+        std::cerr << "genomorph: resuming at base " << session->generated() << " of " << session->getTargetLength() << '\n';
+    } else {
+        if (options.length == 0) throw std::invalid_argument("stream needs --length");
+        session = std::make_unique<GenerationSession>(chooseSeed(options), options.length, config);
+        session->setRecordLayout(options.sequenceName, options.lineWidth);
+        sink = std::make_unique<FastaSink>(sequencePath, options.lineWidth, io);
+        sink->beginSequence(options.sequenceName, options.length);
+    }
+
+    std::unique_ptr<MetricsReporter> reporter = startMetrics(options);
+
+    size_t sinceCheckpoint = 0;
+    while (session->remaining() > 0) {
+        SequenceBlock block = session->append(chunkSize);
+        {
+            GENOMORPH_ALLOC_STAGE(output);
+            sink->writeBases(block.codes(), block.size());
+        }
+        sinceCheckpoint += block.size();
+
+        /**
+         * NOTE: the output is flushed before the checkpoint is replaced, so a checkpoint never points past written data
+         */
+        if (!options.checkpointPath.empty() && (sinceCheckpoint >= options.checkpointEvery || session->remaining() == 0)) {
+            sink->flush();
+            session->saveCheckpoint(options.checkpointPath);
+            sinceCheckpoint = 0;
+        }
+    }
+
+    sink->endSequence();
+    sink->finish();
+    if (reporter) reporter->stop();
+
+    std::cerr << "genomorph: seed=" << session->getSeed() << " isa=" << isaName(kernels().isa) << " bases=" << session->generated() << " -> " << sequencePath << '\n';
+    return 0;
+}
+
+/**
+ * @brief `genomorph orfs`: generates the genome in memory and checks every planned coding region is still an intact ORF,
+ * then reports long ORFs per chromosome. Exit code 1 when a region is broken or spurious long ORFs exceed the limit.
+ */
+int runOrfs(const CliOptions &options) {
+
+    auto config = loadConfig(options);
+    std::vector<ChromosomeSpec> specs = genomeSpecs(options, *config);
+    if (options.minCodons < 2) throw std::invalid_argument("--min-codons must be at least 2");
+
+    uint64_t seed = chooseSeed(options);
+    Genome genome(specs, seed, std::shared_ptr<const GenerationConfig>(config));
+
+    std::unique_ptr<MetricsReporter> reporter = startMetrics(options);
+
+    std::unique_ptr<std::ofstream> bed;
+    if (!options.orfBedPath.empty()) {
+        bed = std::make_unique<std::ofstream>(options.orfBedPath);
+        if (!*bed) throw std::runtime_error("cannot open " + options.orfBedPath);
+    }
+
+    std::cout << "#chrom\tbases\tplanned_cds\tintact_cds\tlong_orfs\tspurious_long_orfs\n";
+    OrfReport total;
+    std::vector<std::string> broken;
+
+    genome.generate(options.threads, [&](const Chromosome &chromosome) {
+        std::vector<OpenReadingFrame> longOrfs;
+        OrfReport report = scanOpenReadingFrames(chromosome.sequence.codes(), chromosome.sequence.size(), chromosome.regions,
+                                                 options.minCodons, 2, bed ? &longOrfs : nullptr);
+
+        std::cout << chromosome.name << '\t' << report.scannedBases << '\t' << report.plannedCoding << '\t' << report.intactCoding
+                  << '\t' << report.longOrfs << '\t' << report.spuriousLongOrfs << '\n';
+        for (size_t r : report.brokenRegions) {
+            const RegionPlan &plan = chromosome.regions[r].base.region_plan;
+            broken.push_back(chromosome.name + ":" + std::to_string(plan.region_start_index + 1) + "-"
+                             + std::to_string(plan.region_end_index + 1) + (plan.strand == StrandInfo::plus ? "(+)" : "(-)"));
+        }
+        if (bed) {
+            for (const OpenReadingFrame &orf : longOrfs) {
+                *bed << chromosome.name << '\t' << orf.start << '\t' << orf.end << "\torf\t" << orf.codons() << '\t'
+                     << (orf.strand == StrandInfo::plus ? '+' : '-') << '\n';
+            }
+        }
+
+        total.scannedBases += report.scannedBases;
+        total.plannedCoding += report.plannedCoding;
+        total.intactCoding += report.intactCoding;
+        total.longOrfs += report.longOrfs;
+        total.spuriousLongOrfs += report.spuriousLongOrfs;
+    });
+
+    if (bed && !bed->flush()) throw std::runtime_error("failed writing " + options.orfBedPath);
+    if (reporter) reporter->stop();
+
+    double spuriousPerMbp = total.scannedBases ? total.spuriousLongOrfs * 1e6 / static_cast<double>(total.scannedBases) : 0.0;
+    std::cout << "total\t" << total.scannedBases << '\t' << total.plannedCoding << '\t' << total.intactCoding << '\t'
+              << total.longOrfs << '\t' << total.spuriousLongOrfs << '\n';
+    std::cout << "# spurious long ORFs per Mbp: " << std::fixed << std::setprecision(3) << spuriousPerMbp << '\n';
+
+    std::cerr << "genomorph: seed=" << seed << " isa=" << isaName(kernels().isa) << " bases=" << total.scannedBases
+              << " min-codons=" << options.minCodons << '\n';
+
+    int status = 0;
+    if (!broken.empty()) {
+        std::cerr << "genomorph: " << broken.size() << " planned coding regions are not intact ORFs:";
+        for (size_t i = 0; i < broken.size() && i < 10; ++i) std::cerr << ' ' << broken[i];
+        std::cerr << (broken.size() > 10 ? " ...\n" : "\n");
+        status = 1;
+    }
+    if (options.maxSpuriousPerMbp && spuriousPerMbp > *options.maxSpuriousPerMbp) {
+        std::cerr << "genomorph: " << spuriousPerMbp << " spurious long ORFs per Mbp exceeds --max-spurious-per-mbp "
+                  << *options.maxSpuriousPerMbp << '\n';
+        status = 1;
+    }
+    return status;
+}
+
+/**
+ * @brief Patterns given with --motif NAME=IUPAC, or the consensus of every built-in library motif.
+ */
+std::vector<MotifPattern> motifPatterns(const CliOptions &options) {
+    std::vector<MotifPattern> patterns;
+    for (const std::string &motif : options.motifs) {
+        size_t equals = motif.find('=');
+        if (equals == std::string::npos || equals == 0) throw std::invalid_argument("--motif expects NAME=IUPAC, got '" + motif + "'");
+        patterns.push_back(MotifPattern{motif.substr(0, equals), motif.substr(equals + 1)});
+    }
+    if (patterns.empty()) {
+        for (const PositionWeightMatrix &motif : motifLibrary()) patterns.push_back(MotifPattern{motif.getName(), motif.getConsensus()});
+    }
+    return patterns;
+}
+
+/**
+ * @brief `genomorph motifs`: generates the genome in memory and searches it for every pattern on both strands, counting
+ * background occurrences against the binding sites planted into regulatory regions ([regulatory] in the config).
+ */
+int runMotifs(const CliOptions &options) {
+
+    auto config = loadConfig(options);
+    std::vector<ChromosomeSpec> specs = genomeSpecs(options, *config);
+    MotifSearcher searcher(motifPatterns(options));
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    uint64_t seed = chooseSeed(options);
+    Genome genome(specs, seed, std::shared_ptr<const GenerationConfig>(config));
+
+    std::unique_ptr<MetricsReporter> reporter = startMetrics(options);
+
+    std::unique_ptr<std::ofstream> bed;
+    if (!options.hitsBedPath.empty()) {
+        bed = std::make_unique<std::ofstream>(options.hitsBedPath);
+        if (!*bed) throw std::runtime_error("cannot open " + options.hitsBedPath);
+    }
+
+    /**
+     * NOTE: planted sites are matched to hits of the pattern with the same name, at the same start and strand
+     */
+    std::vector<uint32_t> patternOfMotif(motifLibrary().size(), UINT32_MAX);
+    for (uint32_t p = 0; p < searcher.size(); ++p) {
+        for (size_t m = 0; m < motifLibrary().size(); ++m) {
+            if (motifLibrary()[m].getName() == searcher.pattern(p).name) patternOfMotif[m] = p;
+        }
+    }
+
+    std::vector<size_t> hits(searcher.size(), 0), inRegulatory(searcher.size(), 0), planted(searcher.size(), 0), exact(searcher.size(), 0);
+    size_t scannedBases = 0;
+    size_t regionOffset = 0;
+
+    genome.generate(options.threads, [&](const Chromosome &chromosome) {
+        std::vector<MotifHit> found = searcher.search(chromosome.sequence.codes(), chromosome.sequence.size(), chromosome.regions, threads);
+
+        for (const MotifHit &hit : found) {
+            const RegionInfo &region = chromosome.regions[hit.region];
+            ++hits[hit.pattern];
+            if (region.base.type == FeatureType::regulatory) ++inRegulatory[hit.pattern];
+            if (bed) {
+                *bed << chromosome.name << '\t' << hit.start << '\t' << hit.start + searcher.pattern(hit.pattern).consensus.size() << '\t'
+                     << searcher.pattern(hit.pattern).name << "\t0\t" << (hit.strand == StrandInfo::plus ? '+' : '-') << "\tregion"
+                     << regionOffset + hit.region << '\t' << annotationTypeName(region) << '\n';
+            }
+        }
+
+        for (const MotifSite &site : chromosome.motifSites) {
+            uint32_t p = patternOfMotif[site.motif];
+            if (p == UINT32_MAX) continue;
+            ++planted[p];
+            auto first = std::lower_bound(found.begin(), found.end(), site.start, [](const MotifHit &hit, size_t start) { return hit.start < start; });
+            for (auto hit = first; hit != found.end() && hit->start == site.start; ++hit) {
+                if (hit->pattern == p && (hit->strand == site.strand || searcher.palindromic(p))) {
+                    ++exact[p];
+                    break;
+                }
+            }
+        }
+
+        scannedBases += chromosome.sequence.size();
+        regionOffset += chromosome.regions.size();
+    });
+
+    if (bed && !bed->flush()) throw std::runtime_error("failed writing " + options.hitsBedPath);
+    if (reporter) reporter->stop();
+
+    /**
+     * NOTE: background = hits that are not an exact copy of a planted site
+     */
+    std::cout << "#motif\tconsensus\thits\tin_regulatory\tplanted\tplanted_exact\tbackground_per_mbp\n";
+    for (size_t p = 0; p < searcher.size(); ++p) {
+        double background = scannedBases ? (hits[p] - exact[p]) * 1e6 / static_cast<double>(scannedBases) : 0.0;
+        std::cout << searcher.pattern(p).name << '\t' << searcher.pattern(p).consensus << '\t' << hits[p] << '\t' << inRegulatory[p]
+                  << '\t' << planted[p] << '\t' << exact[p] << '\t' << std::fixed << std::setprecision(3) << background << '\n';
+    }
+
+    std::cerr << "genomorph: seed=" << seed << " isa=" << isaName(kernels().isa) << " bases=" << scannedBases
+              << " patterns=" << searcher.size() << '\n';
+    return 0;
+}
+
+/**
+ * @brief `genomorph pwmscan`: generates the genome in memory, scores every window of both strands against each library
+ * PWM and checks that the binding sites planted into regulatory regions score as hits where their metadata says.
+ * Exit code 1 when --min-recovery is set and a smaller share of planted sites is recovered.
+ */
+int runPwmScan(const CliOptions &options) {
+
+    auto config = loadConfig(options);
+    std::vector<ChromosomeSpec> specs = genomeSpecs(options, *config);
+    PwmScanner scanner(motifLibrary(), options.minScoreFraction);
+    unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+
+    uint64_t seed = chooseSeed(options);
+    Genome genome(specs, seed, std::shared_ptr<const GenerationConfig>(config));
+
+    std::unique_ptr<MetricsReporter> reporter = startMetrics(options);
+
+    std::unique_ptr<std::ofstream> bed;
+    if (!options.hitsBedPath.empty()) {
+        bed = std::make_unique<std::ofstream>(options.hitsBedPath);
+        if (!*bed) throw std::runtime_error("cannot open " + options.hitsBedPath);
+    }
+
+    std::vector<size_t> hits(scanner.size(), 0), inRegulatory(scanner.size(), 0), planted(scanner.size(), 0), recovered(scanner.size(), 0);
+    size_t scannedBases = 0;
+    size_t regionOffset = 0;
+    size_t claimingRegions = 0;
+    size_t confirmedRegions = 0;
+
+    genome.generate(options.threads, [&](const Chromosome &chromosome) {
+        std::vector<PwmHit> found = scanner.scan(chromosome.sequence.codes(), chromosome.sequence.size(), chromosome.regions, threads);
+
+        for (const PwmHit &hit : found) {
+            const RegionInfo &region = chromosome.regions[hit.region];
+            ++hits[hit.motif];
+            if (region.base.type == FeatureType::regulatory) ++inRegulatory[hit.motif];
+            if (bed) {
+                *bed << chromosome.name << '\t' << hit.start << '\t' << hit.start + scanner.width(hit.motif) << '\t'
+                     << scanner.name(hit.motif) << '\t' << std::fixed << std::setprecision(3) << hit.score << '\t'
+                     << (hit.strand == StrandInfo::plus ? '+' : '-') << "\tregion" << regionOffset + hit.region << '\t'
+                     << annotationTypeName(region) << '\n';
+            }
+        }
+
+        /**
+         * NOTE: a planted site is recovered by a hit of its motif at its start on its strand; a region is confirmed when
+         * every site its metadata lists is recovered
+         */
+        for (const RegionInfo &region : chromosome.regions) {
+            if (!region.regulatory_meta_data || region.regulatory_meta_data->siteCount == 0) continue;
+            const RegulatoryMetaData &meta = *region.regulatory_meta_data;
+            size_t confirmed = 0;
+
+            for (uint32_t s = meta.firstSite; s < meta.firstSite + meta.siteCount; ++s) {
+                const MotifSite &site = chromosome.motifSites[s];
+                ++planted[site.motif];
+                auto first = std::lower_bound(found.begin(), found.end(), site.start, [](const PwmHit &hit, size_t start) { return hit.start < start; });
+                for (auto hit = first; hit != found.end() && hit->start == site.start; ++hit) {
+                    if (hit->motif == site.motif && (hit->strand == site.strand || scanner.palindromic(site.motif))) {
+                        ++recovered[site.motif];
+                        ++confirmed;
+                        break;
+                    }
+                }
+            }
+            ++claimingRegions;
+            if (confirmed == meta.siteCount) ++confirmedRegions;
+        }
+
+        scannedBases += chromosome.sequence.size();
+        regionOffset += chromosome.regions.size();
+    });
+
+    if (bed && !bed->flush()) throw std::runtime_error("failed writing " + options.hitsBedPath);
+    if (reporter) reporter->stop();
+
+    size_t totalPlanted = 0;
+    size_t totalRecovered = 0;
+    std::cout << "#motif\twidth\tthreshold_bits\tmax_bits\thits\tin_regulatory\tplanted\trecovered\tbackground_per_mbp\n";
+    for (size_t m = 0; m < scanner.size(); ++m) {
+        double background = scannedBases ? (hits[m] - recovered[m]) * 1e6 / static_cast<double>(scannedBases) : 0.0;
+        std::cout << scanner.name(m) << '\t' << scanner.width(m) << '\t' << std::fixed << std::setprecision(3) << scanner.threshold(m)
+                  << '\t' << scanner.maxScore(m) << '\t' << hits[m] << '\t' << inRegulatory[m] << '\t' << planted[m] << '\t'
+                  << recovered[m] << '\t' << background << '\n';
+        totalPlanted += planted[m];
+        totalRecovered += recovered[m];
+    }
+    double recovery = totalPlanted ? static_cast<double>(totalRecovered) / static_cast<double>(totalPlanted) : 0.0;
+    std::cout << "# planted sites recovered: " << totalRecovered << " / " << totalPlanted << " (" << std::setprecision(4) << recovery
+              << "), regions with every site recovered: " << confirmedRegions << " / " << claimingRegions << '\n';
+
+    std::cerr << "genomorph: seed=" << seed << " isa=" << isaName(kernels().isa) << " bases=" << scannedBases
+              << " min-score-fraction=" << options.minScoreFraction << '\n';
+
+    /**
+     * NOTE: with nothing planted there is no recovery to measure; 0 / 0 must not pass --min-recovery
+     */
+    if (!totalPlanted) {
+        std::cerr << "genomorph: " << (options.minRecovery ? "" : "warning: ")
+                  << "no sites were planted, set [regulatory] motif_density in --config to measure recovery\n";
+        if (options.minRecovery) return 1;
+    }
+    if (options.minRecovery && recovery < *options.minRecovery) {
+        std::cerr << "genomorph: planted site recovery " << recovery << " is below --min-recovery " << *options.minRecovery << '\n';
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Planned-only genome for `fetch` / `serve`; bases are regenerated per request from --seed and --config.
+ */
+std::unique_ptr<ProceduralGenome> proceduralGenome(const CliOptions &options, uint64_t seed) {
+    auto config = loadConfig(options);
+    std::vector<ChromosomeSpec> specs = genomeSpecs(options, *config);
+
+    unsigned threads = options.threads;
+    size_t cacheBytes = options.cacheMb << 20;
+    if (options.maxMemory) {
+        MemoryDemand demand = memoryDemand(options, {}, *config);
+        demand.cacheBytes = cacheBytes;
+        MemoryPlan plan = budgetMemory(options, demand);
+        threads = plan.threads;
+        cacheBytes = plan.cacheBytes;
+    }
+    return std::make_unique<ProceduralGenome>(specs, seed, std::shared_ptr<const GenerationConfig>(config), threads, cacheBytes);
+}
+
+/**
+ * @brief `genomorph fetch`: prints regions as FASTA, read from an indexed FASTA (written with its .fai by generate /
+ * rnaseq / stream or samtools faidx) by seeking straight to each region, asked from a `genomorph serve` socket, or
+ * regenerated in-process from --seed and the genome options.
+ */
+int runFetch(const CliOptions &options) {
+
+    if (options.regions.empty()) throw std::invalid_argument("fetch needs at least one --region");
+    if (options.lineWidth == 0) throw std::invalid_argument("--line-width must be positive");
+    if (!options.fastaPath.empty() && !options.socketPath.empty()) throw std::invalid_argument("fetch takes --fasta or --socket, not both");
+
+    std::function<std::string(const std::string &)> fetch;
+    std::unique_ptr<IndexedFasta> fasta;
+    std::unique_ptr<SequenceClient> client;
+    std::unique_ptr<ProceduralGenome> genome;
+    if (!options.fastaPath.empty()) {
+        fasta = std::make_unique<IndexedFasta>(options.fastaPath);
+        fetch = [&](const std::string &region) { return fasta->fetch(region); };
+    } else if (!options.socketPath.empty()) {
+        client = std::make_unique<SequenceClient>(options.socketPath);
+        fetch = [&](const std::string &region) { return client->fetch(region); };
+    } else {
+        /**
+         * NOTE: without a seed the regenerated genome would match nothing ever written, so it is required here
+         */
+        if (!options.seed) throw std::invalid_argument("fetch needs --fasta, --socket or --seed");
+        genome = proceduralGenome(options, *options.seed);
+        fetch = [&](const std::string &region) { return genome->fetch(region); };
+    }
+
+    std::string out;
+    for (const std::string &region : options.regions) {
+        std::string bases = fetch(region);
+        out += '>';
+        out += region;
+        out += '\n';
+        for (size_t i = 0; i < bases.size(); i += options.lineWidth) {
+            out.append(bases, i, options.lineWidth);
+            out += '\n';
+        }
+    }
+    std::cout << out;
+    std::cout.flush();
+    if (!std::cout) throw std::runtime_error("failed writing standard output");
+    return 0;
+}
+
+SequenceServer *activeServer = nullptr;
+
+void stopActiveServer(int) {
+    if (activeServer) activeServer->stop();
+}
+
+/**
+ * @brief `genomorph serve`: plans the genome and answers region requests on a Unix socket until SIGINT / SIGTERM,
+ * regenerating every window on demand (see sequenceServer.hpp for the protocol).
+ */
+int runServe(const CliOptions &options) {
+
+    if (options.socketPath.empty()) throw std::invalid_argument("serve needs --socket");
+
+    uint64_t seed = chooseSeed(options);
+    std::unique_ptr<ProceduralGenome> genome = proceduralGenome(options, seed);
+    SequenceServer server(*genome, options.socketPath);
+
+    size_t total = 0;
+    for (const Chromosome &chromosome : genome->getChromosomes()) total += chromosome.length;
+    std::cerr << "genomorph: seed=" << seed << " isa=" << isaName(kernels().isa) << " bases=" << total
+              << " chromosomes=" << genome->getChromosomes().size() << " serving on " << options.socketPath << '\n';
+
+    activeServer = &server;
+    std::signal(SIGINT, stopActiveServer);
+    std::signal(SIGTERM, stopActiveServer);
+    server.run();
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    activeServer = nullptr;
+
+    BlockCache::Stats stats = genome->cacheStats();
+    std::cerr << "genomorph: cache hits=" << stats.hits << " misses=" << stats.misses << " evictions=" << stats.evictions
+              << " bytes=" << stats.bytes << '\n';
+    return 0;
+}
+
+/**
+ * @brief `genomorph rnaseq`: generates the genome in memory, writes it like `generate` (FASTA / 2bit / packed and a GFF3
+ * with the gene structures), then simulates RNA-seq reads from its transcripts into <out>.fq.
+ */
+int runRnaSeq(const CliOptions &options) {
+
+    auto config = loadConfig(options);
+    std::vector<ChromosomeSpec> specs = genomeSpecs(options, *config);
+    if (options.out == "-") throw std::invalid_argument("rnaseq needs a file --out prefix");
+
+    RnaSeqSpec spec;
+    spec.reads = options.reads;
+    spec.readLength = options.readLength;
+    spec.expressionSigma = options.expressionSigma;
+    spec.errorRate = options.errorRate;
+
+    uint64_t seed = chooseSeed(options);
+    Genome genome(specs, seed, std::shared_ptr<const GenerationConfig>(config));
+
+    std::unique_ptr<MetricsReporter> reporter = startMetrics(options);
+
+    genome.generate(options.threads);
+
+    std::string sequencePath = options.out + sequenceExtension(options.format) + compressedExtension(options);
+    IoOptions io = ioOptions(options);
+    auto sequenceSink = std::make_unique<PipelinedSequenceSink>(
+        makeSequenceSink(options.format, sequencePath, options.lineWidth, compressedIoOptions(options)));
+    Gff3Sink annotationSink(options.out + ".gff3", io);
+    sequenceSink->beginGenome(specs);
+    annotationSink.beginGenome(specs);
+    for (const Chromosome &chromosome : genome.getChromosomes()) {
+        sequenceSink->beginSequence(chromosome.name, chromosome.length);
+        sequenceSink->writeBases(chromosome.sequence.codes(), chromosome.sequence.size());
+        sequenceSink->endSequence();
+        annotationSink.writeRegions(chromosome);
+    }
+    sequenceSink->finish();
+    annotationSink.finish();
+
+    Transcriptome transcriptome(genome.getChromosomes());
+    RnaSeqSimulator simulator(transcriptome, spec, seed);
+    std::string readsPath = options.out + ".fq" + compressedExtension(options);
+    simulator.writeFastq(readsPath, options.threads, compressedIoOptions(options));
+
+    if (reporter) reporter->stop();
+
+    std::cerr << "genomorph: seed=" << seed << " isa=" << isaName(kernels().isa) << " io=" << ioBackendName(resolveIoBackend(io.backend))
+              << " bases=" << genome.totalLength() << " transcripts=" << transcriptome.size() << " reads=" << spec.reads << " -> " << readsPath << '\n';
+    return 0;
+}
+
+int runCommand(const CliOptions &options) {
+    if (options.command == "stream") return runStream(options);
+    if (options.command == "orfs") return runOrfs(options);
+    if (options.command == "rnaseq") return runRnaSeq(options);
+    if (options.command == "motifs") return runMotifs(options);
+    if (options.command == "pwmscan") return runPwmScan(options);
+    if (options.command == "fetch") return runFetch(options);
+    if (options.command == "serve") return runServe(options);
+    return runGenerate(options);
+}
+
+}
+
+void printUsage(std::ostream &out) {
+    out << "usage: genomorph generate [options]\n"
+           "       genomorph orfs [--min-codons N] [--max-spurious-per-mbp X] [--orf-bed FILE] [options]\n"
+           "       genomorph rnaseq [--reads N] [--read-length L] [options]\n"
+           "       genomorph motifs [--motif NAME=IUPAC]... [--hits-bed FILE] [options]\n"
+           "       genomorph pwmscan [--min-score-fraction F] [--min-recovery R] [--hits-bed FILE] [options]\n"
+           "       genomorph fetch (--fasta FILE | --socket PATH | --seed S [options]) --region R [--region R]...\n"
+           "       genomorph serve --socket PATH [--cache-mb M] [options]\n"
+           "       genomorph stream --length N [--checkpoint FILE [--checkpoint-every N]] [--resume] [options]\n"
+           "\n"
+           "  --length N          total genome length in bases (split over --chromosomes)\n"
+           "  --chromosomes K     number of chromosomes for --length (default 1)\n"
+           "  --config FILE       declarative config (composition, lengths, gc, genes, regulatory motifs, strand, chromosomes)\n"
+           "  --seed S            master seed (default: clock, printed on stderr)\n"
+           "  --threads T         worker threads (default: all cores)\n"
+           "  --format F          fasta | 2bit | packed (default fasta)\n"
+           "  --line-width W      FASTA line width (default 60)\n"
+           "  --annotations A     gff3: also write <out>.gff3\n"
+           "  --proteins          also write the translated coding regions to <out>.faa (ids match the GFF3)\n"
+           "  --accessibility     also write the regulatory accessibility track to <out>.accessibility.bedgraph\n"
+           "  --out PREFIX        output prefix, extension added per format (default genomorph; - = stdout)\n"
+           "  --io B              output backend: auto | uring | threads | sync (default auto = uring when available)\n"
+           "  --io-depth N        chunk buffers per output file, i.e. writes in flight + 1 (default 4)\n"
+           "  --direct            open outputs with O_DIRECT (async backends only)\n"
+           "  --compress C        none | bgzf: block-compress FASTA / FASTQ on --threads workers, adds .gz and a .gzi index\n"
+           "  --compress-level N  zlib level 0-9 for --compress (default 6)\n"
+           "  --max-memory SIZE   memory budget such as 512M or 4G: shrinks buffers, queue depths, the cache, the bases\n"
+           "                      generated per step and threads to fit, spills region plans (generate, stream, fetch, serve)\n"
+           "  --tmp-dir DIR       where region plans spill under --max-memory (default $TMPDIR or /tmp)\n"
+           "  --alloc-profile     report allocations, bytes, peak live bytes and top sites per stage on stderr\n"
+           "                      (needs a build with make ALLOC_PROFILE=1)\n"
+           "  --metrics M         json | prometheus: report stage timers, rates, sinks and worker busy/idle\n"
+           "  --metrics-out FILE  metrics destination (default stderr)\n"
+           "  --metrics-interval S  also rewrite the metrics file every S seconds\n"
+           "\n"
+           "stream (single FASTA record, resumable; rejects [genes] spliced and [regulatory] motif_density):\n"
+           "  --name NAME         record name (default chr1)\n"
+           "  --chunk N           bases generated per step (default 4194304)\n"
+           "  --checkpoint FILE   session checkpoint, rewritten every --checkpoint-every bases (default 67108864)\n"
+           "  --resume            continue <out>.fa from FILE after preemption (keeps the record name and line width in FILE)\n"
+           "\n"
+           "orfs (six-frame ORF check of an in-memory genome, exit 1 on failure):\n"
+           "  --min-codons N      ORFs reported as long from N codons, stop included (default 300)\n"
+           "  --max-spurious-per-mbp X  fail when long ORFs not ending at a planned stop exceed X per Mbp\n"
+           "  --orf-bed FILE      write the long ORFs as BED6 (score = codons)\n"
+           "\n"
+           "rnaseq (genome + GFF3 + single-end unstranded reads in <out>.fq):\n"
+           "  --reads N           reads to simulate (default 1000000)\n"
+           "  --read-length L     bases per read (default 100)\n"
+           "  --expression-sigma S  sd of log transcript expression (default 1.0)\n"
+           "  --error-rate E      per-base substitution rate (default 0.001)\n"
+           "\n"
+           "motifs (both-strand IUPAC pattern search of an in-memory genome, hits vs planted binding sites):\n"
+           "  --motif NAME=IUPAC  pattern to search, repeatable, at most 64 bases (default: the built-in motif library)\n"
+           "  --hits-bed FILE     write every hit as BED6 plus the covering region id and type\n"
+           "\n"
+           "pwmscan (both-strand log-odds scan with the built-in PWM library, checks the planted binding sites):\n"
+           "  --min-score-fraction F  hit threshold within each motif's score range (default 0.8)\n"
+           "  --min-recovery R    fail when less than this share of planted sites is found\n"
+           "  --hits-bed FILE     write every hit as BED6 (score in bits) plus the covering region id and type\n"
+           "\n"
+           "fetch (regions written to stdout as FASTA):\n"
+           "  --fasta FILE        read an indexed FASTA (FILE.fai next to it)\n"
+           "  --socket PATH       ask a `genomorph serve` server\n"
+           "  --region R          chr, chr:start or chr:start-end (1-based, inclusive); repeatable\n"
+           "  without --fasta / --socket the regions are regenerated from --seed, --length / --config\n"
+           "\n"
+           "serve (generate-on-read: regions regenerated per request from the seed, nothing stored):\n"
+           "  --socket PATH       Unix socket to listen on; one request per line (see sequenceServer.hpp), stop with SIGINT\n"
+           "  --cache-mb M        cap of the packed block cache, 4 bases per byte (default 256, also for fetch)\n"
+           "\n"
+           "environment:\n"
+           "  GENOMORPH_ISA       force scalar | sse4.2 | avx2 | avx512 kernels (default: best the CPU supports)\n";
+}
+
+CliOptions parseArguments(int argc, char **argv) {
+
+    CliOptions options;
+    if (argc < 2) {
+        options.help = true;
+        return options;
+    }
+
+    options.command = argv[1];
+    if (options.command == "--help" || options.command == "-h") {
+        options.help = true;
+        return options;
+    }
+    if (options.command != "generate" && options.command != "stream" && options.command != "orfs" && options.command != "rnaseq"
+        && options.command != "motifs" && options.command != "pwmscan" && options.command != "fetch"
+        && options.command != "serve") {
+        throw std::invalid_argument("unknown command '" + options.command + "'");
+    }
+
+    for (int i = 2; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option == "--help" || option == "-h") {
+            options.help = true;
+            continue;
+        }
+        if (option == "--resume") {
+            options.resume = true;
+            continue;
+        }
+        if (option == "--proteins") {
+            options.proteins = true;
+            continue;
+        }
+        if (option == "--accessibility") {
+            options.accessibility = true;
+            continue;
+        }
+        if (option == "--direct") {
+            options.direct = true;
+            continue;
+        }
+        if (option == "--alloc-profile") {
+            options.allocProfile = true;
+            continue;
+        }
+        if (i + 1 >= argc) throw std::invalid_argument(option + " expects a value");
+        std::string value = argv[++i];
+
+        if (option == "--length") options.length = parseUnsigned(option, value);
+        else if (option == "--chromosomes") options.chromosomeCount = parseUnsigned(option, value);
+        else if (option == "--seed") options.seed = parseUnsigned(option, value);
+        else if (option == "--threads") options.threads = static_cast<unsigned>(parseUnsigned(option, value));
+        else if (option == "--format") options.format = value;
+        else if (option == "--line-width") options.lineWidth = parseUnsigned(option, value);
+        else if (option == "--annotations") options.annotations = value;
+        else if (option == "--out") options.out = value;
+        else if (option == "--config") options.configPath = value;
+        else if (option == "--name") options.sequenceName = value;
+        else if (option == "--chunk") options.chunkSize = parseUnsigned(option, value);
+        else if (option == "--checkpoint") options.checkpointPath = value;
+        else if (option == "--checkpoint-every") options.checkpointEvery = parseUnsigned(option, value);
+        else if (option == "--min-codons") options.minCodons = parseUnsigned(option, value);
+        else if (option == "--orf-bed") options.orfBedPath = value;
+        else if (option == "--reads") options.reads = parseUnsigned(option, value);
+        else if (option == "--read-length") options.readLength = parseUnsigned(option, value);
+        else if (option == "--expression-sigma") options.expressionSigma = parseDouble(option, value);
+        else if (option == "--error-rate") options.errorRate = parseDouble(option, value);
+        else if (option == "--motif") options.motifs.push_back(value);
+        else if (option == "--hits-bed") options.hitsBedPath = value;
+        else if (option == "--min-score-fraction") options.minScoreFraction = parseDouble(option, value);
+        else if (option == "--min-recovery") options.minRecovery = parseDouble(option, value);
+        else if (option == "--max-spurious-per-mbp") {
+            options.maxSpuriousPerMbp = parseDouble(option, value);
+            if (*options.maxSpuriousPerMbp < 0.0) throw std::invalid_argument("--max-spurious-per-mbp must not be negative");
+        }
+        else if (option == "--metrics") options.metricsFormat = value;
+        else if (option == "--metrics-out") options.metricsOut = value;
+        else if (option == "--io") options.io = value;
+        else if (option == "--io-depth") options.ioDepth = parseUnsigned(option, value);
+        else if (option == "--compress") options.compress = value;
+        else if (option == "--fasta") options.fastaPath = value;
+        else if (option == "--region") options.regions.push_back(value);
+        else if (option == "--socket") options.socketPath = value;
+        else if (option == "--cache-mb") options.cacheMb = parseUnsigned(option, value);
+        else if (option == "--max-memory") {
+            try {
+                options.maxMemory = parseByteSize(value);
+            } catch (const std::invalid_argument &error) {
+                throw std::invalid_argument("--max-memory " + std::string(error.what()));
+            }
+        }
+        else if (option == "--tmp-dir") options.tmpDir = value;
+        else if (option == "--compress-level") {
+            uint64_t level = parseUnsigned(option, value);
+            if (level > 9) throw std::invalid_argument("--compress-level must be within 0..9");
+            options.compressLevel = static_cast<int>(level);
+        }
+        else if (option == "--metrics-interval") {
+            options.metricsInterval = parseDouble(option, value);
+            if (options.metricsInterval < 0.0) throw std::invalid_argument("--metrics-interval must not be negative");
+        }
+        else throw std::invalid_argument("unknown option " + option);
+    }
+
+    if (options.maxMemory && options.command != "generate" && options.command != "stream" && options.command != "fetch"
+        && options.command != "serve") {
+        throw std::invalid_argument("--max-memory applies to generate, stream, fetch and serve; " + options.command
+                                    + " holds the whole genome in memory");
+    }
+    return options;
+}
+
+int runCli(int argc, char **argv) {
+
+    CliOptions options = parseArguments(argc, argv);
+    if (options.help) {
+        printUsage(std::cout);
+        return 0;
+    }
+    if (!options.allocProfile) return runCommand(options);
+
+    /**
+     * NOTE: allocations per base come from the bases_generated counter, so they need metrics compiled in as well
+     */
+    if (!AllocationProfile::enabled()) std::cerr << "genomorph: built without GENOMORPH_ALLOC_PROFILE, --alloc-profile reports nothing\n";
+    uint64_t basesBefore = Metrics::instance().total(Counter::bases_generated);
+    AllocationProfile::start();
+    int status = runCommand(options);
+    AllocationProfile::report(std::cerr, Metrics::instance().total(Counter::bases_generated) - basesBefore);
+    return status;
+}
@@ -0,0 +1,291 @@
+#include "config.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr const char *TYPE_NAMES[REGION_TYPE_COUNT] = {"coding", "non_coding", "regulatory", "repeat"};
+constexpr const char *REGULATORY_KIND_NAMES[3] = {"promoter", "enhancer", "silencer"};
+
+std::string trim(const std::string &text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+size_t typeIndex(const std::string &name, const std::string &where) {
+    for (size_t i = 0; i < REGION_TYPE_COUNT; ++i) {
+        if (name == TYPE_NAMES[i]) return i;
+    }
+    throw std::invalid_argument(where + ": unknown region type '" + name + "'");
+}
+
+double parseDouble(const std::string &value, const std::string &where) {
+    size_t used = 0;
+    double parsed = 0.0;
+    try {
+        parsed = std::stod(value, &used);
+    } catch (const std::exception &) {
+        used = 0;
+    }
+    if (used == 0 || used != value.size()) {
+        throw std::invalid_argument(where + ": expected a number, got '" + value + "'");
+    }
+    return parsed;
+}
+
+size_t parseSize(const std::string &value, const std::string &where) {
+    if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos) {
+        throw std::invalid_argument(where + ": expected a non-negative integer, got '" + value + "'");
+    }
+    return static_cast<size_t>(std::stoull(value));
+}
+
+/**
+ * @brief Parses "key:value, key:value" lists used by bins, transitions and chromosomes.
+ */
+std::vector<std::pair<std::string, std::string>> parsePairs(const std::string &value, const std::string &where) {
+    std::vector<std::pair<std::string, std::string>> pairs;
+    std::stringstream list(value);
+    std::string item;
+
+    while (std::getline(list, item, ',')) {
+        item = trim(item);
+        size_t colon = item.rfind(':');
+        if (colon == std::string::npos || colon == 0) {
+            throw std::invalid_argument(where + ": expected key:value, got '" + item + "'");
+        }
+        pairs.emplace_back(trim(item.substr(0, colon)), trim(item.substr(colon + 1)));
+    }
+    return pairs;
+}
+
+/**
+ * @brief Spec edited by a [length.<name>] section: a region type, intron or utr.
+ */
+LengthSpec &lengthSection(GenerationConfig &config, const std::string &name, const std::string &where) {
+    if (name == "intron") return config.genes.intron;
+    if (name == "utr") return config.genes.utr;
+    return config.lengths[typeIndex(name, where)];
+}
+
+std::vector<ChromosomeSpec> parseChromosomes(const std::string &value, const std::string &where) {
+    std::vector<ChromosomeSpec> chromosomes;
+    for (const auto &[name, length] : parsePairs(value, where)) {
+        chromosomes.push_back(ChromosomeSpec{name, parseSize(length, where)});
+    }
+    return chromosomes;
+}
+
+}
+
+const GenerationConfig& GenerationConfig::defaults() {
+    static const GenerationConfig config = [] {
+        GenerationConfig built;
+        built.finalize();
+        return built;
+    }();
+    return config;
+}
+
+GenerationConfig GenerationConfig::fromFile(const std::string &path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("cannot open config file " + path);
+    }
+    return parse(file, path);
+}
+
+GenerationConfig GenerationConfig::parse(std::istream &in, const std::string &sourceName) {
+
+    GenerationConfig config;
+    std::string section;
+    std::string line;
+    size_t lineNumber = 0;
+    bool sawComposition = false;
+    bool sawTransitions = false;
+
+    while (std::getline(in, line)) {
+        ++lineNumber;
+        std::string where = sourceName + ":" + std::to_string(lineNumber);
+
+        line = trim(line.substr(0, line.find_first_of("#;")));
+        if (line.empty()) continue;
+
+        if (line.front() == '[') {
+            if (line.back() != ']') throw std::invalid_argument(where + ": unterminated section header");
+            section = trim(line.substr(1, line.size() - 2));
+            continue;
+        }
+
+        size_t equals = line.find('=');
+        if (equals == std::string::npos) throw std::invalid_argument(where + ": expected key = value");
+        std::string key = trim(line.substr(0, equals));
+        std::string value = trim(line.substr(equals + 1));
+
+        if (section == "composition") {
+            config.composition[typeIndex(key, where)] = parseDouble(value, where);
+            sawComposition = true;
+        } else if (section == "transitions") {
+            auto &row = config.transitions[typeIndex(key, where)];
+            row.fill(0.0);
+            for (const auto &[target, weight] : parsePairs(value, where)) {
+                row[typeIndex(target, where)] = parseDouble(weight, where);
+            }
+            sawTransitions = true;
+        } else if (section == "gc") {
+            config.gcContent[typeIndex(key, where)] = parseDouble(value, where);
+        } else if (section == "cpg") {
+            config.cpgRatio[typeIndex(key, where)] = parseDouble(value, where);
+        } else if (section.rfind("length.", 0) == 0) {
+            LengthSpec &spec = lengthSection(config, section.substr(7), where);
+            if (key == "distribution") spec.model = parseLengthModel(value);
+            else if (key == "min") spec.min = parseSize(value, where);
+            else if (key == "max") spec.max = parseSize(value, where);
+            else if (key == "mean") spec.mean = parseDouble(value, where);
+            else if (key == "sigma") spec.sigma = parseDouble(value, where);
+            else if (key == "bins") {
+                spec.bins.clear();
+                for (const auto &[upper, weight] : parsePairs(value, where)) {
+                    spec.bins.push_back(HistogramBin{parseSize(upper, where), parseDouble(weight, where)});
+                }
+            }
+            else throw std::invalid_argument(where + ": unknown key '" + key + "' in [" + section + "]");
+        } else if (section == "genes" && key == "spliced") {
+            config.genes.splicedFraction = parseDouble(value, where);
+        } else if (section == "genes" && key == "exons") {
+            config.genes.meanExons = parseDouble(value, where);
+        } else if (section == "regulatory" && key == "motif_density") {
+            config.regulatory.motifDensity = parseDouble(value, where);
+        } else if (section == "regulatory" && key == "kinds") {
+            config.regulatory.kindWeights.fill(0.0);
+            for (const auto &[kind, weight] : parsePairs(value, where)) {
+                size_t k = std::find(std::begin(REGULATORY_KIND_NAMES), std::end(REGULATORY_KIND_NAMES), kind) - std::begin(REGULATORY_KIND_NAMES);
+                if (k == 3) throw std::invalid_argument(where + ": unknown regulatory kind '" + kind + "'");
+                config.regulatory.kindWeights[k] = parseDouble(weight, where);
+            }
+        } else if (section == "strand" && key == "plus_bias") {
+            config.plusStrandBias = parseDouble(value, where);
+        } else if (section == "genome" && key == "chromosomes") {
+            config.chromosomes = parseChromosomes(value, where);
+        } else {
+            throw std::invalid_argument(where + ": unknown key '" + key + "' in [" + section + "]");
+        }
+    }
+
+    config.transitionsFromComposition = sawComposition && !sawTransitions;
+
+    try {
+        config.finalize();
+    } catch (const std::invalid_argument &error) {
+        throw std::invalid_argument(sourceName + ": " + error.what());
+    }
+    return config;
+}
+
+uint64_t GenerationConfig::fingerprint() const {
+
+    /**
+     * NOTE: FNV-1a over the raw bytes of each value, in declaration order
+     */
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    auto mix = [&hash](const auto &value) {
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&value);
+        for (size_t i = 0; i < sizeof(value); ++i) {
+            hash ^= bytes[i];
+            hash *= 0x100000001B3ULL;
+        }
+    };
+
+    for (size_t i = 0; i < REGION_TYPE_COUNT; ++i) {
+        mix(composition[i]);
+        mix(gcContent[i]);
+        mix(cpgRatio[i]);
+        mix(lengths[i].model);
+        mix(lengths[i].min);
+        mix(lengths[i].max);
+        mix(lengths[i].mean);
+        mix(lengths[i].sigma);
+        for (const HistogramBin &bin : lengths[i].bins) {
+            mix(bin.upper);
+            mix(bin.weight);
+        }
+        for (double weight : transitions[i]) mix(weight);
+    }
+    mix(genes.splicedFraction);
+    mix(genes.meanExons);
+    for (const LengthSpec *spec : {&genes.intron, &genes.utr}) {
+        mix(spec->model);
+        mix(spec->min);
+        mix(spec->max);
+        mix(spec->mean);
+        mix(spec->sigma);
+        for (const HistogramBin &bin : spec->bins) {
+            mix(bin.upper);
+            mix(bin.weight);
+        }
+    }
+    mix(regulatory.motifDensity);
+    for (double weight : regulatory.kindWeights) mix(weight);
+    mix(plusStrandBias);
+    return hash;
+}
+
+void GenerationConfig::finalize() {
+
+    for (size_t i = 0; i < REGION_TYPE_COUNT; ++i) {
+        if (composition[i] < 0.0) throw std::invalid_argument(std::string("composition of ") + TYPE_NAMES[i] + " is negative");
+        if (gcContent[i] < 0.0 || gcContent[i] > 1.0) throw std::invalid_argument(std::string("gc of ") + TYPE_NAMES[i] + " is outside [0, 1]");
+        if (!(cpgRatio[i] >= 0.0 && cpgRatio[i] <= 4.0)) throw std::invalid_argument(std::string("cpg of ") + TYPE_NAMES[i] + " is outside [0, 4]");
+    }
+    if (plusStrandBias < 0.0 || plusStrandBias > 1.0) throw std::invalid_argument("plus_bias is outside [0, 1]");
+    if (!(genes.splicedFraction >= 0.0 && genes.splicedFraction <= 1.0)) throw std::invalid_argument("genes.spliced is outside [0, 1]");
+    if (!(genes.meanExons >= 2.0)) throw std::invalid_argument("genes.exons must be at least 2");
+    if (!(regulatory.motifDensity >= 0.0 && regulatory.motifDensity <= 100.0)) throw std::invalid_argument("regulatory.motif_density is outside [0, 100]");
+    if (genes.intron.min < 4) throw std::invalid_argument("length.intron: min must leave room for the GT and AG splice sites (4)");
+
+    try {
+        compositionTable = AliasTable(std::vector<double>(composition.begin(), composition.end()));
+    } catch (const std::invalid_argument &) {
+        throw std::invalid_argument("composition weights must not all be zero");
+    }
+
+    double total = 0.0;
+    for (double weight : composition) total += weight;
+    for (double &weight : composition) weight /= total;
+
+    for (size_t from = 0; from < REGION_TYPE_COUNT; ++from) {
+        if (transitionsFromComposition) transitions[from] = composition;
+        try {
+            transitionTables[from] = AliasTable(std::vector<double>(transitions[from].begin(), transitions[from].end()));
+        } catch (const std::invalid_argument &) {
+            throw std::invalid_argument(std::string("transitions from ") + TYPE_NAMES[from] + " need a positive weight");
+        }
+    }
+
+    for (size_t i = 0; i < REGION_TYPE_COUNT; ++i) {
+        try {
+            lengthDistributions[i] = LengthDistribution(lengths[i]);
+        } catch (const std::invalid_argument &error) {
+            throw std::invalid_argument(std::string("length.") + TYPE_NAMES[i] + ": " + error.what());
+        }
+    }
+    try {
+        intronLengths = LengthDistribution(genes.intron);
+    } catch (const std::invalid_argument &error) {
+        throw std::invalid_argument(std::string("length.intron: ") + error.what());
+    }
+    try {
+        utrLengths = LengthDistribution(genes.utr);
+    } catch (const std::invalid_argument &error) {
+        throw std::invalid_argument(std::string("length.utr: ") + error.what());
+    }
+    try {
+        regulatoryKindTable = AliasTable(std::vector<double>(regulatory.kindWeights.begin(), regulatory.kindWeights.end()));
+    } catch (const std::invalid_argument &) {
+        throw std::invalid_argument("regulatory.kinds need non-negative weights, not all zero");
+    }
+}
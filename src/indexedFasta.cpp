@@ -0,0 +1,178 @@
+#include "indexedFasta.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+uint64_t parseField(const std::string &field, const std::string &path, size_t line) {
+    if (field.empty() || !std::all_of(field.begin(), field.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        throw std::runtime_error(path + ":" + std::to_string(line) + ": malformed .fai field '" + field + "'");
+    }
+    return std::stoull(field);
+}
+
+/**
+ * @brief 1-based region coordinate; commas are allowed as thousands separators.
+ */
+uint64_t parseCoordinate(std::string text, const std::string &region) {
+    text.erase(std::remove(text.begin(), text.end(), ','), text.end());
+    if (text.empty() || !std::all_of(text.begin(), text.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+        throw std::invalid_argument("malformed region '" + region + "'");
+    }
+    return std::stoull(text);
+}
+
+}
+
+std::string faiLine(const FaiRecord &record) {
+    return record.name + '\t' + std::to_string(record.length) + '\t' + std::to_string(record.offset) + '\t'
+         + std::to_string(record.lineBases) + '\t' + std::to_string(record.lineWidth) + '\n';
+}
+
+FastaRegion parseRegion(const std::string &region, const std::function<std::optional<uint64_t>(const std::string &)> &lengthOf,
+                        const std::string &source) {
+
+    /**
+     * NOTE: a name containing ':' wins over the name:range reading, as in samtools
+     */
+    if (std::optional<uint64_t> length = lengthOf(region)) return FastaRegion{region, 0, *length};
+
+    size_t colon = region.rfind(':');
+    std::string name = region.substr(0, colon);
+    std::optional<uint64_t> length = colon == std::string::npos ? std::nullopt : lengthOf(name);
+    if (!length) throw std::invalid_argument("sequence '" + name + "' is not in " + source);
+    std::string range = region.substr(colon + 1);
+
+    size_t dash = range.find('-');
+    uint64_t first = parseCoordinate(range.substr(0, dash), region);
+    uint64_t last = dash == std::string::npos ? *length : parseCoordinate(range.substr(dash + 1), region);
+    if (first == 0 || first > last + 1) throw std::invalid_argument("malformed region '" + region + "'");
+
+    last = std::min(last, *length);
+    first = std::min(first, last + 1);
+    return FastaRegion{name, first - 1, last};
+}
+
+std::vector<FaiRecord> readFai(const std::string &path) {
+
+    std::ifstream file(path);
+    if (!file) throw std::runtime_error("cannot open FASTA index " + path);
+
+    std::vector<FaiRecord> records;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.empty()) continue;
+
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, '\t')) fields.push_back(field);
+        if (fields.size() < 5) throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": expected 5 tab-separated fields");
+
+        FaiRecord record;
+        record.name = fields[0];
+        record.length = parseField(fields[1], path, lineNumber);
+        record.offset = parseField(fields[2], path, lineNumber);
+        record.lineBases = parseField(fields[3], path, lineNumber);
+        record.lineWidth = parseField(fields[4], path, lineNumber);
+        if (record.lineBases == 0 || record.lineWidth <= record.lineBases) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": inconsistent line layout");
+        }
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+IndexedFasta::IndexedFasta(const std::string &path) : path(path), records(readFai(path + ".fai")) {
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) throw std::runtime_error("cannot open FASTA " + path + ": " + std::strerror(errno));
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("cannot open FASTA " + path + ": " + std::strerror(error));
+    }
+    size = static_cast<size_t>(info.st_size);
+    if (size != 0) {
+        void *mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapping == MAP_FAILED) {
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("cannot map FASTA " + path + ": " + std::strerror(error));
+        }
+        /**
+         * NOTE: fetches jump around the file, read-ahead would mostly load bases nobody asked for
+         */
+        ::madvise(mapping, size, MADV_RANDOM);
+        data = static_cast<const char *>(mapping);
+    }
+    ::close(fd);
+
+    if (size >= 2 && static_cast<unsigned char>(data[0]) == 0x1f && static_cast<unsigned char>(data[1]) == 0x8b) {
+        ::munmap(const_cast<char *>(data), size);
+        throw std::runtime_error(path + " is gzip / BGZF compressed, IndexedFasta needs the uncompressed FASTA");
+    }
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        const FaiRecord &entry = records[i];
+        uint64_t lastByte = entry.length == 0 ? entry.offset
+                          : entry.offset + (entry.length - 1) / entry.lineBases * entry.lineWidth + (entry.length - 1) % entry.lineBases + 1;
+        if (lastByte > size) {
+            if (data) ::munmap(const_cast<char *>(data), size);
+            throw std::runtime_error("FASTA index " + path + ".fai does not match the file (record " + entry.name + ")");
+        }
+        byName.emplace(entry.name, i);
+    }
+}
+
+IndexedFasta::~IndexedFasta() {
+    if (data) ::munmap(const_cast<char *>(data), size);
+}
+
+const FaiRecord& IndexedFasta::record(const std::string &name) const {
+    auto found = byName.find(name);
+    if (found == byName.end()) throw std::invalid_argument("sequence '" + name + "' is not in " + path);
+    return records[found->second];
+}
+
+std::string IndexedFasta::fetch(const std::string &name, uint64_t start, uint64_t end) const {
+
+    const FaiRecord &entry = record(name);
+    if (start > end || end > entry.length) {
+        throw std::invalid_argument("range " + std::to_string(start) + "-" + std::to_string(end) + " is outside " + name
+                                    + " (length " + std::to_string(entry.length) + ")");
+    }
+
+    std::string bases;
+    bases.reserve(end - start);
+    for (uint64_t position = start; position < end;) {
+        uint64_t column = position % entry.lineBases;
+        uint64_t take = std::min(end - position, entry.lineBases - column);
+        bases.append(data + entry.offset + position / entry.lineBases * entry.lineWidth + column, take);
+        position += take;
+    }
+    return bases;
+}
+
+std::string IndexedFasta::fetch(const std::string &region) const {
+
+    FastaRegion resolved = parseRegion(region, [this](const std::string &name) -> std::optional<uint64_t> {
+        auto found = byName.find(name);
+        if (found == byName.end()) return std::nullopt;
+        return records[found->second].length;
+    }, path);
+    return fetch(resolved.name, resolved.start, resolved.end);
+}
@@ -0,0 +1,230 @@
+#include "kernels.hpp"
+#include "baseCodes.hpp"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+
+inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+void xoshiroBlocks(uint64_t (*state)[KERNEL_RNG_LANES], uint64_t *out, size_t blocks) {
+
+    uint64_t s0[KERNEL_RNG_LANES], s1[KERNEL_RNG_LANES], s2[KERNEL_RNG_LANES], s3[KERNEL_RNG_LANES];
+    for (size_t lane = 0; lane < KERNEL_RNG_LANES; ++lane) {
+        s0[lane] = state[0][lane];
+        s1[lane] = state[1][lane];
+        s2[lane] = state[2][lane];
+        s3[lane] = state[3][lane];
+    }
+
+    for (size_t b = 0; b < blocks; ++b) {
+        uint64_t *block = out + b * KERNEL_RNG_LANES;
+        for (size_t lane = 0; lane < KERNEL_RNG_LANES; ++lane) {
+            block[lane] = rotl(s0[lane] + s3[lane], 23) + s0[lane];
+
+            uint64_t t = s1[lane] << 17;
+            s2[lane] ^= s0[lane];
+            s3[lane] ^= s1[lane];
+            s1[lane] ^= s2[lane];
+            s0[lane] ^= s3[lane];
+            s2[lane] ^= t;
+            s3[lane] = rotl(s3[lane], 45);
+        }
+    }
+
+    for (size_t lane = 0; lane < KERNEL_RNG_LANES; ++lane) {
+        state[0][lane] = s0[lane];
+        state[1][lane] = s1[lane];
+        state[2][lane] = s2[lane];
+        state[3][lane] = s3[lane];
+    }
+}
+
+void unpackCodes(const uint64_t *words, size_t count, uint8_t *out) {
+    for (size_t i = 0; i < count; ++i) out[i] = static_cast<uint8_t>((words[i / 32] >> (2 * (i % 32))) & 3);
+}
+
+void sampleBases(const uint8_t *random, size_t count, const SampleCutoffs &cutoffs, uint8_t *out) {
+    for (size_t i = 0; i < count; ++i) {
+        uint8_t slot = random[i];
+        uint8_t code = 0;
+        bool split = false;
+        for (size_t j = 0; j < 3; ++j) {
+            code += (slot >= cutoffs.cutoff[j]) & (cutoffs.active[j] != 0);
+            split = split || (cutoffs.straddles[j] && slot == cutoffs.split[j]);
+        }
+        out[i] = split ? SAMPLE_SPLIT : code;
+    }
+}
+
+void complementCodes(const uint8_t *in, size_t count, uint8_t *out) {
+    for (size_t i = 0; i < count; ++i) out[i] = static_cast<uint8_t>(3 - in[i]);
+}
+
+void reverseComplementCodes(const uint8_t *in, size_t count, uint8_t *out) {
+    for (size_t i = 0; i < count; ++i) out[i] = static_cast<uint8_t>(3 - in[count - 1 - i]);
+}
+
+size_t countGc(const uint8_t *codes, size_t count) {
+    size_t gc = 0;
+    for (size_t i = 0; i < count; ++i) gc += (codes[i] == 1) | (codes[i] == 2);
+    return gc;
+}
+
+void packCodes(const uint8_t *codes, size_t count, uint8_t *out) {
+    size_t whole = count / 4;
+    for (size_t i = 0; i < whole; ++i) {
+        const uint8_t *c = codes + 4 * i;
+        out[i] = static_cast<uint8_t>(c[0] | (c[1] << 2) | (c[2] << 4) | (c[3] << 6));
+    }
+    if (count % 4 != 0) {
+        uint8_t last = 0;
+        for (size_t j = 0; j < count % 4; ++j) last |= static_cast<uint8_t>(codes[4 * whole + j] << (2 * j));
+        out[whole] = last;
+    }
+}
+
+void bitPlanes(const uint8_t *codes, size_t count, uint64_t *high, uint64_t *low) {
+    for (size_t w = 0; w < (count + 63) / 64; ++w) {
+        uint64_t h = 0;
+        uint64_t l = 0;
+        size_t n = count - 64 * w < 64 ? count - 64 * w : 64;
+        for (size_t b = 0; b < n; ++b) {
+            h |= static_cast<uint64_t>(codes[64 * w + b] >> 1) << b;
+            l |= static_cast<uint64_t>(codes[64 * w + b] & 1) << b;
+        }
+        high[w] = h;
+        low[w] = l;
+    }
+}
+
+void translateCodons(const uint8_t *codes, size_t codons, const char *table, char *out) {
+    for (size_t i = 0; i < codons; ++i) out[i] = table[codonIndex(codes[3 * i], codes[3 * i + 1], codes[3 * i + 2])];
+}
+
+size_t shiftAnd(const uint8_t *codes, size_t count, const ShiftAndProgram &program, uint64_t *state, uint32_t *hits) {
+
+    uint64_t d[SHIFT_AND_LANES];
+    for (size_t lane = 0; lane < SHIFT_AND_LANES; ++lane) d[lane] = state[lane];
+
+    size_t found = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t *mask = program.masks[codes[i]];
+        uint64_t ended = 0;
+        for (size_t lane = 0; lane < SHIFT_AND_LANES; ++lane) {
+            d[lane] = ((d[lane] << 1) | program.initial[lane]) & mask[lane];
+            ended |= d[lane] & program.accept[lane];
+        }
+        hits[found] = static_cast<uint32_t>(i);
+        found += ended != 0;
+    }
+
+    for (size_t lane = 0; lane < SHIFT_AND_LANES; ++lane) state[lane] = d[lane];
+    return found;
+}
+
+size_t scoreWindows(const uint8_t *codes, size_t windows, const int8_t *columns, size_t width, int16_t threshold,
+                    uint32_t *hits, int16_t *scores) {
+    size_t found = 0;
+    for (size_t i = 0; i < windows; ++i) {
+        int score = 0;
+        for (size_t k = 0; k < width; ++k) score += columns[k * PWM_COLUMN_STRIDE + codes[i + k]];
+        hits[found] = static_cast<uint32_t>(i);
+        scores[found] = static_cast<int16_t>(score);
+        found += score >= threshold;
+    }
+    return found;
+}
+
+constexpr KernelTable SCALAR_KERNELS = {
+    Isa::scalar,
+    xoshiroBlocks,
+    unpackCodes,
+    sampleBases,
+    complementCodes,
+    reverseComplementCodes,
+    countGc,
+    packCodes,
+    bitPlanes,
+    translateCodons,
+    shiftAnd,
+    scoreWindows,
+};
+
+bool cpuSupports(Isa isa) {
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    switch (isa) {
+        case Isa::scalar:   return true;
+        case Isa::sse42:    return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("ssse3");
+        case Isa::avx2:     return __builtin_cpu_supports("avx2");
+        case Isa::avx512:   return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+    }
+    return false;
+#else
+    return isa == Isa::scalar;
+#endif
+}
+
+const KernelTable *best() {
+    for (Isa isa : {Isa::avx512, Isa::avx2, Isa::sse42}) {
+        if (const KernelTable *table = kernelsFor(isa)) return table;
+    }
+    return &SCALAR_KERNELS;
+}
+
+const KernelTable *select() {
+
+    const char *requested = std::getenv("GENOMORPH_ISA");
+    if (!requested || !*requested) return best();
+
+    std::string name = requested;
+    for (Isa isa : {Isa::scalar, Isa::sse42, Isa::avx2, Isa::avx512}) {
+        if (name != isaName(isa)) continue;
+        if (const KernelTable *table = kernelsFor(isa)) return table;
+
+        const KernelTable *fallback = best();
+        std::cerr << "genomorph: GENOMORPH_ISA=" << name << " is not supported here, using " << isaName(fallback->isa) << '\n';
+        return fallback;
+    }
+
+    const KernelTable *fallback = best();
+    std::cerr << "genomorph: unknown GENOMORPH_ISA '" << name << "' (expected scalar, sse4.2, avx2 or avx512), using "
+              << isaName(fallback->isa) << '\n';
+    return fallback;
+}
+
+}
+
+const KernelTable *kernelsFor(Isa isa) {
+    if (!cpuSupports(isa)) return nullptr;
+    switch (isa) {
+        case Isa::scalar:   return &SCALAR_KERNELS;
+        case Isa::sse42:    return sse42Kernels();
+        case Isa::avx2:     return avx2Kernels();
+        case Isa::avx512:   return avx512Kernels();
+    }
+    return nullptr;
+}
+
+const KernelTable &scalarKernels() {
+    return SCALAR_KERNELS;
+}
+
+const KernelTable &kernels() {
+    static const KernelTable *selected = select();
+    return *selected;
+}
+
+const char *isaName(Isa isa) {
+    switch (isa) {
+        case Isa::scalar:   return "scalar";
+        case Isa::sse42:    return "sse4.2";
+        case Isa::avx2:     return "avx2";
+        case Isa::avx512:   return "avx512";
+    }
+    return "scalar";
+}
@@ -0,0 +1,887 @@
+#include "kernels.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+#include <array>
+#include <immintrin.h>
+
+/**
+ * NOTE: GCC 12's AVX-512 intrinsic headers seed unused operands with a self-initialised __Y and trip -Wuninitialized
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+/**
+ * NOTE: every function below carries its own target attribute, so this file builds with the default (baseline x86-64)
+ * flags and the wider instructions only execute after kernels() confirmed them via CPUID.
+ */
+
+#define GENOMORPH_SSE42     __attribute__((target("sse4.2,ssse3")))
+#define GENOMORPH_AVX2      __attribute__((target("avx2")))
+#define GENOMORPH_AVX512    __attribute__((target("avx512f,avx512bw")))
+
+namespace {
+
+/**
+ * NOTE: UNPACK_NIBBLE -> a masked 2-bit field sits at bits 0-1 or 2-3 of a nibble; maps that nibble back to the code
+ */
+constexpr char UNPACK_NIBBLE[16] = {0, 1, 2, 3, 1, 0, 0, 0, 2, 0, 0, 0, 3, 0, 0, 0};
+
+/**
+ * NOTE: CODON_GATHER -> 16 codons span 48 bytes (three 16-byte registers); [position][register] shuffles base `position`
+ * of every codon out of one register, -1 where that base lives in another register, so OR-ing the three gives all 16.
+ */
+constexpr std::array<std::array<std::array<int8_t, 16>, 3>, 3> CODON_GATHER = [] {
+    std::array<std::array<std::array<int8_t, 16>, 3>, 3> gather {};
+    for (size_t position = 0; position < 3; ++position) {
+        for (size_t reg = 0; reg < 3; ++reg) {
+            for (size_t codon = 0; codon < 16; ++codon) {
+                size_t source = 3 * codon + position;
+                gather[position][reg][codon] = source / 16 == reg ? static_cast<int8_t>(source % 16) : int8_t{-1};
+            }
+        }
+    }
+    return gather;
+}();
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: SSE4.2 (16 bytes / 2 lanes per register)
+ * --------------------------------------------------------------
+ */
+
+namespace sse42 {
+
+GENOMORPH_SSE42 inline __m128i rotl(__m128i x, int k) {
+    return _mm_or_si128(_mm_slli_epi64(x, k), _mm_srli_epi64(x, 64 - k));
+}
+
+GENOMORPH_SSE42 void xoshiroBlocks(uint64_t (*state)[KERNEL_RNG_LANES], uint64_t *out, size_t blocks) {
+
+    constexpr size_t VECTORS = KERNEL_RNG_LANES / 2;
+    __m128i s[4][VECTORS];
+    for (size_t w = 0; w < 4; ++w) {
+        for (size_t v = 0; v < VECTORS; ++v) s[w][v] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(state[w] + 2 * v));
+    }
+
+    for (size_t b = 0; b < blocks; ++b) {
+        for (size_t v = 0; v < VECTORS; ++v) {
+            __m128i result = _mm_add_epi64(rotl(_mm_add_epi64(s[0][v], s[3][v]), 23), s[0][v]);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + b * KERNEL_RNG_LANES + 2 * v), result);
+
+            __m128i t = _mm_slli_epi64(s[1][v], 17);
+            s[2][v] = _mm_xor_si128(s[2][v], s[0][v]);
+            s[3][v] = _mm_xor_si128(s[3][v], s[1][v]);
+            s[1][v] = _mm_xor_si128(s[1][v], s[2][v]);
+            s[0][v] = _mm_xor_si128(s[0][v], s[3][v]);
+            s[2][v] = _mm_xor_si128(s[2][v], t);
+            s[3][v] = rotl(s[3][v], 45);
+        }
+    }
+
+    for (size_t w = 0; w < 4; ++w) {
+        for (size_t v = 0; v < VECTORS; ++v) _mm_storeu_si128(reinterpret_cast<__m128i *>(state[w] + 2 * v), s[w][v]);
+    }
+}
+
+/**
+ * @brief Each byte holds one code's source byte; keeps the byte's own 2-bit field (position i % 4) and decodes it.
+ */
+GENOMORPH_SSE42 inline __m128i expandFields(__m128i bytes) {
+    const __m128i fields = _mm_set1_epi32(static_cast<int>(0xC0300C03));
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i lookup = _mm_loadu_si128(reinterpret_cast<const __m128i *>(UNPACK_NIBBLE));
+
+    __m128i masked = _mm_and_si128(bytes, fields);
+    __m128i low = _mm_shuffle_epi8(lookup, _mm_and_si128(masked, nibble));
+    __m128i high = _mm_shuffle_epi8(lookup, _mm_and_si128(_mm_srli_epi16(masked, 4), nibble));
+    return _mm_add_epi8(low, high);
+}
+
+GENOMORPH_SSE42 void unpackCodes(const uint64_t *words, size_t count, uint8_t *out) {
+
+    const __m128i spreadLow = _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+    const __m128i spreadHigh = _mm_setr_epi8(4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+
+    size_t w = 0;
+    for (; (w + 1) * 32 <= count; ++w) {
+        __m128i word = _mm_cvtsi64_si128(static_cast<long long>(words[w]));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 32 * w), expandFields(_mm_shuffle_epi8(word, spreadLow)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 32 * w + 16), expandFields(_mm_shuffle_epi8(word, spreadHigh)));
+    }
+    if (w * 32 < count) scalarKernels().unpackCodes(words + w, count - w * 32, out + w * 32);
+}
+
+GENOMORPH_SSE42 void sampleBases(const uint8_t *random, size_t count, const SampleCutoffs &cutoffs, uint8_t *out) {
+
+    __m128i cutoff[3], active[3], split[3], straddles[3];
+    for (size_t j = 0; j < 3; ++j) {
+        cutoff[j] = _mm_set1_epi8(static_cast<char>(cutoffs.cutoff[j]));
+        active[j] = _mm_set1_epi8(static_cast<char>(cutoffs.active[j]));
+        split[j] = _mm_set1_epi8(static_cast<char>(cutoffs.split[j]));
+        straddles[j] = _mm_set1_epi8(static_cast<char>(cutoffs.straddles[j]));
+    }
+
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i slot = _mm_loadu_si128(reinterpret_cast<const __m128i *>(random + i));
+        __m128i code = _mm_setzero_si128();
+        __m128i isSplit = _mm_setzero_si128();
+        for (size_t j = 0; j < 3; ++j) {
+            __m128i atLeast = _mm_and_si128(_mm_cmpeq_epi8(_mm_max_epu8(slot, cutoff[j]), slot), active[j]);
+            code = _mm_sub_epi8(code, atLeast);
+            isSplit = _mm_or_si128(isSplit, _mm_and_si128(_mm_cmpeq_epi8(slot, split[j]), straddles[j]));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_or_si128(code, isSplit));
+    }
+    if (i < count) scalarKernels().sampleBases(random + i, count - i, cutoffs, out + i);
+}
+
+GENOMORPH_SSE42 void complementCodes(const uint8_t *in, size_t count, uint8_t *out) {
+
+    const __m128i three = _mm_set1_epi8(3);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i codes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_sub_epi8(three, codes));
+    }
+    if (i < count) scalarKernels().complementCodes(in + i, count - i, out + i);
+}
+
+GENOMORPH_SSE42 void reverseComplementCodes(const uint8_t *in, size_t count, uint8_t *out) {
+
+    const __m128i three = _mm_set1_epi8(3);
+    const __m128i reverse = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i codes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + count - i - 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_sub_epi8(three, _mm_shuffle_epi8(codes, reverse)));
+    }
+    if (i < count) scalarKernels().reverseComplementCodes(in, count - i, out + i);
+}
+
+GENOMORPH_SSE42 size_t countGc(const uint8_t *codes, size_t count) {
+
+    const __m128i one = _mm_set1_epi8(1);
+    const __m128i two = _mm_set1_epi8(2);
+    __m128i total = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(codes + i));
+        __m128i gc = _mm_and_si128(_mm_or_si128(_mm_cmpeq_epi8(c, one), _mm_cmpeq_epi8(c, two)), one);
+        total = _mm_add_epi64(total, _mm_sad_epu8(gc, _mm_setzero_si128()));
+    }
+    size_t gc = static_cast<size_t>(_mm_cvtsi128_si64(total)) + static_cast<size_t>(_mm_extract_epi64(total, 1));
+    return gc + scalarKernels().countGc(codes + i, count - i);
+}
+
+/**
+ * NOTE: PACKING -> in each 32-bit group of four codes, v | v >> 6 then | >> 12 leaves c0 | c1 << 2 | c2 << 4 | c3 << 6
+ * in the group's low byte; the low bytes are then gathered.
+ */
+GENOMORPH_SSE42 void packCodes(const uint8_t *codes, size_t count, uint8_t *out) {
+
+    const __m128i gather = _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(codes + i));
+        v = _mm_or_si128(v, _mm_srli_epi32(v, 6));
+        v = _mm_or_si128(v, _mm_srli_epi32(v, 12));
+        int packed = _mm_cvtsi128_si32(_mm_shuffle_epi8(v, gather));
+        __builtin_memcpy(out + i / 4, &packed, 4);
+    }
+    if (i < count) scalarKernels().packCodes(codes + i, count - i, out + i / 4);
+}
+
+/**
+ * NOTE: BIT PLANES -> a 16-bit shift by 6 (7) moves bit 1 (0) of every byte into its sign bit, which movemask collects
+ */
+GENOMORPH_SSE42 void bitPlanes(const uint8_t *codes, size_t count, uint64_t *high, uint64_t *low) {
+
+    size_t w = 0;
+    for (; 64 * (w + 1) <= count; ++w) {
+        uint64_t h = 0;
+        uint64_t l = 0;
+        for (size_t part = 0; part < 4; ++part) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(codes + 64 * w + 16 * part));
+            h |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_slli_epi16(v, 6)))) << (16 * part);
+            l |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(_mm_slli_epi16(v, 7)))) << (16 * part);
+        }
+        high[w] = h;
+        low[w] = l;
+    }
+    if (64 * w < count) scalarKernels().bitPlanes(codes + 64 * w, count - 64 * w, high + w, low + w);
+}
+
+GENOMORPH_SSE42 inline __m128i codonBases(const __m128i (&bytes)[3], size_t position) {
+    __m128i bases = _mm_setzero_si128();
+    for (size_t reg = 0; reg < 3; ++reg) {
+        __m128i gather = _mm_loadu_si128(reinterpret_cast<const __m128i *>(CODON_GATHER[position][reg].data()));
+        bases = _mm_or_si128(bases, _mm_shuffle_epi8(bytes[reg], gather));
+    }
+    return bases;
+}
+
+/**
+ * NOTE: 64-entry lookup -> the first base picks one of four 16-entry shuffles indexed by the other two bases
+ */
+GENOMORPH_SSE42 void translateCodons(const uint8_t *codes, size_t codons, const char *table, char *out) {
+
+    __m128i quarter[4];
+    for (size_t q = 0; q < 4; ++q) quarter[q] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(table + 16 * q));
+
+    size_t i = 0;
+    for (; i + 16 <= codons; i += 16) {
+        __m128i bytes[3];
+        for (size_t reg = 0; reg < 3; ++reg) bytes[reg] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(codes + 3 * i + 16 * reg));
+
+        __m128i first = codonBases(bytes, 0);
+        __m128i rest = _mm_or_si128(_mm_slli_epi16(codonBases(bytes, 1), 2), codonBases(bytes, 2));
+        __m128i residues = _mm_setzero_si128();
+        for (size_t q = 0; q < 4; ++q) {
+            __m128i selected = _mm_cmpeq_epi8(first, _mm_set1_epi8(static_cast<char>(q)));
+            residues = _mm_or_si128(residues, _mm_and_si128(selected, _mm_shuffle_epi8(quarter[q], rest)));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), residues);
+    }
+    if (i < codons) scalarKernels().translateCodons(codes + 3 * i, codons - i, table, out + i);
+}
+
+/**
+ * NOTE: the automaton is one serial chain per base, so the lanes are spread over registers and hits are stored
+ * branch-free (the slot is overwritten unless the count advances)
+ */
+GENOMORPH_SSE42 size_t shiftAnd(const uint8_t *codes, size_t count, const ShiftAndProgram &program, uint64_t *state, uint32_t *hits) {
+
+    constexpr size_t REGS = SHIFT_AND_LANES / 2;
+    __m128i d[REGS], initial[REGS], accept[REGS];
+    for (size_t r = 0; r < REGS; ++r) {
+        d[r] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(state + 2 * r));
+        initial[r] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(program.initial + 2 * r));
+        accept[r] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(program.accept + 2 * r));
+    }
+
+    size_t found = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t *mask = program.masks[codes[i]];
+        __m128i ended = _mm_setzero_si128();
+        for (size_t r = 0; r < REGS; ++r) {
+            __m128i m = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mask + 2 * r));
+            d[r] = _mm_and_si128(_mm_or_si128(_mm_slli_epi64(d[r], 1), initial[r]), m);
+            ended = _mm_or_si128(ended, _mm_and_si128(d[r], accept[r]));
+        }
+        hits[found] = static_cast<uint32_t>(i);
+        found += !_mm_testz_si128(ended, ended);
+    }
+
+    for (size_t r = 0; r < REGS; ++r) _mm_storeu_si128(reinterpret_cast<__m128i *>(state + 2 * r), d[r]);
+    return found;
+}
+
+/**
+ * NOTE: PWM scoring runs 16 windows per register: column k is a pshufb table indexed by the codes at offset k, the
+ * int8 scores are widened and summed in int16; hit positions come out of the compare mask
+ */
+GENOMORPH_SSE42 size_t scoreWindows(const uint8_t *codes, size_t windows, const int8_t *columns, size_t width, int16_t threshold,
+                                    uint32_t *hits, int16_t *scores) {
+
+    __m128i limit = _mm_set1_epi16(static_cast<int16_t>(threshold - 1));
+    size_t found = 0;
+    size_t i = 0;
+    for (; i + 16 <= windows; i += 16) {
+        __m128i low = _mm_setzero_si128();
+        __m128i high = _mm_setzero_si128();
+        for (size_t k = 0; k < width; ++k) {
+            __m128i column = _mm_loadu_si128(reinterpret_cast<const __m128i *>(columns + k * PWM_COLUMN_STRIDE));
+            __m128i s = _mm_shuffle_epi8(column, _mm_loadu_si128(reinterpret_cast<const __m128i *>(codes + i + k)));
+            low = _mm_add_epi16(low, _mm_cvtepi8_epi16(s));
+            high = _mm_add_epi16(high, _mm_cvtepi8_epi16(_mm_srli_si128(s, 8)));
+        }
+
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_packs_epi16(_mm_cmpgt_epi16(low, limit), _mm_cmpgt_epi16(high, limit))));
+        if (!mask) continue;
+        alignas(16) int16_t lane[16];
+        _mm_store_si128(reinterpret_cast<__m128i *>(lane), low);
+        _mm_store_si128(reinterpret_cast<__m128i *>(lane + 8), high);
+        for (; mask; mask &= mask - 1) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            hits[found] = static_cast<uint32_t>(i + bit);
+            scores[found++] = lane[bit];
+        }
+    }
+
+    if (i < windows) {
+        size_t tail = scalarKernels().scoreWindows(codes + i, windows - i, columns, width, threshold, hits + found, scores + found);
+        for (size_t h = found; h < found + tail; ++h) hits[h] += static_cast<uint32_t>(i);
+        found += tail;
+    }
+    return found;
+}
+
+}
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: AVX2 (32 bytes / 4 lanes per register)
+ * --------------------------------------------------------------
+ */
+
+namespace avx2 {
+
+GENOMORPH_AVX2 inline __m256i rotl(__m256i x, int k) {
+    return _mm256_or_si256(_mm256_slli_epi64(x, k), _mm256_srli_epi64(x, 64 - k));
+}
+
+GENOMORPH_AVX2 void xoshiroBlocks(uint64_t (*state)[KERNEL_RNG_LANES], uint64_t *out, size_t blocks) {
+
+    constexpr size_t VECTORS = KERNEL_RNG_LANES / 4;
+    __m256i s[4][VECTORS];
+    for (size_t w = 0; w < 4; ++w) {
+        for (size_t v = 0; v < VECTORS; ++v) s[w][v] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state[w] + 4 * v));
+    }
+
+    for (size_t b = 0; b < blocks; ++b) {
+        for (size_t v = 0; v < VECTORS; ++v) {
+            __m256i result = _mm256_add_epi64(rotl(_mm256_add_epi64(s[0][v], s[3][v]), 23), s[0][v]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + b * KERNEL_RNG_LANES + 4 * v), result);
+
+            __m256i t = _mm256_slli_epi64(s[1][v], 17);
+            s[2][v] = _mm256_xor_si256(s[2][v], s[0][v]);
+            s[3][v] = _mm256_xor_si256(s[3][v], s[1][v]);
+            s[1][v] = _mm256_xor_si256(s[1][v], s[2][v]);
+            s[0][v] = _mm256_xor_si256(s[0][v], s[3][v]);
+            s[2][v] = _mm256_xor_si256(s[2][v], t);
+            s[3][v] = rotl(s[3][v], 45);
+        }
+    }
+
+    for (size_t w = 0; w < 4; ++w) {
+        for (size_t v = 0; v < VECTORS; ++v) _mm256_storeu_si256(reinterpret_cast<__m256i *>(state[w] + 4 * v), s[w][v]);
+    }
+}
+
+GENOMORPH_AVX2 void unpackCodes(const uint64_t *words, size_t count, uint8_t *out) {
+
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                            4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+    const __m256i fields = _mm256_set1_epi32(static_cast<int>(0xC0300C03));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i lookup = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(UNPACK_NIBBLE)));
+
+    size_t w = 0;
+    for (; (w + 1) * 32 <= count; ++w) {
+        __m256i bytes = _mm256_shuffle_epi8(_mm256_set1_epi64x(static_cast<long long>(words[w])), spread);
+        __m256i masked = _mm256_and_si256(bytes, fields);
+        __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(masked, nibble));
+        __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(masked, 4), nibble));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 32 * w), _mm256_add_epi8(low, high));
+    }
+    if (w * 32 < count) scalarKernels().unpackCodes(words + w, count - w * 32, out + w * 32);
+}
+
+GENOMORPH_AVX2 void sampleBases(const uint8_t *random, size_t count, const SampleCutoffs &cutoffs, uint8_t *out) {
+
+    __m256i cutoff[3], active[3], split[3], straddles[3];
+    for (size_t j = 0; j < 3; ++j) {
+        cutoff[j] = _mm256_set1_epi8(static_cast<char>(cutoffs.cutoff[j]));
+        active[j] = _mm256_set1_epi8(static_cast<char>(cutoffs.active[j]));
+        split[j] = _mm256_set1_epi8(static_cast<char>(cutoffs.split[j]));
+        straddles[j] = _mm256_set1_epi8(static_cast<char>(cutoffs.straddles[j]));
+    }
+
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i slot = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(random + i));
+        __m256i code = _mm256_setzero_si256();
+        __m256i isSplit = _mm256_setzero_si256();
+        for (size_t j = 0; j < 3; ++j) {
+            __m256i atLeast = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(slot, cutoff[j]), slot), active[j]);
+            code = _mm256_sub_epi8(code, atLeast);
+            isSplit = _mm256_or_si256(isSplit, _mm256_and_si256(_mm256_cmpeq_epi8(slot, split[j]), straddles[j]));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_or_si256(code, isSplit));
+    }
+    if (i < count) scalarKernels().sampleBases(random + i, count - i, cutoffs, out + i);
+}
+
+GENOMORPH_AVX2 void complementCodes(const uint8_t *in, size_t count, uint8_t *out) {
+
+    const __m256i three = _mm256_set1_epi8(3);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i codes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_sub_epi8(three, codes));
+    }
+    if (i < count) scalarKernels().complementCodes(in + i, count - i, out + i);
+}
+
+GENOMORPH_AVX2 void reverseComplementCodes(const uint8_t *in, size_t count, uint8_t *out) {
+
+    const __m256i three = _mm256_set1_epi8(3);
+    const __m256i reverse = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                             15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i codes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + count - i - 32));
+        __m256i reversed = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(codes, reverse), 0x4E);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), _mm256_sub_epi8(three, reversed));
+    }
+    if (i < count) scalarKernels().reverseComplementCodes(in, count - i, out + i);
+}
+
+GENOMORPH_AVX2 size_t countGc(const uint8_t *codes, size_t count) {
+
+    const __m256i one = _mm256_set1_epi8(1);
+    const __m256i two = _mm256_set1_epi8(2);
+    __m256i total = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(codes + i));
+        __m256i gc = _mm256_and_si256(_mm256_or_si256(_mm256_cmpeq_epi8(c, one), _mm256_cmpeq_epi8(c, two)), one);
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(gc, _mm256_setzero_si256()));
+    }
+    size_t gc = static_cast<size_t>(_mm256_extract_epi64(total, 0)) + static_cast<size_t>(_mm256_extract_epi64(total, 1))
+              + static_cast<size_t>(_mm256_extract_epi64(total, 2)) + static_cast<size_t>(_mm256_extract_epi64(total, 3));
+    return gc + scalarKernels().countGc(codes + i, count - i);
+}
+
+GENOMORPH_AVX2 void packCodes(const uint8_t *codes, size_t count, uint8_t *out) {
+
+    const __m256i gather = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                            0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m256i lanes = _mm256_setr_epi32(0, 4, 1, 1, 1, 1, 1, 1);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(codes + i));
+        v = _mm256_or_si256(v, _mm256_srli_epi32(v, 6));
+        v = _mm256_or_si256(v, _mm256_srli_epi32(v, 12));
+        v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, gather), lanes);
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i / 4), _mm256_castsi256_si128(v));
+    }
+    if (i < count) scalarKernels().packCodes(codes + i, count - i, out + i / 4);
+}
+
+GENOMORPH_AVX2 void bitPlanes(const uint8_t *codes, size_t count, uint64_t *high, uint64_t *low) {
+
+    size_t w = 0;
+    for (; 64 * (w + 1) <= count; ++w) {
+        __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(codes + 64 * w));
+        __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(codes + 64 * w + 32));
+        high[w] = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(first, 6)))
+                | static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(second, 6)))) << 32;
+        low[w] = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(first, 7)))
+               | static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_slli_epi16(second, 7)))) << 32;
+    }
+    if (64 * w < count) scalarKernels().bitPlanes(codes + 64 * w, count - 64 * w, high + w, low + w);
+}
+
+GENOMORPH_AVX2 inline __m256i codonBases(const __m256i (&bytes)[3], size_t position) {
+    __m256i bases = _mm256_setzero_si256();
+    for (size_t reg = 0; reg < 3; ++reg) {
+        __m256i gather = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(CODON_GATHER[position][reg].data())));
+        bases = _mm256_or_si256(bases, _mm256_shuffle_epi8(bytes[reg], gather));
+    }
+    return bases;
+}
+
+/**
+ * NOTE: shuffles stay within 128-bit lanes, so each lane gets its own 48-byte group of 16 codons
+ */
+GENOMORPH_AVX2 void translateCodons(const uint8_t *codes, size_t codons, const char *table, char *out) {
+
+    __m256i quarter[4];
+    for (size_t q = 0; q < 4; ++q) {
+        quarter[q] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(table + 16 * q)));
+    }
+
+    size_t i = 0;
+    for (; i + 32 <= codons; i += 32) {
+        __m256i bytes[3];
+        for (size_t reg = 0; reg < 3; ++reg) {
+            const uint8_t *group = codes + 3 * i + 16 * reg;
+            bytes[reg] = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(group))),
+                                                 _mm_loadu_si128(reinterpret_cast<const __m128i *>(group + 48)), 1);
+        }
+
+        __m256i first = codonBases(bytes, 0);
+        __m256i rest = _mm256_or_si256(_mm256_slli_epi16(codonBases(bytes, 1), 2), codonBases(bytes, 2));
+        __m256i residues = _mm256_setzero_si256();
+        for (size_t q = 0; q < 4; ++q) {
+            __m256i selected = _mm256_cmpeq_epi8(first, _mm256_set1_epi8(static_cast<char>(q)));
+            residues = _mm256_or_si256(residues, _mm256_and_si256(selected, _mm256_shuffle_epi8(quarter[q], rest)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), residues);
+    }
+    if (i < codons) sse42::translateCodons(codes + 3 * i, codons - i, table, out + i);
+}
+
+GENOMORPH_AVX2 size_t shiftAnd(const uint8_t *codes, size_t count, const ShiftAndProgram &program, uint64_t *state, uint32_t *hits) {
+
+    constexpr size_t REGS = SHIFT_AND_LANES / 4;
+    __m256i d[REGS], initial[REGS], accept[REGS];
+    for (size_t r = 0; r < REGS; ++r) {
+        d[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(state + 4 * r));
+        initial[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(program.initial + 4 * r));
+        accept[r] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(program.accept + 4 * r));
+    }
+
+    size_t found = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const uint64_t *mask = program.masks[codes[i]];
+        __m256i ended = _mm256_setzero_si256();
+        for (size_t r = 0; r < REGS; ++r) {
+            __m256i m = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(mask + 4 * r));
+            d[r] = _mm256_and_si256(_mm256_or_si256(_mm256_slli_epi64(d[r], 1), initial[r]), m);
+            ended = _mm256_or_si256(ended, _mm256_and_si256(d[r], accept[r]));
+        }
+        hits[found] = static_cast<uint32_t>(i);
+        found += !_mm256_testz_si256(ended, ended);
+    }
+
+    for (size_t r = 0; r < REGS; ++r) _mm256_storeu_si256(reinterpret_cast<__m256i *>(state + 4 * r), d[r]);
+    return found;
+}
+
+/**
+ * NOTE: pshufb works per 128-bit lane, so every column is broadcast to both lanes
+ */
+GENOMORPH_AVX2 size_t scoreWindows(const uint8_t *codes, size_t windows, const int8_t *columns, size_t width, int16_t threshold,
+                                   uint32_t *hits, int16_t *scores) {
+
+    __m256i limit = _mm256_set1_epi16(static_cast<int16_t>(threshold - 1));
+    size_t found = 0;
+    size_t i = 0;
+    for (; i + 32 <= windows; i += 32) {
+        __m256i low = _mm256_setzero_si256();
+        __m256i high = _mm256_setzero_si256();
+        for (size_t k = 0; k < width; ++k) {
+            __m256i column = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i *>(columns + k * PWM_COLUMN_STRIDE)));
+            __m256i s = _mm256_shuffle_epi8(column, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(codes + i + k)));
+            low = _mm256_add_epi16(low, _mm256_cvtepi8_epi16(_mm256_castsi256_si128(s)));
+            high = _mm256_add_epi16(high, _mm256_cvtepi8_epi16(_mm256_extracti128_si256(s, 1)));
+        }
+
+        /**
+         * NOTE: packs interleaves 128-bit lanes, the permute restores window order before the byte mask is taken
+         */
+        __m256i passed = _mm256_permute4x64_epi64(_mm256_packs_epi16(_mm256_cmpgt_epi16(low, limit), _mm256_cmpgt_epi16(high, limit)), 0xD8);
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(passed));
+        if (!mask) continue;
+        alignas(32) int16_t lane[32];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lane), low);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(lane + 16), high);
+        for (; mask; mask &= mask - 1) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctz(mask));
+            hits[found] = static_cast<uint32_t>(i + bit);
+            scores[found++] = lane[bit];
+        }
+    }
+
+    if (i < windows) {
+        size_t tail = sse42::scoreWindows(codes + i, windows - i, columns, width, threshold, hits + found, scores + found);
+        for (size_t h = found; h < found + tail; ++h) hits[h] += static_cast<uint32_t>(i);
+        found += tail;
+    }
+    return found;
+}
+
+}
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: AVX-512 F + BW (64 bytes / 8 lanes per register)
+ * --------------------------------------------------------------
+ */
+
+namespace avx512 {
+
+GENOMORPH_AVX512 void xoshiroBlocks(uint64_t (*state)[KERNEL_RNG_LANES], uint64_t *out, size_t blocks) {
+
+    static_assert(KERNEL_RNG_LANES == 8, "one 512-bit register holds all lanes");
+    __m512i s0 = _mm512_loadu_si512(state[0]);
+    __m512i s1 = _mm512_loadu_si512(state[1]);
+    __m512i s2 = _mm512_loadu_si512(state[2]);
+    __m512i s3 = _mm512_loadu_si512(state[3]);
+
+    for (size_t b = 0; b < blocks; ++b) {
+        _mm512_storeu_si512(out + b * KERNEL_RNG_LANES, _mm512_add_epi64(_mm512_rol_epi64(_mm512_add_epi64(s0, s3), 23), s0));
+
+        __m512i t = _mm512_slli_epi64(s1, 17);
+        s2 = _mm512_xor_si512(s2, s0);
+        s3 = _mm512_xor_si512(s3, s1);
+        s1 = _mm512_xor_si512(s1, s2);
+        s0 = _mm512_xor_si512(s0, s3);
+        s2 = _mm512_xor_si512(s2, t);
+        s3 = _mm512_rol_epi64(s3, 45);
+    }
+
+    _mm512_storeu_si512(state[0], s0);
+    _mm512_storeu_si512(state[1], s1);
+    _mm512_storeu_si512(state[2], s2);
+    _mm512_storeu_si512(state[3], s3);
+}
+
+GENOMORPH_AVX512 void unpackCodes(const uint64_t *words, size_t count, uint8_t *out) {
+
+    const __m512i spread = _mm512_broadcast_i32x4(_mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3));
+    const __m512i quarter = _mm512_setr_epi64(0, 0, 0x0404040404040404LL, 0x0404040404040404LL,
+                                              0x0808080808080808LL, 0x0808080808080808LL, 0x0C0C0C0C0C0C0C0CLL, 0x0C0C0C0C0C0C0C0CLL);
+    const __m512i fields = _mm512_set1_epi32(static_cast<int>(0xC0300C03));
+    const __m512i nibble = _mm512_set1_epi8(0x0F);
+    const __m512i lookup = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(UNPACK_NIBBLE)));
+
+    size_t w = 0;
+    for (; (w + 2) * 32 <= count; w += 2) {
+        __m512i pair = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(words + w)));
+        __m512i bytes = _mm512_shuffle_epi8(pair, _mm512_add_epi8(spread, quarter));
+        __m512i masked = _mm512_and_si512(bytes, fields);
+        __m512i low = _mm512_shuffle_epi8(lookup, _mm512_and_si512(masked, nibble));
+        __m512i high = _mm512_shuffle_epi8(lookup, _mm512_and_si512(_mm512_srli_epi16(masked, 4), nibble));
+        _mm512_storeu_si512(out + 32 * w, _mm512_add_epi8(low, high));
+    }
+    if (w * 32 < count) avx2::unpackCodes(words + w, count - w * 32, out + w * 32);
+}
+
+GENOMORPH_AVX512 void sampleBases(const uint8_t *random, size_t count, const SampleCutoffs &cutoffs, uint8_t *out) {
+
+    __m512i cutoff[3], split[3];
+    __mmask64 active[3], straddles[3];
+    for (size_t j = 0; j < 3; ++j) {
+        cutoff[j] = _mm512_set1_epi8(static_cast<char>(cutoffs.cutoff[j]));
+        split[j] = _mm512_set1_epi8(static_cast<char>(cutoffs.split[j]));
+        active[j] = cutoffs.active[j] ? ~__mmask64{0} : 0;
+        straddles[j] = cutoffs.straddles[j] ? ~__mmask64{0} : 0;
+    }
+
+    const __m512i one = _mm512_set1_epi8(1);
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        __m512i slot = _mm512_loadu_si512(random + i);
+        __m512i code = _mm512_setzero_si512();
+        __mmask64 isSplit = 0;
+        for (size_t j = 0; j < 3; ++j) {
+            code = _mm512_mask_add_epi8(code, _mm512_cmpge_epu8_mask(slot, cutoff[j]) & active[j], code, one);
+            isSplit |= _mm512_cmpeq_epi8_mask(slot, split[j]) & straddles[j];
+        }
+        _mm512_storeu_si512(out + i, _mm512_mask_set1_epi8(code, isSplit, static_cast<char>(SAMPLE_SPLIT)));
+    }
+    if (i < count) avx2::sampleBases(random + i, count - i, cutoffs, out + i);
+}
+
+GENOMORPH_AVX512 void complementCodes(const uint8_t *in, size_t count, uint8_t *out) {
+
+    const __m512i three = _mm512_set1_epi8(3);
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        _mm512_storeu_si512(out + i, _mm512_sub_epi8(three, _mm512_loadu_si512(in + i)));
+    }
+    if (i < count) avx2::complementCodes(in + i, count - i, out + i);
+}
+
+GENOMORPH_AVX512 void reverseComplementCodes(const uint8_t *in, size_t count, uint8_t *out) {
+
+    const __m512i three = _mm512_set1_epi8(3);
+    const __m512i reverse = _mm512_broadcast_i32x4(_mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0));
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        __m512i codes = _mm512_loadu_si512(in + count - i - 64);
+        __m512i reversed = _mm512_shuffle_i64x2(_mm512_shuffle_epi8(codes, reverse), _mm512_shuffle_epi8(codes, reverse), 0x1B);
+        _mm512_storeu_si512(out + i, _mm512_sub_epi8(three, reversed));
+    }
+    if (i < count) avx2::reverseComplementCodes(in, count - i, out + i);
+}
+
+GENOMORPH_AVX512 size_t countGc(const uint8_t *codes, size_t count) {
+
+    const __m512i one = _mm512_set1_epi8(1);
+    const __m512i two = _mm512_set1_epi8(2);
+    size_t gc = 0;
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        __m512i c = _mm512_loadu_si512(codes + i);
+        gc += static_cast<size_t>(__builtin_popcountll(_mm512_cmpeq_epi8_mask(c, one) | _mm512_cmpeq_epi8_mask(c, two)));
+    }
+    return gc + avx2::countGc(codes + i, count - i);
+}
+
+GENOMORPH_AVX512 void packCodes(const uint8_t *codes, size_t count, uint8_t *out) {
+
+    size_t i = 0;
+    for (; i + 64 <= count; i += 64) {
+        __m512i v = _mm512_loadu_si512(codes + i);
+        v = _mm512_or_si512(v, _mm512_srli_epi32(v, 6));
+        v = _mm512_or_si512(v, _mm512_srli_epi32(v, 12));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i / 4), _mm512_cvtepi32_epi8(v));
+    }
+    if (i < count) avx2::packCodes(codes + i, count - i, out + i / 4);
+}
+
+GENOMORPH_AVX512 void bitPlanes(const uint8_t *codes, size_t count, uint64_t *high, uint64_t *low) {
+
+    const __m512i bitOne = _mm512_set1_epi8(2);
+    const __m512i bitZero = _mm512_set1_epi8(1);
+    size_t w = 0;
+    for (; 64 * (w + 1) <= count; ++w) {
+        __m512i v = _mm512_loadu_si512(codes + 64 * w);
+        high[w] = _mm512_test_epi8_mask(v, bitOne);
+        low[w] = _mm512_test_epi8_mask(v, bitZero);
+    }
+    if (64 * w < count) avx2::bitPlanes(codes + 64 * w, count - 64 * w, high + w, low + w);
+}
+
+GENOMORPH_AVX512 inline __m512i codonBases(const __m512i (&bytes)[3], size_t position) {
+    __m512i bases = _mm512_setzero_si512();
+    for (size_t reg = 0; reg < 3; ++reg) {
+        __m512i gather = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(CODON_GATHER[position][reg].data())));
+        bases = _mm512_or_si512(bases, _mm512_shuffle_epi8(bytes[reg], gather));
+    }
+    return bases;
+}
+
+GENOMORPH_AVX512 void translateCodons(const uint8_t *codes, size_t codons, const char *table, char *out) {
+
+    __m512i quarter[4];
+    for (size_t q = 0; q < 4; ++q) {
+        quarter[q] = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(table + 16 * q)));
+    }
+
+    size_t i = 0;
+    for (; i + 64 <= codons; i += 64) {
+        __m512i bytes[3];
+        for (size_t reg = 0; reg < 3; ++reg) {
+            const uint8_t *group = codes + 3 * i + 16 * reg;
+            __m512i v = _mm512_castsi128_si512(_mm_loadu_si128(reinterpret_cast<const __m128i *>(group)));
+            v = _mm512_inserti32x4(v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(group + 48)), 1);
+            v = _mm512_inserti32x4(v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(group + 96)), 2);
+            bytes[reg] = _mm512_inserti32x4(v, _mm_loadu_si128(reinterpret_cast<const __m128i *>(group + 144)), 3);
+        }
+
+        __m512i first = codonBases(bytes, 0);
+        __m512i rest = _mm512_or_si512(_mm512_slli_epi16(codonBases(bytes, 1), 2), codonBases(bytes, 2));
+        __m512i residues = _mm512_setzero_si512();
+        for (size_t q = 0; q < 4; ++q) {
+            __mmask64 selected = _mm512_cmpeq_epi8_mask(first, _mm512_set1_epi8(static_cast<char>(q)));
+            residues = _mm512_mask_shuffle_epi8(residues, selected, quarter[q], rest);
+        }
+        _mm512_storeu_si512(out + i, residues);
+    }
+    if (i < codons) avx2::translateCodons(codes + 3 * i, codons - i, table, out + i);
+}
+
+GENOMORPH_AVX512 size_t shiftAnd(const uint8_t *codes, size_t count, const ShiftAndProgram &program, uint64_t *state, uint32_t *hits) {
+
+    static_assert(SHIFT_AND_LANES == 8, "one 512-bit register holds the whole automaton");
+    __m512i d = _mm512_loadu_si512(state);
+    __m512i initial = _mm512_loadu_si512(program.initial);
+    __m512i accept = _mm512_loadu_si512(program.accept);
+
+    size_t found = 0;
+    for (size_t i = 0; i < count; ++i) {
+        __m512i m = _mm512_loadu_si512(program.masks[codes[i]]);
+        d = _mm512_and_si512(_mm512_or_si512(_mm512_slli_epi64(d, 1), initial), m);
+        hits[found] = static_cast<uint32_t>(i);
+        found += _mm512_test_epi64_mask(d, accept) != 0;
+    }
+
+    _mm512_storeu_si512(state, d);
+    return found;
+}
+
+GENOMORPH_AVX512 size_t scoreWindows(const uint8_t *codes, size_t windows, const int8_t *columns, size_t width, int16_t threshold,
+                                     uint32_t *hits, int16_t *scores) {
+
+    __m512i limit = _mm512_set1_epi16(threshold);
+    size_t found = 0;
+    size_t i = 0;
+    for (; i + 64 <= windows; i += 64) {
+        __m512i low = _mm512_setzero_si512();
+        __m512i high = _mm512_setzero_si512();
+        for (size_t k = 0; k < width; ++k) {
+            __m512i column = _mm512_broadcast_i32x4(_mm_loadu_si128(reinterpret_cast<const __m128i *>(columns + k * PWM_COLUMN_STRIDE)));
+            __m512i s = _mm512_shuffle_epi8(column, _mm512_loadu_si512(codes + i + k));
+            low = _mm512_add_epi16(low, _mm512_cvtepi8_epi16(_mm512_castsi512_si256(s)));
+            high = _mm512_add_epi16(high, _mm512_cvtepi8_epi16(_mm512_extracti64x4_epi64(s, 1)));
+        }
+
+        uint64_t mask = _mm512_cmpge_epi16_mask(low, limit) | static_cast<uint64_t>(_mm512_cmpge_epi16_mask(high, limit)) << 32;
+        if (!mask) continue;
+        alignas(64) int16_t lane[64];
+        _mm512_store_si512(lane, low);
+        _mm512_store_si512(lane + 32, high);
+        for (; mask; mask &= mask - 1) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctzll(mask));
+            hits[found] = static_cast<uint32_t>(i + bit);
+            scores[found++] = lane[bit];
+        }
+    }
+
+    if (i < windows) {
+        size_t tail = avx2::scoreWindows(codes + i, windows - i, columns, width, threshold, hits + found, scores + found);
+        for (size_t h = found; h < found + tail; ++h) hits[h] += static_cast<uint32_t>(i);
+        found += tail;
+    }
+    return found;
+}
+
+}
+
+constexpr KernelTable SSE42_KERNELS = {
+    Isa::sse42,
+    sse42::xoshiroBlocks,
+    sse42::unpackCodes,
+    sse42::sampleBases,
+    sse42::complementCodes,
+    sse42::reverseComplementCodes,
+    sse42::countGc,
+    sse42::packCodes,
+    sse42::bitPlanes,
+    sse42::translateCodons,
+    sse42::shiftAnd,
+    sse42::scoreWindows,
+};
+
+constexpr KernelTable AVX2_KERNELS = {
+    Isa::avx2,
+    avx2::xoshiroBlocks,
+    avx2::unpackCodes,
+    avx2::sampleBases,
+    avx2::complementCodes,
+    avx2::reverseComplementCodes,
+    avx2::countGc,
+    avx2::packCodes,
+    avx2::bitPlanes,
+    avx2::translateCodons,
+    avx2::shiftAnd,
+    avx2::scoreWindows,
+};
+
+constexpr KernelTable AVX512_KERNELS = {
+    Isa::avx512,
+    avx512::xoshiroBlocks,
+    avx512::unpackCodes,
+    avx512::sampleBases,
+    avx512::complementCodes,
+    avx512::reverseComplementCodes,
+    avx512::countGc,
+    avx512::packCodes,
+    avx512::bitPlanes,
+    avx512::translateCodons,
+    avx512::shiftAnd,
+    avx512::scoreWindows,
+};
+
+}
+
+const KernelTable *sse42Kernels()   { return &SSE42_KERNELS; }
+const KernelTable *avx2Kernels()    { return &AVX2_KERNELS; }
+const KernelTable *avx512Kernels()  { return &AVX512_KERNELS; }
+
+#else
+
+const KernelTable *sse42Kernels()   { return nullptr; }
+const KernelTable *avx2Kernels()    { return nullptr; }
+const KernelTable *avx512Kernels()  { return nullptr; }
+
+#endif
@@ -1,11 +1,14 @@
-#include "genomeGenerator.hpp"
-#include "regionGenerator.hpp"
+#include "cli.hpp"
 
-int main() {
+#include <exception>
+#include <iostream>
 
-    GenomeGenerator generator;
+int main(int argc, char **argv) {
 
-    auto sequence = generator.generate_sequence(0, 10000);
-
-    return 0;
-}
\ No newline at end of file
+    try {
+        return runCli(argc, argv);
+    } catch (const std::exception &error) {
+        std::cerr << "genomorph: " << error.what() << '\n';
+        return 1;
+    }
+}
@@ -0,0 +1,100 @@
+#include "memoryBudget.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <stdexcept>
+
+uint64_t parseByteSize(const std::string &text) {
+
+    size_t used = 0;
+    double value = 0.0;
+    try {
+        value = std::stod(text, &used);
+    } catch (const std::exception &) {
+        used = 0;
+    }
+
+    std::string unit = text.substr(used);
+    std::transform(unit.begin(), unit.end(), unit.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    if (unit.size() > 1 && (unit.substr(1) == "B" || unit.substr(1) == "IB")) unit.resize(1);
+    if (unit == "B") unit.clear();
+
+    int shift = -1;
+    if (unit.empty()) shift = 0;
+    else if (unit == "K") shift = 10;
+    else if (unit == "M") shift = 20;
+    else if (unit == "G") shift = 30;
+    else if (unit == "T") shift = 40;
+
+    double bytes = value * std::ldexp(1.0, shift);
+    if (used == 0 || shift < 0 || !(value >= 0.0) || bytes >= 18446744073709551615.0) {
+        throw std::invalid_argument("expected a size such as 4096, 512M or 1.5G, got '" + text + "'");
+    }
+    if (bytes < 1.0) throw std::invalid_argument("size must be positive, got '" + text + "'");
+    return static_cast<uint64_t>(bytes);
+}
+
+std::string formatByteSize(uint64_t bytes) {
+
+    static const char *UNITS[] = {"B", "KiB", "MiB", "GiB", "TiB"};
+    double value = static_cast<double>(bytes);
+    size_t unit = 0;
+    while (value >= 1024.0 && unit + 1 < std::size(UNITS)) {
+        value /= 1024.0;
+        ++unit;
+    }
+
+    char text[32];
+    std::snprintf(text, sizeof(text), unit == 0 ? "%.0f %s" : "%.1f %s", value, UNITS[unit]);
+    return text;
+}
+
+uint64_t estimateMemory(const MemoryDemand &demand, const MemoryPlan &plan) {
+
+    uint64_t window = plan.windowBases ? std::min<uint64_t>(plan.windowBases, demand.largestChromosome) : demand.largestChromosome;
+    return MEMORY_OVERHEAD_BYTES
+         + static_cast<uint64_t>(plan.threads) * MEMORY_THREAD_BYTES
+         + static_cast<uint64_t>(demand.outputFiles) * plan.ioDepth * demand.ioChunkBytes
+         + static_cast<uint64_t>(plan.pipelineChunks) * demand.pipelineChunkBytes
+         + window
+         + plan.cacheBytes;
+}
+
+MemoryPlan planMemory(uint64_t budget, const MemoryDemand &demand) {
+
+    MemoryPlan plan;
+    plan.threads = std::max(demand.threads, 1u);
+    plan.ioDepth = demand.ioDepth;
+    plan.pipelineChunks = demand.pipelineChunks;
+    plan.cacheBytes = demand.cacheBytes;
+
+    auto fits = [&]() { return estimateMemory(demand, plan) <= budget; };
+
+    size_t minWindow = std::max(MIN_WINDOW_BASES, demand.longestRegion);
+
+    /**
+     * NOTE: each step halves its knob until the run fits or the knob hits its floor, then moves on to the next one
+     */
+    while (!fits() && plan.pipelineChunks > 2) plan.pipelineChunks = std::max<size_t>(plan.pipelineChunks / 2, 2);
+    while (!fits() && plan.ioDepth > 2) plan.ioDepth = std::max<size_t>(plan.ioDepth / 2, 2);
+    while (!fits() && plan.cacheBytes > budget / 8) plan.cacheBytes = std::max(plan.cacheBytes / 2, budget / 8);
+
+    if (!fits() && demand.largestChromosome > minWindow) {
+        plan.windowBases = demand.largestChromosome;
+        while (!fits() && plan.windowBases > minWindow) plan.windowBases = std::max(plan.windowBases / 2, minWindow);
+    }
+
+    while (!fits() && plan.cacheBytes > 0) plan.cacheBytes /= 2;
+    while (!fits() && plan.threads > 1) plan.threads = std::max(plan.threads / 2, 1u);
+
+    plan.estimatedBytes = estimateMemory(demand, plan);
+    if (plan.estimatedBytes > budget) {
+        throw std::invalid_argument("--max-memory " + formatByteSize(budget) + " is too small: this run needs at least "
+                                    + formatByteSize(plan.estimatedBytes));
+    }
+    plan.planBytes = budget - plan.estimatedBytes;
+    return plan;
+}
@@ -0,0 +1,285 @@
+#include "metrics.hpp"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr const char *COUNTER_NAMES[] = {"bases_generated", "regions_planned", "regions_filled", "buffer_allocations", "genes_planned",
+                                         "motifs_planted", "pipeline_stalls", "cache_hits", "cache_misses", "cache_evictions"};
+constexpr const char *TIMER_NAMES[] = {"region_planning", "base_sampling", "strand_complement", "sink_write"};
+
+static_assert(sizeof(COUNTER_NAMES) / sizeof(COUNTER_NAMES[0]) == static_cast<size_t>(Counter::COUNT));
+static_assert(sizeof(TIMER_NAMES) / sizeof(TIMER_NAMES[0]) == static_cast<size_t>(Timer::COUNT));
+
+double seconds(uint64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) * 1e-9;
+}
+
+std::string jsonEscape(const std::string &text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+}
+
+/**
+ * NOTE: ShardLease -> thread_local owner of a shard; hands it back to the free list when the thread exits
+ */
+struct ShardLease {
+    Metrics::ThreadShard *shard = nullptr;
+
+    ~ShardLease() {
+        if (!shard) return;
+        Metrics &metrics = Metrics::instance();
+        std::lock_guard<std::mutex> lock(metrics.registryMutex);
+        metrics.freeShards.push_back(shard);
+    }
+};
+
+Metrics& Metrics::instance() {
+    static Metrics metrics;
+    return metrics;
+}
+
+Metrics::ThreadShard& Metrics::shard() {
+
+    thread_local ShardLease lease;
+    if (lease.shard) return *lease.shard;
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    if (!freeShards.empty()) {
+        lease.shard = freeShards.back();
+        freeShards.pop_back();
+    } else {
+        shards.push_back(std::make_unique<ThreadShard>());
+        lease.shard = shards.back().get();
+    }
+    return *lease.shard;
+}
+
+SinkStats& Metrics::sink(const std::string &name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (SinkStats &stats : sinks) {
+        if (stats.name == name) return stats;
+    }
+    sinks.emplace_back();
+    sinks.back().name = name;
+    return sinks.back();
+}
+
+GaugeStats& Metrics::gauge(const std::string &name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (GaugeStats &stats : gauges) {
+        if (stats.name == name) return stats;
+    }
+    gauges.emplace_back();
+    gauges.back().name = name;
+    return gauges.back();
+}
+
+void Metrics::recordGauge(GaugeStats &gauge, uint64_t value) {
+    gauge.current.store(value, std::memory_order_relaxed);
+    uint64_t peak = gauge.peak.load(std::memory_order_relaxed);
+    while (value > peak && !gauge.peak.compare_exchange_weak(peak, value, std::memory_order_relaxed)) {}
+}
+
+void Metrics::addWorkerTime(size_t worker, uint64_t busyNanoseconds, uint64_t idleNanoseconds, uint64_t tasks) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    while (workers.size() <= worker) workers.emplace_back();
+    workers[worker].busyNanoseconds.fetch_add(busyNanoseconds, std::memory_order_relaxed);
+    workers[worker].idleNanoseconds.fetch_add(idleNanoseconds, std::memory_order_relaxed);
+    workers[worker].tasks.fetch_add(tasks, std::memory_order_relaxed);
+}
+
+uint64_t Metrics::total(Counter counter) const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    uint64_t sum = 0;
+    for (const auto &local : shards) sum += local->counters[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+    return sum;
+}
+
+std::string Metrics::toJson() const {
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::array<uint64_t, COUNTERS> counters {};
+    std::array<uint64_t, TIMERS> timerNanoseconds {};
+    std::array<uint64_t, TIMERS> timerCalls {};
+    for (const auto &local : shards) {
+        for (size_t i = 0; i < COUNTERS; ++i) counters[i] += local->counters[i].load(std::memory_order_relaxed);
+        for (size_t i = 0; i < TIMERS; ++i) {
+            timerNanoseconds[i] += local->timerNanoseconds[i].load(std::memory_order_relaxed);
+            timerCalls[i] += local->timerCalls[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    std::ostringstream out;
+    out << "{\n  \"enabled\": " << (enabled() ? "true" : "false") << ",\n";
+    out << "  \"elapsed_seconds\": " << elapsed << ",\n";
+    out << "  \"bases_per_second\": " << (elapsed > 0 ? counters[static_cast<size_t>(Counter::bases_generated)] / elapsed : 0.0) << ",\n";
+    out << "  \"regions_per_second\": " << (elapsed > 0 ? counters[static_cast<size_t>(Counter::regions_planned)] / elapsed : 0.0) << ",\n";
+
+    out << "  \"counters\": {";
+    for (size_t i = 0; i < COUNTERS; ++i) out << (i ? ", " : "") << '"' << COUNTER_NAMES[i] << "\": " << counters[i];
+    out << "},\n";
+
+    out << "  \"stages\": {";
+    for (size_t i = 0; i < TIMERS; ++i) {
+        out << (i ? ", " : "") << '"' << TIMER_NAMES[i] << "\": {\"seconds\": " << seconds(timerNanoseconds[i])
+            << ", \"calls\": " << timerCalls[i] << '}';
+    }
+    out << "},\n";
+
+    out << "  \"sinks\": [";
+    for (size_t i = 0; i < sinks.size(); ++i) {
+        const SinkStats &stats = sinks[i];
+        double busy = seconds(stats.nanoseconds.load());
+        out << (i ? ", " : "") << "{\"name\": \"" << jsonEscape(stats.name) << "\", \"bytes\": " << stats.bytes.load()
+            << ", \"writes\": " << stats.writes.load() << ", \"seconds\": " << busy
+            << ", \"bytes_per_second\": " << (busy > 0 ? stats.bytes.load() / busy : 0.0) << '}';
+    }
+    out << "],\n";
+
+    out << "  \"queues\": [";
+    for (size_t i = 0; i < gauges.size(); ++i) {
+        out << (i ? ", " : "") << "{\"name\": \"" << jsonEscape(gauges[i].name) << "\", \"depth\": " << gauges[i].current.load()
+            << ", \"peak\": " << gauges[i].peak.load() << '}';
+    }
+    out << "],\n";
+
+    out << "  \"workers\": [";
+    for (size_t i = 0; i < workers.size(); ++i) {
+        out << (i ? ", " : "") << "{\"worker\": " << i << ", \"busy_seconds\": " << seconds(workers[i].busyNanoseconds.load())
+            << ", \"idle_seconds\": " << seconds(workers[i].idleNanoseconds.load()) << ", \"tasks\": " << workers[i].tasks.load() << '}';
+    }
+    out << "]\n}\n";
+
+    return out.str();
+}
+
+std::string Metrics::toPrometheus() const {
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ostringstream out;
+    out << "# TYPE genomorph_elapsed_seconds gauge\ngenomorph_elapsed_seconds " << elapsed << '\n';
+
+    out << "# TYPE genomorph_events_total counter\n";
+    for (size_t i = 0; i < COUNTERS; ++i) {
+        uint64_t sum = 0;
+        for (const auto &local : shards) sum += local->counters[i].load(std::memory_order_relaxed);
+        out << "genomorph_events_total{event=\"" << COUNTER_NAMES[i] << "\"} " << sum << '\n';
+    }
+
+    std::array<uint64_t, TIMERS> timerNanoseconds {};
+    std::array<uint64_t, TIMERS> timerCalls {};
+    for (const auto &local : shards) {
+        for (size_t i = 0; i < TIMERS; ++i) {
+            timerNanoseconds[i] += local->timerNanoseconds[i].load(std::memory_order_relaxed);
+            timerCalls[i] += local->timerCalls[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * NOTE: the exposition format wants every sample of a metric family contiguous, hence one loop per family
+     */
+    out << "# TYPE genomorph_stage_seconds_total counter\n";
+    for (size_t i = 0; i < TIMERS; ++i) {
+        out << "genomorph_stage_seconds_total{stage=\"" << TIMER_NAMES[i] << "\"} " << seconds(timerNanoseconds[i]) << '\n';
+    }
+    out << "# TYPE genomorph_stage_calls_total counter\n";
+    for (size_t i = 0; i < TIMERS; ++i) {
+        out << "genomorph_stage_calls_total{stage=\"" << TIMER_NAMES[i] << "\"} " << timerCalls[i] << '\n';
+    }
+
+    out << "# TYPE genomorph_sink_bytes_total counter\n";
+    for (const SinkStats &stats : sinks) out << "genomorph_sink_bytes_total{sink=\"" << stats.name << "\"} " << stats.bytes.load() << '\n';
+    out << "# TYPE genomorph_sink_writes_total counter\n";
+    for (const SinkStats &stats : sinks) out << "genomorph_sink_writes_total{sink=\"" << stats.name << "\"} " << stats.writes.load() << '\n';
+    out << "# TYPE genomorph_sink_seconds_total counter\n";
+    for (const SinkStats &stats : sinks) out << "genomorph_sink_seconds_total{sink=\"" << stats.name << "\"} " << seconds(stats.nanoseconds.load()) << '\n';
+
+    out << "# TYPE genomorph_queue_depth gauge\n";
+    for (const GaugeStats &stats : gauges) out << "genomorph_queue_depth{queue=\"" << stats.name << "\"} " << stats.current.load() << '\n';
+    out << "# TYPE genomorph_queue_depth_peak gauge\n";
+    for (const GaugeStats &stats : gauges) out << "genomorph_queue_depth_peak{queue=\"" << stats.name << "\"} " << stats.peak.load() << '\n';
+
+    out << "# TYPE genomorph_worker_seconds_total counter\n";
+    for (size_t i = 0; i < workers.size(); ++i) {
+        out << "genomorph_worker_seconds_total{worker=\"" << i << "\",state=\"busy\"} " << seconds(workers[i].busyNanoseconds.load()) << '\n';
+        out << "genomorph_worker_seconds_total{worker=\"" << i << "\",state=\"idle\"} " << seconds(workers[i].idleNanoseconds.load()) << '\n';
+    }
+
+    return out.str();
+}
+
+std::string Metrics::render(const std::string &format) const {
+    if (format == "json") return toJson();
+    if (format == "prometheus" || format == "prom") return toPrometheus();
+    throw std::invalid_argument("unknown metrics format '" + format + "' (expected json or prometheus)");
+}
+
+MetricsReporter::MetricsReporter(std::string path, std::string format, std::chrono::milliseconds interval)
+    : path(std::move(path)), format(std::move(format)), interval(interval)
+{
+    Metrics::instance().render(this->format);
+
+    if (interval.count() > 0) {
+        worker = std::thread([this]() {
+            std::unique_lock<std::mutex> lock(mutex);
+            while (!wake.wait_for(lock, this->interval, [this]() { return stopping; })) {
+                try {
+                    writeReport();
+                } catch (const std::exception &error) {
+                    std::fprintf(stderr, "genomorph: %s\n", error.what());
+                }
+            }
+        });
+    }
+}
+
+MetricsReporter::~MetricsReporter() {
+    try {
+        stop();
+    } catch (...) {
+    }
+}
+
+void MetricsReporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (stopping) return;
+        stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+    writeReport();
+}
+
+void MetricsReporter::writeReport() const {
+
+    std::string report = Metrics::instance().render(format);
+
+    if (path.empty() || path == "-") {
+        std::fputs(report.c_str(), stderr);
+        return;
+    }
+
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file) throw std::runtime_error("cannot open metrics file " + temporary);
+        file << report;
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error("cannot replace metrics file " + path);
+    }
+}
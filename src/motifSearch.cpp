@@ -0,0 +1,137 @@
+#include "motifSearch.hpp"
+#include "baseCodes.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * NOTE: HIT_BLOCK -> bases handed to one shiftAnd call, bounds the hit buffer (the kernel may report every position)
+ */
+constexpr size_t HIT_BLOCK = 1 << 16;
+
+bool matches(const uint8_t *codes, const std::vector<uint8_t> &allowed) {
+    for (size_t k = 0; k < allowed.size(); ++k) {
+        if (!((allowed[k] >> codes[k]) & 1)) return false;
+    }
+    return true;
+}
+
+}
+
+uint32_t regionAt(const RegionMap &regions, size_t position) {
+    if (regions.empty()) return NO_REGION;
+    auto after = std::upper_bound(regions.begin(), regions.end(), position, [](size_t p, const RegionInfo &region) {
+        return p < region.base.region_plan.region_start_index;
+    });
+    return after == regions.begin() ? 0 : static_cast<uint32_t>(after - regions.begin() - 1);
+}
+
+MotifSearcher::MotifSearcher(std::vector<MotifPattern> patterns)
+    : patterns(std::move(patterns))
+{
+    if (this->patterns.empty()) throw std::invalid_argument("motif search needs at least one pattern");
+
+    std::vector<Entry> entries;
+    for (uint32_t p = 0; p < this->patterns.size(); ++p) {
+        const MotifPattern &pattern = this->patterns[p];
+        if (pattern.consensus.empty() || pattern.consensus.size() > 64) {
+            throw std::invalid_argument("motif " + pattern.name + ": patterns need 1 to 64 positions");
+        }
+
+        Entry plus {p, StrandInfo::plus, {}};
+        for (char symbol : pattern.consensus) {
+            uint8_t mask = iupacMask(static_cast<char>(std::toupper(static_cast<unsigned char>(symbol))));
+            if (mask == 0) throw std::invalid_argument("motif " + pattern.name + ": not an IUPAC base symbol: '" + symbol + "'");
+            plus.allowed.push_back(mask);
+        }
+
+        /**
+         * NOTE: the minus strand is matched on the plus strand as the reverse complement of the pattern
+         */
+        Entry minus {p, StrandInfo::minus, {}};
+        for (auto k = plus.allowed.rbegin(); k != plus.allowed.rend(); ++k) minus.allowed.push_back(complementMask(*k));
+
+        longestPattern = std::max(longestPattern, plus.allowed.size());
+        bool palindromic = minus.allowed == plus.allowed;
+        palindromes.push_back(palindromic);
+        entries.push_back(std::move(plus));
+        if (!palindromic) entries.push_back(std::move(minus));
+    }
+
+    /**
+     * NOTE: entries are packed first fit into lanes in pattern order; a lane never splits an entry, so the bit shifted
+     * out of one entry lands on the next entry's first position, which `initial` sets anyway
+     */
+    size_t lane = 0;
+    size_t used = 0;
+    for (Entry &entry : entries) {
+        size_t length = entry.allowed.size();
+        if (passes.empty() || used + length > 64) {
+            lane = passes.empty() ? 0 : lane + 1;
+            used = 0;
+            if (passes.empty() || lane == SHIFT_AND_LANES) {
+                passes.emplace_back();
+                lane = 0;
+            }
+        }
+
+        ShiftAndProgram &program = passes.back().program;
+        for (size_t k = 0; k < length; ++k) {
+            for (size_t code = 0; code < 4; ++code) {
+                if ((entry.allowed[k] >> code) & 1) program.masks[code][lane] |= uint64_t{1} << (used + k);
+            }
+        }
+        program.initial[lane] |= uint64_t{1} << used;
+        program.accept[lane] |= uint64_t{1} << (used + length - 1);
+        used += length;
+        passes.back().entries.push_back(std::move(entry));
+    }
+}
+
+std::vector<MotifHit> MotifSearcher::search(const uint8_t *codes, size_t length, const RegionMap &regions, unsigned threads) const {
+
+    size_t chunks = (length + CHUNK_BASES - 1) / CHUNK_BASES;
+    std::vector<std::vector<MotifHit>> found(chunks);
+
+    parallelFor(chunks, threads, [&](size_t c) {
+        size_t begin = c * CHUNK_BASES;
+        size_t end = std::min(length, begin + CHUNK_BASES);
+        size_t from = begin > longestPattern - 1 ? begin - (longestPattern - 1) : 0;
+        std::vector<uint32_t> ends(HIT_BLOCK);
+
+        /**
+         * NOTE: a chunk owns the hits that end inside it; the automaton starts longest() - 1 bases early so those that
+         * begin in the previous chunk are complete
+         */
+        for (const Pass &pass : passes) {
+            uint64_t state[SHIFT_AND_LANES] = {};
+            for (size_t block = from; block < end; block += HIT_BLOCK) {
+                size_t count = std::min(HIT_BLOCK, end - block);
+                size_t hits = kernels().shiftAnd(codes + block, count, pass.program, state, ends.data());
+
+                for (size_t h = 0; h < hits; ++h) {
+                    size_t last = block + ends[h];
+                    if (last < begin) continue;
+                    for (const Entry &entry : pass.entries) {
+                        size_t size = entry.allowed.size();
+                        if (size > last + 1 || !matches(codes + last + 1 - size, entry.allowed)) continue;
+                        size_t start = last + 1 - size;
+                        found[c].push_back(MotifHit{start, entry.pattern, entry.strand, regionAt(regions, start)});
+                    }
+                }
+            }
+        }
+    });
+
+    std::vector<MotifHit> hits;
+    for (std::vector<MotifHit> &chunk : found) hits.insert(hits.end(), chunk.begin(), chunk.end());
+    std::sort(hits.begin(), hits.end(), [](const MotifHit &a, const MotifHit &b) {
+        if (a.start != b.start) return a.start < b.start;
+        if (a.pattern != b.pattern) return a.pattern < b.pattern;
+        return a.strand < b.strand;
+    });
+    return hits;
+}
@@ -0,0 +1,171 @@
+#include "orfScanner.hpp"
+#include "kernels.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+
+constexpr size_t NO_START = SIZE_MAX;
+
+/**
+ * @brief Calls emit(start, end) for every ORF of the sequence in its own coordinates, in increasing end order.
+ */
+template <typename Emit>
+void scanStrand(const uint8_t *codes, size_t length, Emit &&emit) {
+
+    if (length < 6) return;
+
+    size_t words = (length + 63) / 64;
+    std::vector<uint64_t> high(words + 1, 0);
+    std::vector<uint64_t> low(words + 1, 0);
+    kernels().bitPlanes(codes, length, high.data(), low.data());
+
+    size_t open[3] = {NO_START, NO_START, NO_START};
+    size_t lastCodon = length - 3;
+    size_t wordFrame = 0; // (64 * w) % 3
+
+    for (size_t w = 0; w < words; ++w, wordFrame = (wordFrame + 1) % 3) {
+
+        /**
+         * NOTE: bit b of the k-shifted planes describes base 64w + b + k, so one mask test checks a codon at all 64 positions
+         */
+        uint64_t h0 = high[w], l0 = low[w];
+        uint64_t h1 = (h0 >> 1) | (high[w + 1] << 63), l1 = (l0 >> 1) | (low[w + 1] << 63);
+        uint64_t h2 = (h0 >> 2) | (high[w + 1] << 62), l2 = (l0 >> 2) | (low[w + 1] << 62);
+
+        uint64_t a1 = ~h1 & ~l1, a2 = ~h2 & ~l2;
+        uint64_t g1 = h1 & ~l1, g2 = h2 & ~l2;
+        uint64_t t0 = h0 & l0, t1 = h1 & l1;
+
+        uint64_t starts = ~h0 & ~l0 & t1 & g2;
+        uint64_t stops = t0 & ((a1 & (a2 | g2)) | (g1 & a2));
+
+        if (64 * w + 63 > lastCodon) {
+            uint64_t valid = 64 * w > lastCodon ? 0 : ~uint64_t{0} >> (63 - (lastCodon - 64 * w));
+            starts &= valid;
+            stops &= valid;
+        }
+
+        for (uint64_t events = starts | stops; events; events &= events - 1) {
+            unsigned bit = static_cast<unsigned>(__builtin_ctzll(events));
+            size_t position = 64 * w + bit;
+            size_t frame = (wordFrame + bit) % 3;
+
+            if ((stops >> bit) & 1) {
+                if (open[frame] != NO_START) emit(open[frame], position + 3);
+                open[frame] = NO_START;
+            } else if (open[frame] == NO_START) {
+                open[frame] = position;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Planned ORFs of one strand in that strand's coordinates (sorted by end) and the regions they came from.
+ */
+struct StrandPlan {
+    std::vector<OpenReadingFrame>   orfs;
+    std::vector<size_t>             regions;
+};
+
+struct StrandResult {
+    OrfReport                       report;
+    std::vector<bool>               intact;
+    std::vector<OpenReadingFrame>   longOrfs;
+};
+
+StrandResult scanAgainstPlan(const uint8_t *codes, size_t length, const StrandPlan &plan, StrandInfo strand,
+                             size_t minCodons, bool keepLongOrfs) {
+
+    StrandResult result;
+    result.intact.assign(plan.orfs.size(), false);
+    size_t next = 0;
+
+    scanStrand(codes, length, [&](size_t start, size_t end) {
+        while (next < plan.orfs.size() && plan.orfs[next].end < end) ++next;
+        bool planned = next < plan.orfs.size() && plan.orfs[next].end == end && start <= plan.orfs[next].start;
+        if (planned) result.intact[next] = true;
+
+        if ((end - start) / 3 < minCodons) return;
+        ++result.report.longOrfs;
+        if (!planned) ++result.report.spuriousLongOrfs;
+        if (keepLongOrfs) {
+            result.longOrfs.push_back(strand == StrandInfo::plus ? OpenReadingFrame{start, end, strand}
+                                                                 : OpenReadingFrame{length - end, length - start, strand});
+        }
+    });
+    return result;
+}
+
+}
+
+std::optional<OpenReadingFrame> plannedOpenReadingFrame(const RegionInfo &region) {
+
+    if (region.base.type != FeatureType::coding || region.gene) return std::nullopt;
+
+    const RegionPlan &plan = region.base.region_plan;
+    size_t length = plan.RegionLength();
+    size_t phase = region.coding ? static_cast<size_t>(std::abs(region.coding->reading_frame)) - 1 : 0;
+    size_t codons = length > phase ? (length - phase) / 3 : 0;
+    if (codons < 2) return std::nullopt;
+
+    if (plan.strand == StrandInfo::plus) {
+        size_t start = plan.region_start_index + phase;
+        return OpenReadingFrame{start, start + 3 * codons, StrandInfo::plus};
+    }
+    size_t end = plan.region_end_index + 1 - phase;
+    return OpenReadingFrame{end - 3 * codons, end, StrandInfo::minus};
+}
+
+OrfReport scanOpenReadingFrames(const uint8_t *codes, size_t length, const RegionMap &regions, size_t minCodons,
+                                unsigned threads, std::vector<OpenReadingFrame> *longOrfs) {
+
+    /**
+     * NOTE: the minus strand is scanned as its reverse complement, so its planned ORFs are mirrored into those coordinates
+     */
+    StrandPlan plans[2];
+    for (size_t r = 0; r < regions.size(); ++r) {
+        std::optional<OpenReadingFrame> orf = plannedOpenReadingFrame(regions[r]);
+        if (!orf) continue;
+        if (orf->strand == StrandInfo::plus) {
+            plans[0].orfs.push_back(*orf);
+            plans[0].regions.push_back(r);
+        } else {
+            plans[1].orfs.push_back(OpenReadingFrame{length - orf->end, length - orf->start, StrandInfo::minus});
+            plans[1].regions.push_back(r);
+        }
+    }
+    std::reverse(plans[1].orfs.begin(), plans[1].orfs.end());
+    std::reverse(plans[1].regions.begin(), plans[1].regions.end());
+
+    StrandResult results[2];
+    parallelFor(2, threads, [&](size_t s) {
+        if (s == 0) {
+            results[0] = scanAgainstPlan(codes, length, plans[0], StrandInfo::plus, minCodons, longOrfs != nullptr);
+        } else {
+            std::vector<uint8_t> reverse(length);
+            kernels().reverseComplementCodes(codes, length, reverse.data());
+            results[1] = scanAgainstPlan(reverse.data(), length, plans[1], StrandInfo::minus, minCodons, longOrfs != nullptr);
+        }
+    });
+
+    OrfReport report;
+    report.scannedBases = length;
+    for (size_t s = 0; s < 2; ++s) {
+        report.plannedCoding += plans[s].orfs.size();
+        report.longOrfs += results[s].report.longOrfs;
+        report.spuriousLongOrfs += results[s].report.spuriousLongOrfs;
+        for (size_t i = 0; i < plans[s].orfs.size(); ++i) {
+            if (results[s].intact[i]) ++report.intactCoding;
+            else report.brokenRegions.push_back(plans[s].regions[i]);
+        }
+        if (longOrfs) {
+            if (s == 1) std::reverse(results[1].longOrfs.begin(), results[1].longOrfs.end());
+            longOrfs->insert(longOrfs->end(), results[s].longOrfs.begin(), results[s].longOrfs.end());
+        }
+    }
+    std::sort(report.brokenRegions.begin(), report.brokenRegions.end());
+    return report;
+}
@@ -0,0 +1,592 @@
+#include "outputFile.hpp"
+#include "allocationProfile.hpp"
+#include "bgzf.hpp"
+#include "boundedQueue.hpp"
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * NOTE: DIRECT_ALIGNMENT -> buffer address, length and file offset alignment for O_DIRECT; 4 KiB covers every
+ * logical block size in practice
+ */
+constexpr size_t DIRECT_ALIGNMENT = 4096;
+
+size_t alignUp(size_t value) {
+    return (value + DIRECT_ALIGNMENT - 1) / DIRECT_ALIGNMENT * DIRECT_ALIGNMENT;
+}
+
+std::runtime_error writeError(const std::string &path, int error) {
+    return std::runtime_error("failed writing " + path + ": " + std::strerror(error));
+}
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: SYNC (std::ofstream / stdout)
+ * --------------------------------------------------------------
+ */
+
+class StreamOutputFile : public OutputFile {
+private:
+    std::string     path;
+    std::ofstream   file;
+    std::ostream   *out;
+    bool            closed = false;
+
+public:
+    StreamOutputFile(const std::string &path, bool append) : path(path), out(&file) {
+        if (path == "-") {
+            this->path = "standard output";
+            out = &std::cout;
+            return;
+        }
+        file.open(path, std::ios::binary | std::ios::out | (append ? std::ios::app : std::ios::trunc));
+        if (!file) throw std::runtime_error("cannot open output file " + path);
+    }
+
+    void write(const char *data, size_t size) override {
+        out->write(data, static_cast<std::streamsize>(size));
+    }
+
+    void flush() override {
+        out->flush();
+        if (!*out) throw std::runtime_error("failed writing " + path);
+    }
+
+    void close() override {
+        if (closed) return;
+        closed = true;
+        flush();
+        if (out == &file) file.close();
+    }
+
+    IoBackend backend() const override { return IoBackend::sync; }
+};
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: ASYNC FRONT END (chunk buffers shared by uring and threads)
+ * --------------------------------------------------------------
+ */
+
+struct ChunkBuffer {
+    char                    *data = nullptr;
+    int                     fd = -1;
+    size_t                  fill = 0;       /**< bytes copied in by the caller */
+    uint64_t                offset = 0;     /**< file offset of data[0] */
+    size_t                  length = 0;     /**< bytes of the write in flight (fill, padded under O_DIRECT) */
+    size_t                  done = 0;
+    int                     error = 0;
+    std::atomic<uint32_t>   pending {0};
+    iovec                   vector {};
+
+    ~ChunkBuffer() { std::free(data); }
+};
+
+/**
+ * @brief Writes buffer[done, length) with pwrite, retrying short writes; records errno on failure.
+ */
+void writeChunk(ChunkBuffer &buffer) {
+    while (buffer.done < buffer.length) {
+        ssize_t written = ::pwrite(buffer.fd, buffer.data + buffer.done, buffer.length - buffer.done,
+                                   static_cast<off_t>(buffer.offset + buffer.done));
+        if (written < 0 && errno == EINTR) continue;
+        if (written <= 0) {
+            buffer.error = written < 0 ? errno : EIO;
+            return;
+        }
+        buffer.done += static_cast<size_t>(written);
+    }
+}
+
+/**
+ * @brief Opens a descriptor for the async backends; clears `direct` when the filesystem or the append offset rules O_DIRECT out.
+ */
+int openDescriptor(const std::string &path, bool append, bool &direct, uint64_t &offset) {
+
+    int flags = O_WRONLY | O_CREAT | O_CLOEXEC | (append ? 0 : O_TRUNC);
+    int fd = ::open(path.c_str(), flags | (direct ? O_DIRECT : 0), 0644);
+    if (fd < 0 && direct && errno == EINVAL) {
+        std::cerr << "genomorph: O_DIRECT is not supported for " << path << ", writing through the page cache\n";
+        direct = false;
+        fd = ::open(path.c_str(), flags, 0644);
+    }
+    if (fd < 0) throw std::runtime_error("cannot open output file " + path + ": " + std::strerror(errno));
+
+    offset = 0;
+    if (append) {
+        off_t end = ::lseek(fd, 0, SEEK_END);
+        if (end < 0) {
+            int error = errno;
+            ::close(fd);
+            throw std::runtime_error("cannot open output file " + path + ": " + std::strerror(error));
+        }
+        offset = static_cast<uint64_t>(end);
+        if (direct && offset % DIRECT_ALIGNMENT != 0) {
+            direct = false;
+            ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) & ~O_DIRECT);
+        }
+    }
+    return fd;
+}
+
+class AsyncOutputFile : public OutputFile {
+private:
+    std::vector<std::unique_ptr<ChunkBuffer>>   buffers;
+    size_t                                      current = 0;
+    size_t                                      chunkBytes;
+    bool                                        closed = false;
+    GaugeStats                                  &inFlight;
+
+    /**
+     * @brief Waits for buffer's write and rethrows its error.
+     */
+    void settle(ChunkBuffer &buffer) {
+        if (buffer.pending.load(std::memory_order_acquire) != 0) wait(buffer);
+        if (buffer.error != 0) {
+            int error = buffer.error;
+            buffer.error = 0;
+            throw writeError(path, error);
+        }
+    }
+
+    void dispatch(ChunkBuffer &buffer, size_t length) {
+        buffer.length = length;
+        buffer.done = 0;
+        buffer.error = 0;
+        buffer.pending.store(1, std::memory_order_relaxed);
+        start(buffer);
+
+        size_t pending = 0;
+        for (const auto &other : buffers) pending += other->pending.load(std::memory_order_relaxed);
+        GENOMORPH_GAUGE(inFlight, pending);
+    }
+
+protected:
+    std::string     path;
+    int             fd;
+    bool            direct;
+
+    /**
+     * @brief Starts writing buffer[0, length) at buffer.offset; completion clears buffer.pending.
+     */
+    virtual void start(ChunkBuffer &buffer) = 0;
+
+    /**
+     * @brief Blocks until buffer.pending is clear.
+     */
+    virtual void wait(ChunkBuffer &buffer) = 0;
+
+    /**
+     * NOTE: derived destructors call this while their engine still exists, so no write outlives its buffer
+     */
+    void drain() noexcept {
+        for (auto &buffer : buffers) {
+            if (buffer->pending.load(std::memory_order_acquire) != 0) wait(*buffer);
+        }
+    }
+
+public:
+    AsyncOutputFile(const std::string &path, int fd, bool direct, uint64_t offset, const IoOptions &options)
+        : chunkBytes(alignUp(std::max<size_t>(options.chunkBytes, 1))), inFlight(Metrics::instance().gauge("io_writes_in_flight")),
+          path(path), fd(fd), direct(direct)
+    {
+        size_t count = std::max<size_t>(options.depth, 2);
+        for (size_t i = 0; i < count; ++i) {
+            auto buffer = std::make_unique<ChunkBuffer>();
+            buffer->data = static_cast<char *>(std::aligned_alloc(DIRECT_ALIGNMENT, chunkBytes));
+            if (!buffer->data) {
+                ::close(fd);
+                throw std::bad_alloc();
+            }
+            buffer->fd = fd;
+            buffers.push_back(std::move(buffer));
+        }
+        buffers[0]->offset = offset;
+        GENOMORPH_COUNT(buffer_allocations, count);
+    }
+
+    /**
+     * NOTE: owns fd from construction on, also when a constructor throws
+     */
+    ~AsyncOutputFile() override {
+        if (fd >= 0) ::close(fd);
+    }
+
+    void write(const char *data, size_t size) override {
+        while (size > 0) {
+            ChunkBuffer &buffer = *buffers[current];
+            size_t take = std::min(size, chunkBytes - buffer.fill);
+            std::memcpy(buffer.data + buffer.fill, data, take);
+            buffer.fill += take;
+            data += take;
+            size -= take;
+            if (buffer.fill < chunkBytes) break;
+
+            /**
+             * NOTE: a full chunk goes out and the oldest buffer is reused; this is the only place the caller waits
+             */
+            dispatch(buffer, chunkBytes);
+            current = (current + 1) % buffers.size();
+            ChunkBuffer &next = *buffers[current];
+            settle(next);
+            next.fill = 0;
+            next.offset = buffer.offset + chunkBytes;
+        }
+    }
+
+    void flush() override {
+
+        /**
+         * NOTE: the partial chunk is written but stays current, later bytes are appended to it and it is rewritten
+         * (at the same offset) once full; under O_DIRECT its zero padding is truncated away below
+         */
+        ChunkBuffer &buffer = *buffers[current];
+        size_t length = buffer.fill;
+        if (buffer.fill != 0) {
+            if (direct) {
+                length = alignUp(buffer.fill);
+                std::memset(buffer.data + buffer.fill, 0, length - buffer.fill);
+            }
+            dispatch(buffer, length);
+        }
+        for (auto &pending : buffers) settle(*pending);
+
+        if (length != buffer.fill && ::ftruncate(fd, static_cast<off_t>(buffer.offset + buffer.fill)) != 0) {
+            throw writeError(path, errno);
+        }
+    }
+
+    void close() override {
+        if (closed) return;
+        closed = true;
+        flush();
+        int result = ::close(fd);
+        fd = -1;
+        if (result != 0) throw writeError(path, errno);
+    }
+};
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: THREADS (pwrite worker pool)
+ * --------------------------------------------------------------
+ */
+
+/**
+ * @class WritePool
+ * @brief process-wide pwrite workers fed through a lock-free ring; idle workers sleep on an atomic.
+ */
+
+class WritePool {
+private:
+    BoundedQueue<ChunkBuffer *>     tasks {1024};
+    std::atomic<uint32_t>           posted {0};
+    std::atomic<bool>               stopping {false};
+    std::vector<std::thread>        workers;
+
+    void run() {
+        GENOMORPH_ALLOC_STAGE(output);
+        for (;;) {
+            uint32_t seen = posted.load(std::memory_order_acquire);
+            ChunkBuffer *buffer = nullptr;
+            if (tasks.tryPop(buffer)) {
+                complete(*buffer);
+                continue;
+            }
+            if (stopping.load(std::memory_order_acquire)) return;
+            posted.wait(seen, std::memory_order_acquire);
+        }
+    }
+
+    static void complete(ChunkBuffer &buffer) {
+        writeChunk(buffer);
+        buffer.pending.store(0, std::memory_order_release);
+        buffer.pending.notify_all();
+    }
+
+public:
+    WritePool() {
+        unsigned count = std::clamp(std::thread::hardware_concurrency(), 2u, 8u);
+        for (unsigned i = 0; i < count; ++i) workers.emplace_back([this] { run(); });
+    }
+
+    ~WritePool() {
+        stopping.store(true, std::memory_order_release);
+        posted.fetch_add(1, std::memory_order_release);
+        posted.notify_all();
+        for (auto &worker : workers) worker.join();
+    }
+
+    void post(ChunkBuffer &buffer) {
+        /**
+         * NOTE: a full ring means far more writes in flight than the disk can use; the caller writes this one itself
+         */
+        if (!tasks.tryPush(&buffer)) {
+            complete(buffer);
+            return;
+        }
+        posted.fetch_add(1, std::memory_order_release);
+        posted.notify_one();
+    }
+
+    static WritePool& instance() {
+        static WritePool pool;
+        return pool;
+    }
+};
+
+class ThreadedOutputFile : public AsyncOutputFile {
+protected:
+    void start(ChunkBuffer &buffer) override {
+        WritePool::instance().post(buffer);
+    }
+
+    void wait(ChunkBuffer &buffer) override {
+        while (buffer.pending.load(std::memory_order_acquire) != 0) buffer.pending.wait(1, std::memory_order_acquire);
+    }
+
+public:
+    using AsyncOutputFile::AsyncOutputFile;
+
+    ~ThreadedOutputFile() override { drain(); }
+
+    IoBackend backend() const override { return IoBackend::threads; }
+};
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: IO_URING (raw syscalls, no liburing)
+ * --------------------------------------------------------------
+ */
+
+int uringSetup(unsigned entries, io_uring_params &params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+}
+
+int uringEnter(int ring, unsigned submit, unsigned complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ring, submit, complete, flags, nullptr, 0));
+}
+
+/**
+ * @class UringOutputFile
+ * @brief one io_uring per file: every chunk is a WRITEV SQE, completions are reaped whenever the caller needs a buffer back.
+ *
+ * NOTE: the ring is only touched by the writing thread, the kernel is the other side of both queues.
+ */
+
+class UringOutputFile : public AsyncOutputFile {
+private:
+    int             ring = -1;
+    void            *sqMemory = MAP_FAILED;
+    void            *cqMemory = MAP_FAILED;
+    void            *sqeMemory = MAP_FAILED;
+    size_t          sqSize = 0;
+    size_t          cqSize = 0;
+    size_t          sqeSize = 0;
+
+    unsigned        *sqTail = nullptr;
+    unsigned        *sqMask = nullptr;
+    unsigned        *sqArray = nullptr;
+    io_uring_sqe    *sqes = nullptr;
+    unsigned        *cqHead = nullptr;
+    unsigned        *cqTail = nullptr;
+    unsigned        *cqMask = nullptr;
+    io_uring_cqe    *cqes = nullptr;
+
+    void release() noexcept {
+        if (sqeMemory != MAP_FAILED) ::munmap(sqeMemory, sqeSize);
+        if (cqMemory != MAP_FAILED && cqMemory != sqMemory) ::munmap(cqMemory, cqSize);
+        if (sqMemory != MAP_FAILED) ::munmap(sqMemory, sqSize);
+        if (ring >= 0) ::close(ring);
+    }
+
+    void submit(ChunkBuffer &buffer) {
+        buffer.vector.iov_base = buffer.data + buffer.done;
+        buffer.vector.iov_len = buffer.length - buffer.done;
+
+        unsigned tail = *sqTail;
+        unsigned index = tail & *sqMask;
+        io_uring_sqe &sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_WRITEV;
+        sqe.fd = buffer.fd;
+        sqe.addr = reinterpret_cast<uint64_t>(&buffer.vector);
+        sqe.len = 1;
+        sqe.off = buffer.offset + buffer.done;
+        sqe.user_data = reinterpret_cast<uint64_t>(&buffer);
+        sqArray[index] = index;
+        std::atomic_ref<unsigned>(*sqTail).store(tail + 1, std::memory_order_release);
+
+        while (uringEnter(ring, 1, 0, 0) < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EBUSY) {
+                reap();
+                continue;
+            }
+            buffer.error = errno;
+            buffer.pending.store(0, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    void reap() {
+        unsigned head = *cqHead;
+        unsigned tail = std::atomic_ref<unsigned>(*cqTail).load(std::memory_order_acquire);
+        for (; head != tail; ++head) {
+            const io_uring_cqe &cqe = cqes[head & *cqMask];
+            ChunkBuffer &buffer = *reinterpret_cast<ChunkBuffer *>(cqe.user_data);
+            int result = cqe.res;
+            std::atomic_ref<unsigned>(*cqHead).store(head + 1, std::memory_order_release);
+
+            if (result == -EINTR || result == -EAGAIN) {
+                submit(buffer);
+            } else if (result <= 0) {
+                buffer.error = result < 0 ? -result : EIO;
+                buffer.pending.store(0, std::memory_order_relaxed);
+            } else if ((buffer.done += static_cast<size_t>(result)) < buffer.length) {
+                submit(buffer);
+            } else {
+                buffer.pending.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+protected:
+    void start(ChunkBuffer &buffer) override {
+        submit(buffer);
+    }
+
+    void wait(ChunkBuffer &buffer) override {
+        for (;;) {
+            reap();
+            if (buffer.pending.load(std::memory_order_relaxed) == 0) return;
+            if (uringEnter(ring, 0, 1, IORING_ENTER_GETEVENTS) < 0 && errno != EINTR) {
+                buffer.error = errno;
+                buffer.pending.store(0, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+
+public:
+    UringOutputFile(const std::string &path, int fd, bool direct, uint64_t offset, const IoOptions &options)
+        : AsyncOutputFile(path, fd, direct, offset, options)
+    {
+        io_uring_params params {};
+        ring = uringSetup(static_cast<unsigned>(std::max<size_t>(options.depth, 2)), params);
+        if (ring < 0) throw std::runtime_error("cannot set up io_uring for " + path + ": " + std::strerror(errno));
+
+        sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single) sqSize = cqSize = std::max(sqSize, cqSize);
+        sqeSize = params.sq_entries * sizeof(io_uring_sqe);
+
+        sqMemory = ::mmap(nullptr, sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+        cqMemory = single ? sqMemory : ::mmap(nullptr, cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+        sqeMemory = ::mmap(nullptr, sqeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+        if (sqMemory == MAP_FAILED || cqMemory == MAP_FAILED || sqeMemory == MAP_FAILED) {
+            int error = errno;
+            release();
+            throw std::runtime_error("cannot map io_uring for " + path + ": " + std::strerror(error));
+        }
+
+        char *sq = static_cast<char *>(sqMemory);
+        char *cq = static_cast<char *>(cqMemory);
+        sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+        sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+        sqes = static_cast<io_uring_sqe *>(sqeMemory);
+        cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+        cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+        cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    }
+
+    ~UringOutputFile() override {
+        drain();
+        release();
+    }
+
+    IoBackend backend() const override { return IoBackend::uring; }
+};
+
+bool uringAvailable() {
+    io_uring_params params {};
+    int ring = uringSetup(1, params);
+    if (ring < 0) return false;
+    ::close(ring);
+    return true;
+}
+
+}
+
+IoBackend resolveIoBackend(IoBackend requested) {
+    static const bool available = uringAvailable();
+    if (requested == IoBackend::automatic) return available ? IoBackend::uring : IoBackend::threads;
+    if (requested == IoBackend::uring && !available) {
+        static const bool warned = [] {
+            std::cerr << "genomorph: io_uring is not available here, using the threads I/O backend\n";
+            return true;
+        }();
+        (void)warned;
+        return IoBackend::threads;
+    }
+    return requested;
+}
+
+std::unique_ptr<OutputFile> openOutputFile(const std::string &path, const IoOptions &options, bool append) {
+
+    if (options.bgzf) {
+        if (append) throw std::invalid_argument("BGZF output cannot be appended to: " + path);
+        IoOptions plain = options;
+        plain.bgzf = false;
+        return std::make_unique<BgzfOutputFile>(openOutputFile(path, plain), path == "-" ? "" : path + ".gzi",
+                                                options.compressionThreads, options.compressionLevel);
+    }
+
+    IoBackend backend = path == "-" ? IoBackend::sync : resolveIoBackend(options.backend);
+    if (backend == IoBackend::sync) return std::make_unique<StreamOutputFile>(path, append);
+
+    bool direct = options.direct;
+    uint64_t offset = 0;
+    int fd = openDescriptor(path, append, direct, offset);
+    if (backend == IoBackend::uring) return std::make_unique<UringOutputFile>(path, fd, direct, offset, options);
+    return std::make_unique<ThreadedOutputFile>(path, fd, direct, offset, options);
+}
+
+IoBackend parseIoBackend(const std::string &name) {
+    for (IoBackend backend : {IoBackend::automatic, IoBackend::uring, IoBackend::threads, IoBackend::sync}) {
+        if (name == ioBackendName(backend)) return backend;
+    }
+    throw std::invalid_argument("unknown --io '" + name + "' (expected auto, uring, threads or sync)");
+}
+
+const char *ioBackendName(IoBackend backend) {
+    switch (backend) {
+        case IoBackend::automatic:  return "auto";
+        case IoBackend::uring:      return "uring";
+        case IoBackend::threads:    return "threads";
+        case IoBackend::sync:       return "sync";
+    }
+    return "auto";
+}
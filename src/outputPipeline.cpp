@@ -0,0 +1,193 @@
+#include "outputPipeline.hpp"
+#include "allocationProfile.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+OrderedWriter::OrderedWriter(size_t chunks, const std::string &name, std::function<void(OutputChunk &)> consume)
+    : freeChunks(chunks == 0 ? 1 : chunks), submitted(chunks == 0 ? 1 : chunks), reorder(chunks, nullptr),
+      consume(std::move(consume)), inFlight(Metrics::instance().gauge(name + "_reorder_depth"))
+{
+    if (chunks == 0) throw std::invalid_argument("OrderedWriter: the chunk pool must not be empty");
+    for (size_t i = 0; i < chunks; ++i) {
+        storage.push_back(std::make_unique<OutputChunk>());
+        freeChunks.tryPush(storage.back().get());
+    }
+    GENOMORPH_COUNT(buffer_allocations, chunks);
+    writer = std::thread([this] { run(); });
+}
+
+OrderedWriter::~OrderedWriter() {
+    if (!writer.joinable()) return;
+    closing.store(true, std::memory_order_release);
+    arrivals.fetch_add(1, std::memory_order_release);
+    arrivals.notify_one();
+    writer.join();
+}
+
+void OrderedWriter::run() {
+
+    GENOMORPH_ALLOC_STAGE(output);
+
+    size_t window = reorder.size();
+    uint64_t next = 0;
+    size_t parked = 0;
+
+    for (;;) {
+        uint32_t seen = arrivals.load(std::memory_order_acquire);
+
+        OutputChunk *chunk = nullptr;
+        if (!submitted.tryPop(chunk)) {
+            if (closing.load(std::memory_order_acquire)) break;
+            arrivals.wait(seen, std::memory_order_acquire);
+            continue;
+        }
+        reorder[chunk->sequence % window] = chunk;
+        ++parked;
+
+        /**
+         * NOTE: consume the contiguous run starting at `next`; later chunks stay parked until their predecessors arrive
+         */
+        while (OutputChunk *ready = reorder[next % window]) {
+            if (ready->sequence != next) break;
+            reorder[next % window] = nullptr;
+            --parked;
+
+            if (!failed.load(std::memory_order_relaxed)) {
+                try {
+                    consume(*ready);
+                } catch (...) {
+                    abort(std::current_exception());
+                }
+            }
+            freeChunks.tryPush(ready);
+            nextSequence.store(++next, std::memory_order_release);
+            GENOMORPH_GAUGE(inFlight, parked);
+            released.fetch_add(1, std::memory_order_release);
+            released.notify_all();
+        }
+    }
+
+    if (parked != 0) {
+        abort(std::make_exception_ptr(std::runtime_error("OrderedWriter: output closed with " + std::to_string(parked)
+                                                         + " chunks waiting for sequence " + std::to_string(next))));
+    }
+}
+
+void OrderedWriter::abort(std::exception_ptr error) {
+    if (!failed.exchange(true, std::memory_order_acq_rel)) failure = error;
+    released.fetch_add(1, std::memory_order_release);
+    released.notify_all();
+}
+
+OutputChunk *OrderedWriter::acquire(uint64_t sequence) {
+    for (;;) {
+        uint32_t seen = released.load(std::memory_order_acquire);
+        if (failed.load(std::memory_order_acquire)) throw std::runtime_error("OrderedWriter: output failed");
+
+        OutputChunk *chunk = nullptr;
+        if (sequence < nextSequence.load(std::memory_order_acquire) + reorder.size() && freeChunks.tryPop(chunk)) {
+            chunk->sequence = sequence;
+            chunk->tag = 0;
+            chunk->value = 0;
+            chunk->bytes.clear();
+            return chunk;
+        }
+        GENOMORPH_COUNT(pipeline_stalls, 1);
+        released.wait(seen, std::memory_order_acquire);
+    }
+}
+
+void OrderedWriter::submit(OutputChunk *chunk) {
+    /**
+     * NOTE: the ring holds as many slots as there are chunks, so a push always succeeds
+     */
+    submitted.tryPush(chunk);
+    arrivals.fetch_add(1, std::memory_order_release);
+    arrivals.notify_one();
+}
+
+void OrderedWriter::waitConsumed(uint64_t sequence) {
+    for (;;) {
+        uint32_t seen = released.load(std::memory_order_acquire);
+        if (failed.load(std::memory_order_acquire)) throw std::runtime_error("OrderedWriter: output failed");
+        if (nextSequence.load(std::memory_order_acquire) >= sequence) return;
+        released.wait(seen, std::memory_order_acquire);
+    }
+}
+
+void OrderedWriter::finish() {
+    if (writer.joinable()) {
+        closing.store(true, std::memory_order_release);
+        arrivals.fetch_add(1, std::memory_order_release);
+        arrivals.notify_one();
+        writer.join();
+    }
+    if (failure) std::rethrow_exception(failure);
+}
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: PIPELINED SEQUENCE SINK
+ * --------------------------------------------------------------
+ */
+
+namespace {
+
+enum SequenceEvent : uint32_t {
+    begin_sequence,
+    bases,
+    end_sequence,
+    flush_sink,
+};
+
+}
+
+PipelinedSequenceSink::PipelinedSequenceSink(std::unique_ptr<SequenceSink> inner, size_t chunks)
+    : inner(std::move(inner)),
+      writer(chunks, "sequence", [this](OutputChunk &chunk) {
+          switch (chunk.tag) {
+              case begin_sequence:  this->inner->beginSequence(chunk.bytes, chunk.value); break;
+              case bases:           this->inner->writeBases(reinterpret_cast<const uint8_t *>(chunk.bytes.data()), chunk.bytes.size()); break;
+              case end_sequence:    this->inner->endSequence(); break;
+              case flush_sink:      this->inner->flush(); break;
+          }
+      })
+{
+}
+
+void PipelinedSequenceSink::post(uint32_t tag, uint64_t value, const void *data, size_t size) {
+    OutputChunk *chunk = writer.acquire(nextSequence++);
+    chunk->tag = tag;
+    chunk->value = value;
+    chunk->bytes.assign(static_cast<const char *>(data), size);
+    writer.submit(chunk);
+}
+
+void PipelinedSequenceSink::beginGenome(const std::vector<ChromosomeSpec> &records) {
+    /**
+     * NOTE: runs before any chunk is posted, so the writer thread is not touching the inner sink yet
+     */
+    inner->beginGenome(records);
+}
+
+void PipelinedSequenceSink::beginSequence(const std::string &name, size_t length) {
+    post(begin_sequence, length, name.data(), name.size());
+}
+
+void PipelinedSequenceSink::writeBases(const uint8_t *codes, size_t count) {
+    for (size_t done = 0; done < count; done += CHUNK_BASES) post(bases, 0, codes + done, std::min(CHUNK_BASES, count - done));
+}
+
+void PipelinedSequenceSink::endSequence() {
+    post(end_sequence, 0, nullptr, 0);
+}
+
+void PipelinedSequenceSink::flush() {
+    post(flush_sink, 0, nullptr, 0);
+    writer.waitConsumed(nextSequence);
+}
+
+void PipelinedSequenceSink::finish() {
+    writer.finish();
+    inner->finish();
+}
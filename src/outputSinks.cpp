@@ -0,0 +1,656 @@
+#include "outputSinks.hpp"
+#include "baseCodes.hpp"
+#include "kernels.hpp"
+#include "translation.hpp"
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t    FLUSH_THRESHOLD =       1 << 20;
+constexpr uint32_t  TWOBIT_SIGNATURE =      0x1A412743;
+constexpr uint32_t  PACKED_VERSION =        1;
+
+/**
+ * @brief Writes a buffered block to the sink's stream, crediting bytes and time to its metrics.
+ */
+void writeBlock(OutputFile &out, const std::string &block, SinkStats &stats) {
+    GENOMORPH_SINK_WRITE(stats, block.size());
+    out.write(block);
+}
+
+void appendLE32(std::string &out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+void appendLE64(std::string &out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+/**
+ * NOTE: genomorph code (A C G T) -> UCSC 2bit code (T C A G)
+ */
+constexpr uint8_t TWOBIT_CODE[4] = {2, 1, 3, 0};
+
+/**
+ * NOTE: TWOBIT_BYTE -> byte packed first-base-low (packCodes) -> the same four bases as a 2bit byte (first base high)
+ */
+constexpr std::array<uint8_t, 256> TWOBIT_BYTE = [] {
+    std::array<uint8_t, 256> table {};
+    for (size_t byte = 0; byte < 256; ++byte) {
+        for (size_t field = 0; field < 4; ++field) {
+            table[byte] = static_cast<uint8_t>(table[byte] | TWOBIT_CODE[(byte >> (2 * field)) & 3] << (2 * (3 - field)));
+        }
+    }
+    return table;
+}();
+
+/**
+ * @brief Appends count / 4 packed bytes (first base in the low bits) for count codes; count must be a multiple of 4.
+ * @return Offset of the first appended byte in out.
+ */
+size_t appendPacked(std::string &out, const uint8_t *codes, size_t count) {
+    size_t offset = out.size();
+    out.resize(offset + count / 4);
+    kernels().packCodes(codes, count, reinterpret_cast<uint8_t *>(out.data() + offset));
+    return offset;
+}
+
+const char* regionTypeName(FeatureType type) {
+    switch (type) {
+        case FeatureType::coding:       return "CDS";
+        case FeatureType::non_coding:   return "region";
+        case FeatureType::regulatory:   return "regulatory_region";
+        case FeatureType::repeat:       return "repeat_region";
+        case FeatureType::telomere:     return "telomere";
+        case FeatureType::centromere:   return "centromere";
+    }
+    return "region";
+}
+
+/**
+ * @brief Sequence Ontology type of a regulatory region: its kind when motif planting assigned one.
+ */
+const char* regulatoryTypeName(const RegulatoryMetaData &meta) {
+    switch (meta.kind) {
+        case RegulatoryKind::promoter:      return "promoter";
+        case RegulatoryKind::enhancer:      return "enhancer";
+        case RegulatoryKind::silencer:      return "silencer";
+        case RegulatoryKind::unspecified:   break;
+    }
+    return "regulatory_region";
+}
+
+/**
+ * @brief Value column of a track line, 4 significant digits like the GFF3 attributes.
+ */
+std::string formatValue(double value) {
+    std::ostringstream text;
+    text.precision(4);
+    text << value;
+    return text.str();
+}
+
+const char* geneFeatureName(GeneFeatureType type) {
+    switch (type) {
+        case GeneFeatureType::gene:             return "gene";
+        case GeneFeatureType::mrna:             return "mRNA";
+        case GeneFeatureType::exon:             return "exon";
+        case GeneFeatureType::cds:              return "CDS";
+        case GeneFeatureType::intron:           return "intron";
+        case GeneFeatureType::five_prime_utr:   return "five_prime_UTR";
+        case GeneFeatureType::three_prime_utr:  return "three_prime_UTR";
+    }
+    return "region";
+}
+
+/**
+ * @brief GFF3 lines of one spliced gene. IDs extend the region's own ID: <id>, <id>.mrna, <id>.exon<k>, <id>.cds
+ * (one ID shared by all CDS lines of the protein); UTRs and introns only carry a Parent.
+ */
+void writeGeneLines(std::ostream &lines, const std::string &chromosome, const GeneModel &genes, size_t gene,
+                    const std::string &id, double gc) {
+
+    size_t end = geneRunEnd(genes, gene);
+    std::vector<std::string> ids(end - gene);
+    size_t exons = 0;
+
+    for (size_t f = gene; f < end; ++f) {
+        const GeneFeature &feature = genes[f];
+        std::string &featureId = ids[f - gene];
+        switch (feature.type) {
+            case GeneFeatureType::gene: featureId = id; break;
+            case GeneFeatureType::mrna: featureId = id + ".mrna"; break;
+            case GeneFeatureType::exon: featureId = id + ".exon" + std::to_string(++exons); break;
+            case GeneFeatureType::cds:  featureId = id + ".cds"; break;
+            default: break;
+        }
+
+        lines << chromosome << "\tgenomorph\t" << geneFeatureName(feature.type) << '\t' << feature.start + 1 << '\t'
+              << feature.end + 1 << "\t.\t" << (feature.strand == StrandInfo::plus ? '+' : '-') << '\t'
+              << (feature.type == GeneFeatureType::cds ? static_cast<char>('0' + feature.phase) : '.') << '\t';
+
+        const char *separator = "";
+        if (!featureId.empty()) {
+            lines << "ID=" << featureId;
+            separator = ";";
+        }
+        if (feature.parent != NO_PARENT) lines << separator << "Parent=" << ids[feature.parent - gene];
+        if (feature.type == GeneFeatureType::gene) lines << ";gc=" << gc;
+        lines << '\n';
+    }
+}
+
+}
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: FASTA
+ * --------------------------------------------------------------
+ */
+
+FastaSink::FastaSink(const std::string &path, size_t lineWidth, const IoOptions &io)
+    : FastaSink(path, lineWidth, io, false)
+{
+}
+
+FastaSink::FastaSink(const std::string &path, size_t lineWidth, const IoOptions &io, bool append)
+    : stats(Metrics::instance().sink("fasta")), lineWidth(lineWidth)
+{
+    if (lineWidth == 0) throw std::invalid_argument("FASTA line width must be positive");
+    file = openOutputFile(path, io, append);
+    if (path != "-") indexPath = path + ".fai";
+    buffer.reserve(FLUSH_THRESHOLD + lineWidth + 1);
+}
+
+std::unique_ptr<FastaSink> FastaSink::resume(const std::string &path, size_t lineWidth, const std::string &name, size_t basesWritten,
+                                             const IoOptions &io) {
+
+    if (lineWidth == 0) throw std::invalid_argument("FASTA line width must be positive");
+
+    /**
+     * NOTE: layout is fully determined by the header and line width, so the resume offset needs no index
+     */
+    uintmax_t offset = 1 + name.size() + 1 + basesWritten + basesWritten / lineWidth;
+    std::error_code error;
+    uintmax_t size = std::filesystem::file_size(path, error);
+    if (error || size < offset) {
+        throw std::runtime_error("cannot resume " + path + ": output is missing or shorter than the checkpoint");
+    }
+
+    /**
+     * NOTE: the header and first full line are read back, so a different --name or --line-width is refused instead of
+     * mixing two layouts in one record
+     */
+    size_t header = 1 + name.size() + 1;
+    size_t firstLine = std::min(basesWritten, lineWidth);
+    std::string head(header + firstLine + (basesWritten >= lineWidth ? 1 : 0), '\0');
+    std::ifstream existing(path, std::ios::binary);
+    existing.read(head.data(), static_cast<std::streamsize>(head.size()));
+    bool matches = existing && head.compare(0, header, '>' + name + '\n') == 0
+                   && head.find('\n', header) == (basesWritten >= lineWidth ? header + lineWidth : std::string::npos);
+    if (!matches) {
+        throw std::runtime_error("cannot resume " + path + ": it does not start with record " + name + " in lines of "
+                                 + std::to_string(lineWidth) + " bases");
+    }
+    existing.close();
+    std::filesystem::resize_file(path, offset);
+
+    std::unique_ptr<FastaSink> sink(new FastaSink(path, lineWidth, io, true));
+    sink->column = basesWritten % lineWidth;
+    sink->written = offset;
+    sink->record = FaiRecord{name, basesWritten, 1 + name.size() + 1, lineWidth, lineWidth + 1};
+    return sink;
+}
+
+void FastaSink::writeBuffer() {
+    writeBlock(*file, buffer, stats);
+    written += buffer.size();
+    buffer.clear();
+}
+
+void FastaSink::beginSequence(const std::string &name, size_t length) {
+    (void)length;
+    buffer += '>';
+    buffer += name;
+    buffer += '\n';
+    column = 0;
+    record = FaiRecord{name, 0, written + buffer.size(), lineWidth, lineWidth + 1};
+}
+
+void FastaSink::writeBases(const uint8_t *codes, size_t count) {
+    while (count > 0) {
+        size_t take = std::min(count, lineWidth - column);
+        for (size_t i = 0; i < take; ++i) buffer += decodeBase(codes[i]);
+        codes += take;
+        count -= take;
+        column += take;
+        record.length += take;
+        if (column == lineWidth) {
+            buffer += '\n';
+            column = 0;
+        }
+        if (buffer.size() >= FLUSH_THRESHOLD) writeBuffer();
+    }
+}
+
+void FastaSink::endSequence() {
+    if (column != 0) buffer += '\n';
+    column = 0;
+    index += faiLine(record);
+    record.name.clear();
+}
+
+void FastaSink::flush() {
+    writeBuffer();
+    file->flush();
+}
+
+void FastaSink::finish() {
+    writeBuffer();
+    file->close();
+
+    if (indexPath.empty()) return;
+    IoOptions plain;
+    plain.backend = IoBackend::sync;
+    std::unique_ptr<OutputFile> indexFile = openOutputFile(indexPath, plain);
+    indexFile->write(index);
+    indexFile->close();
+}
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: UCSC 2BIT
+ * --------------------------------------------------------------
+ */
+
+TwoBitSink::TwoBitSink(const std::string &path, const IoOptions &io)
+    : file(openOutputFile(path, io)), stats(Metrics::instance().sink("2bit"))
+{
+}
+
+void TwoBitSink::beginGenome(const std::vector<ChromosomeSpec> &records) {
+
+    uint64_t offset = 16;
+    for (const ChromosomeSpec &record : records) {
+        if (record.name.size() > 255) throw std::invalid_argument("2bit sequence names are limited to 255 bytes: " + record.name);
+        offset += 1 + record.name.size() + 4;
+    }
+
+    std::string header;
+    appendLE32(header, TWOBIT_SIGNATURE);
+    appendLE32(header, 0);
+    appendLE32(header, static_cast<uint32_t>(records.size()));
+    appendLE32(header, 0);
+
+    for (const ChromosomeSpec &record : records) {
+        if (offset > UINT32_MAX) throw std::runtime_error("genome too large for 2bit version 0 (4 GiB offsets)");
+        header.push_back(static_cast<char>(record.name.size()));
+        header += record.name;
+        appendLE32(header, static_cast<uint32_t>(offset));
+        offset += 16 + (record.length + 3) / 4;
+    }
+
+    writeBlock(*file, header, stats);
+}
+
+void TwoBitSink::beginSequence(const std::string &name, size_t length) {
+    (void)name;
+    appendLE32(buffer, static_cast<uint32_t>(length));
+    appendLE32(buffer, 0); // N block count
+    appendLE32(buffer, 0); // mask block count
+    appendLE32(buffer, 0); // reserved
+}
+
+void TwoBitSink::flushPacked(bool force) {
+    if (force || buffer.size() >= FLUSH_THRESHOLD) {
+        writeBlock(*file, buffer, stats);
+        buffer.clear();
+    }
+}
+
+void TwoBitSink::writeBases(const uint8_t *codes, size_t count) {
+
+    auto pushBase = [this](uint8_t code) {
+        pending = static_cast<uint8_t>((pending << 2) | TWOBIT_CODE[code & 3]);
+        if (++pendingCount == 4) {
+            buffer.push_back(static_cast<char>(pending));
+            pending = 0;
+            pendingCount = 0;
+        }
+    };
+
+    while (pendingCount != 0 && count > 0) {
+        pushBase(*codes++);
+        --count;
+    }
+
+    /**
+     * NOTE: whole bytes go through the packing kernel in flush-sized slices, then get remapped to 2bit order
+     */
+    while (count >= 4) {
+        size_t slice = std::min(count, 4 * FLUSH_THRESHOLD) & ~size_t{3};
+        size_t offset = appendPacked(buffer, codes, slice);
+        for (size_t i = offset; i < buffer.size(); ++i) {
+            buffer[i] = static_cast<char>(TWOBIT_BYTE[static_cast<uint8_t>(buffer[i])]);
+        }
+        codes += slice;
+        count -= slice;
+        flushPacked(false);
+    }
+
+    while (count > 0) {
+        pushBase(*codes++);
+        --count;
+    }
+    flushPacked(false);
+}
+
+void TwoBitSink::endSequence() {
+    if (pendingCount != 0) {
+        buffer.push_back(static_cast<char>(pending << (2 * (4 - pendingCount))));
+        pending = 0;
+        pendingCount = 0;
+    }
+}
+
+void TwoBitSink::finish() {
+    flushPacked(true);
+    file->close();
+}
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: GENOMORPH PACKED
+ * --------------------------------------------------------------
+ */
+
+PackedSink::PackedSink(const std::string &path, const IoOptions &io)
+    : file(openOutputFile(path, io)), stats(Metrics::instance().sink("packed"))
+{
+}
+
+void PackedSink::beginGenome(const std::vector<ChromosomeSpec> &records) {
+    std::string header = "GMPK";
+    appendLE32(header, PACKED_VERSION);
+    appendLE32(header, static_cast<uint32_t>(records.size()));
+    writeBlock(*file, header, stats);
+}
+
+void PackedSink::beginSequence(const std::string &name, size_t length) {
+    appendLE32(buffer, static_cast<uint32_t>(name.size()));
+    buffer += name;
+    appendLE64(buffer, length);
+}
+
+void PackedSink::flushPacked(bool force) {
+    if (force || buffer.size() >= FLUSH_THRESHOLD) {
+        writeBlock(*file, buffer, stats);
+        buffer.clear();
+    }
+}
+
+void PackedSink::writeBases(const uint8_t *codes, size_t count) {
+
+    auto pushBase = [this](uint8_t code) {
+        pending |= static_cast<uint8_t>((code & 3) << (2 * pendingCount));
+        if (++pendingCount == 4) {
+            buffer.push_back(static_cast<char>(pending));
+            pending = 0;
+            pendingCount = 0;
+        }
+    };
+
+    while (pendingCount != 0 && count > 0) {
+        pushBase(*codes++);
+        --count;
+    }
+
+    while (count >= 4) {
+        size_t slice = std::min(count, 4 * FLUSH_THRESHOLD) & ~size_t{3};
+        appendPacked(buffer, codes, slice);
+        codes += slice;
+        count -= slice;
+        flushPacked(false);
+    }
+
+    while (count > 0) {
+        pushBase(*codes++);
+        --count;
+    }
+    flushPacked(false);
+}
+
+void PackedSink::endSequence() {
+    if (pendingCount != 0) {
+        buffer.push_back(static_cast<char>(pending));
+        pending = 0;
+        pendingCount = 0;
+    }
+}
+
+void PackedSink::finish() {
+    flushPacked(true);
+    file->close();
+}
+
+const char* annotationTypeName(const RegionInfo &region) {
+    return region.regulatory_meta_data ? regulatoryTypeName(*region.regulatory_meta_data) : regionTypeName(region.base.type);
+}
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: GFF3
+ * --------------------------------------------------------------
+ */
+
+Gff3Sink::Gff3Sink(const std::string &path, const IoOptions &io)
+    : file(openOutputFile(path, io)), stats(Metrics::instance().sink("gff3"))
+{
+}
+
+void Gff3Sink::beginGenome(const std::vector<ChromosomeSpec> &records) {
+    std::string header = "##gff-version 3\n";
+    for (const ChromosomeSpec &record : records) {
+        header += "##sequence-region " + record.name + " 1 " + std::to_string(record.length) + '\n';
+    }
+    writeBlock(*file, header, stats);
+}
+
+void Gff3Sink::writeRegions(const Chromosome &chromosome) {
+
+    std::ostringstream lines;
+    lines.precision(4);
+
+    for (const RegionInfo &region : chromosome.regions) {
+        const RegionPlan &plan = region.base.region_plan;
+
+        /**
+         * NOTE: flushed in pieces like the other sinks, so a chromosome with millions of regions never holds its whole GFF3
+         */
+        if (static_cast<size_t>(lines.tellp()) >= FLUSH_THRESHOLD) {
+            writeBlock(*file, lines.str(), stats);
+            lines.str("");
+        }
+
+        if (region.gene) {
+            writeGeneLines(lines, chromosome.name, chromosome.genes, *region.gene, "region" + std::to_string(nextId++), region.base.GC_CONTENT);
+            continue;
+        }
+
+        /**
+         * NOTE: GFF3 phase -> bases to skip before the first full codon, i.e. |reading_frame| - 1
+         */
+        char phase = '.';
+        if (region.coding) {
+            int frame = region.coding->reading_frame < 0 ? -region.coding->reading_frame : region.coding->reading_frame;
+            phase = static_cast<char>('0' + (frame - 1));
+        }
+
+        size_t id = nextId++;
+        lines << chromosome.name << "\tgenomorph\t" << annotationTypeName(region) << '\t'
+              << plan.region_start_index + 1 << '\t' << plan.region_end_index + 1 << "\t.\t"
+              << (plan.strand == StrandInfo::plus ? '+' : '-') << '\t' << phase << '\t'
+              << "ID=region" << id << ";gc=" << region.base.GC_CONTENT;
+        if (region.regulatory_meta_data) {
+            lines << ";accessibility=" << region.regulatory_meta_data->accessibility;
+        }
+        lines << '\n';
+
+        if (region.regulatory_meta_data) {
+            const RegulatoryMetaData &meta = *region.regulatory_meta_data;
+            for (uint32_t s = meta.firstSite; s < meta.firstSite + meta.siteCount; ++s) {
+                const MotifSite &site = chromosome.motifSites[s];
+                lines << chromosome.name << "\tgenomorph\tTF_binding_site\t" << site.start + 1 << '\t'
+                      << site.start + motifLibrary()[site.motif].length() << "\t.\t" << (site.strand == StrandInfo::plus ? '+' : '-')
+                      << "\t.\tParent=region" << id << ";Name=" << motifLibrary()[site.motif].getName() << '\n';
+            }
+        }
+    }
+
+    writeBlock(*file, lines.str(), stats);
+}
+
+void Gff3Sink::finish() {
+    file->close();
+}
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: ACCESSIBILITY BEDGRAPH
+ * --------------------------------------------------------------
+ */
+
+AccessibilityBedGraphSink::AccessibilityBedGraphSink(const std::string &path, const IoOptions &io)
+    : file(openOutputFile(path, io)), stats(Metrics::instance().sink("bedgraph"))
+{
+}
+
+void AccessibilityBedGraphSink::beginGenome(const std::vector<ChromosomeSpec> &records) {
+    (void)records;
+    writeBlock(*file, "track type=bedGraph name=accessibility description=\"genomorph chromatin accessibility\"\n", stats);
+}
+
+void AccessibilityBedGraphSink::writeRegions(const Chromosome &chromosome) {
+
+    std::string lines;
+    std::string runValue;
+    size_t runStart = 0;
+    size_t runEnd = 0;
+
+    auto closeRun = [&] {
+        if (runValue.empty()) return;
+        lines += chromosome.name + '\t' + std::to_string(runStart) + '\t' + std::to_string(runEnd) + '\t' + runValue + '\n';
+        runValue.clear();
+    };
+
+    for (const RegionInfo &region : chromosome.regions) {
+        const RegionPlan &plan = region.base.region_plan;
+        double accessibility = region.regulatory_meta_data ? region.regulatory_meta_data->accessibility : 0.0;
+
+        /**
+         * NOTE: runs compare the printed value, so two regions that only differ past the 4th digit still merge
+         */
+        std::string value = accessibility > 0.0 ? formatValue(accessibility) : "";
+        if (value != runValue || plan.region_start_index != runEnd) {
+            closeRun();
+            runValue = value;
+            runStart = plan.region_start_index;
+        }
+        runEnd = plan.region_end_index + 1;
+
+        if (lines.size() >= FLUSH_THRESHOLD) {
+            writeBlock(*file, lines, stats);
+            lines.clear();
+        }
+    }
+    closeRun();
+    writeBlock(*file, lines, stats);
+}
+
+void AccessibilityBedGraphSink::finish() {
+    file->close();
+}
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: PROTEIN FASTA
+ * --------------------------------------------------------------
+ */
+
+ProteinFastaSink::ProteinFastaSink(const std::string &path, size_t lineWidth, const IoOptions &io)
+    : stats(Metrics::instance().sink("protein")), lineWidth(lineWidth)
+{
+    if (lineWidth == 0) throw std::invalid_argument("FASTA line width must be positive");
+    file = openOutputFile(path, io);
+}
+
+void ProteinFastaSink::writeProteins(const Chromosome &chromosome) {
+
+    const SequenceBlock &sequence = chromosome.sequence;
+    const std::vector<AnnotationRun> &runs = sequence.regionColumn().getRuns();
+    if (runs.empty()) return;
+
+    const uint8_t *codes = sequence.codes();
+    size_t length = sequence.size();
+    size_t offset = sequence.start();
+    const GeneModel &genes = chromosome.genes;
+
+    std::string records;
+    for (size_t r = runs.front().value; r <= runs.back().value; ++r) {
+        const RegionInfo &region = chromosome.regions[r];
+        size_t id = nextId++;
+        std::string protein;
+        size_t start = 0;
+        size_t end = 0;
+        StrandInfo strand = region.base.region_plan.strand;
+
+        if (region.gene) {
+            const GeneFeature &gene = genes[*region.gene];
+            protein = translateSplicedGene(codes, length, genes, *region.gene, offset);
+            start = gene.start;
+            end = gene.end + 1;
+        } else {
+            std::optional<OpenReadingFrame> orf = plannedOpenReadingFrame(region);
+            if (!orf) continue;
+            protein = translateOpenReadingFrame(codes, length, *orf, offset);
+            start = orf->start;
+            end = orf->end;
+        }
+
+        records += ">region" + std::to_string(id) + ' ' + chromosome.name + ':' + std::to_string(start + 1) + '-'
+                 + std::to_string(end) + (strand == StrandInfo::plus ? "(+)" : "(-)") + '\n';
+        for (size_t i = 0; i < protein.size(); i += lineWidth) {
+            records.append(protein, i, lineWidth);
+            records += '\n';
+        }
+
+        if (records.size() >= FLUSH_THRESHOLD) {
+            writeBlock(*file, records, stats);
+            records.clear();
+        }
+    }
+    writeBlock(*file, records, stats);
+}
+
+void ProteinFastaSink::finish() {
+    file->close();
+}
+
+std::unique_ptr<SequenceSink> makeSequenceSink(const std::string &format, const std::string &path, size_t lineWidth,
+                                               const IoOptions &io) {
+    if (format == "fasta") return std::make_unique<FastaSink>(path, lineWidth, io);
+    if (format == "2bit") return std::make_unique<TwoBitSink>(path, io);
+    if (format == "packed") return std::make_unique<PackedSink>(path, io);
+    throw std::invalid_argument("unknown --format '" + format + "' (expected fasta, 2bit or packed)");
+}
+
+std::string sequenceExtension(const std::string &format) {
+    if (format == "fasta") return ".fa";
+    if (format == "2bit") return ".2bit";
+    return ".packed";
+}
@@ -0,0 +1,109 @@
+#include "pwmScanner.hpp"
+#include "kernels.hpp"
+#include "motifSearch.hpp"
+#include "parallel.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * NOTE: HIT_BLOCK -> windows handed to one scoreWindows call, bounds the hit buffers
+ */
+constexpr size_t HIT_BLOCK = 1 << 16;
+
+int8_t quantise(double probability, double total) {
+    if (probability <= 0.0) return INT8_MIN + 1;
+    double bits = std::log2(probability / total / 0.25);
+    return static_cast<int8_t>(std::clamp(std::lround(bits * PwmScanner::SCORE_SCALE), long{INT8_MIN + 1}, long{INT8_MAX}));
+}
+
+}
+
+PwmScanner::PwmScanner(const std::vector<PositionWeightMatrix> &motifs, double minScoreFraction) {
+
+    if (motifs.empty()) throw std::invalid_argument("PWM scan needs at least one motif");
+    if (!(minScoreFraction >= 0.0 && minScoreFraction <= 1.0)) throw std::invalid_argument("PWM score fraction is outside [0, 1]");
+
+    for (uint32_t m = 0; m < motifs.size(); ++m) {
+        const PositionWeightMatrix &motif = motifs[m];
+        size_t width = motif.length();
+        if (width > MAX_WIDTH) throw std::invalid_argument("motif " + motif.getName() + " is wider than the PWM scanner supports");
+
+        Strand plus {m, StrandInfo::plus, std::vector<int8_t>(width * PWM_COLUMN_STRIDE, 0), 0};
+        Strand minus {m, StrandInfo::minus, std::vector<int8_t>(width * PWM_COLUMN_STRIDE, 0), 0};
+        int lowest = 0;
+        int highest = 0;
+        for (size_t k = 0; k < width; ++k) {
+            const std::array<double, 4> &column = motif.column(k);
+            double total = column[0] + column[1] + column[2] + column[3];
+            int8_t *scores = plus.columns.data() + k * PWM_COLUMN_STRIDE;
+            for (size_t code = 0; code < 4; ++code) scores[code] = quantise(column[code], total);
+
+            /**
+             * NOTE: minus-strand window position k reads plus-strand column width - 1 - k, complemented
+             */
+            int8_t *mirrored = minus.columns.data() + (width - 1 - k) * PWM_COLUMN_STRIDE;
+            for (size_t code = 0; code < 4; ++code) mirrored[3 - code] = scores[code];
+
+            lowest += *std::min_element(scores, scores + 4);
+            highest += *std::max_element(scores, scores + 4);
+        }
+
+        int16_t threshold = static_cast<int16_t>(std::ceil(lowest + minScoreFraction * (highest - lowest)));
+        plus.threshold = minus.threshold = threshold;
+
+        names.push_back(motif.getName());
+        widths.push_back(width);
+        maxScores.push_back(highest / SCORE_SCALE);
+        thresholds.push_back(threshold / SCORE_SCALE);
+
+        bool palindromic = minus.columns == plus.columns;
+        palindromes.push_back(palindromic);
+        strands.push_back(std::move(plus));
+        if (!palindromic) strands.push_back(std::move(minus));
+    }
+}
+
+std::vector<PwmHit> PwmScanner::scan(const uint8_t *codes, size_t length, const RegionMap &regions, unsigned threads) const {
+
+    size_t chunks = (length + CHUNK_BASES - 1) / CHUNK_BASES;
+    std::vector<std::vector<PwmHit>> found(chunks);
+
+    /**
+     * NOTE: a chunk owns the windows that start inside it and reads up to width - 1 bases into the next one
+     */
+    parallelFor(chunks, threads, [&](size_t c) {
+        size_t begin = c * CHUNK_BASES;
+        std::vector<uint32_t> hits(HIT_BLOCK);
+        std::vector<int16_t> scores(HIT_BLOCK);
+
+        for (const Strand &strand : strands) {
+            size_t width = widths[strand.motif];
+            if (length < width) continue;
+            size_t end = std::min(begin + CHUNK_BASES, length - width + 1);
+
+            for (size_t block = begin; block < end; block += HIT_BLOCK) {
+                size_t windows = std::min(HIT_BLOCK, end - block);
+                size_t count = kernels().scoreWindows(codes + block, windows, strand.columns.data(), width, strand.threshold,
+                                                      hits.data(), scores.data());
+                for (size_t h = 0; h < count; ++h) {
+                    size_t start = block + hits[h];
+                    found[c].push_back(PwmHit{start, strand.motif, strand.strand, scores[h] / SCORE_SCALE, regionAt(regions, start)});
+                }
+            }
+        }
+    });
+
+    std::vector<PwmHit> all;
+    for (std::vector<PwmHit> &chunk : found) {
+        std::sort(chunk.begin(), chunk.end(), [](const PwmHit &a, const PwmHit &b) {
+            if (a.start != b.start) return a.start < b.start;
+            if (a.motif != b.motif) return a.motif < b.motif;
+            return a.strand < b.strand;
+        });
+        all.insert(all.end(), chunk.begin(), chunk.end());
+    }
+    return all;
+}
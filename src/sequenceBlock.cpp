@@ -0,0 +1,36 @@
+#include "sequenceBlock.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+void RunLengthColumn::append(uint32_t value, size_t length) {
+
+    if (length == 0) return;
+
+    if (!runs.empty() && runs.back().value == value) {
+        runs.back().length += length;
+        return;
+    }
+    runs.push_back(AnnotationRun{coveredLength(), length, value});
+}
+
+uint32_t RunLengthColumn::at(size_t index) const {
+
+    if (index >= coveredLength()) {
+        throw std::out_of_range("RunLengthColumn: index past the last annotated base");
+    }
+
+    auto run = std::upper_bound(runs.begin(), runs.end(), index,
+                                [](size_t position, const AnnotationRun &candidate) { return position < candidate.start; });
+    return std::prev(run)->value;
+}
+
+void SequenceBlock::release() {
+    std::vector<uint8_t>().swap(baseCodes);
+    regionIds.clear();
+}
+
+void SequenceBlock::reset(size_t start, size_t length) {
+    startOffset = start;
+    baseCodes.assign(length, BASE_A);
+    regionIds.clear();
+}
@@ -0,0 +1,252 @@
+#include "sequenceServer.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int ACCEPT_POLL_MS = 200;
+
+sockaddr_un socketAddress(const std::string &path) {
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("socket path must be 1.." + std::to_string(sizeof(address.sun_path) - 1) + " bytes: " + path);
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return address;
+}
+
+/**
+ * @brief Connected stream socket, or -1 with errno set.
+ */
+int connectTo(const std::string &path) {
+    sockaddr_un address = socketAddress(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+    if (::connect(fd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+        int error = errno;
+        ::close(fd);
+        errno = error;
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Writes all of data; false once the peer is gone.
+ */
+bool sendAll(int fd, const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+}
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: SERVER
+ * --------------------------------------------------------------
+ */
+
+SequenceServer::SequenceServer(const ProceduralGenome &genome, const std::string &socketPath, size_t maxFetch)
+    : genome(genome), socketPath(socketPath), maxFetch(maxFetch)
+{
+    sockaddr_un address = socketAddress(socketPath);
+
+    struct stat info {};
+    if (::lstat(socketPath.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) throw std::runtime_error(socketPath + " exists and is not a socket");
+        int probe = connectTo(socketPath);
+        if (probe >= 0) {
+            ::close(probe);
+            throw std::runtime_error("another server is listening on " + socketPath);
+        }
+        ::unlink(socketPath.c_str());
+    }
+
+    listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFd < 0) throw std::runtime_error("cannot create socket: " + std::string(std::strerror(errno)));
+    if (::bind(listenFd, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0 || ::listen(listenFd, SOMAXCONN) != 0) {
+        int error = errno;
+        ::close(listenFd);
+        throw std::runtime_error("cannot listen on " + socketPath + ": " + std::strerror(error));
+    }
+}
+
+SequenceServer::~SequenceServer() {
+    if (listenFd >= 0) ::close(listenFd);
+    ::unlink(socketPath.c_str());
+}
+
+void SequenceServer::run() {
+
+    /**
+     * NOTE: accept is polled with a timeout so stop() can stay a plain flag store (signal-safe) instead of waking the thread
+     */
+    pollfd listening {listenFd, POLLIN, 0};
+    while (!stopping.load()) {
+        int ready = ::poll(&listening, 1, ACCEPT_POLL_MS);
+        if (ready < 0 && errno != EINTR) throw std::runtime_error("poll on " + socketPath + " failed: " + std::strerror(errno));
+        if (ready <= 0) continue;
+
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+
+        std::lock_guard<std::mutex> lock(connectionMutex);
+        connections.insert(fd);
+        std::thread(&SequenceServer::serve, this, fd).detach();
+    }
+
+    /**
+     * NOTE: shutdown wakes handlers blocked in recv; each handler closes its own descriptor after leaving the set,
+     * so a descriptor is never shut down after it was closed and reused
+     */
+    std::unique_lock<std::mutex> lock(connectionMutex);
+    for (int fd : connections) ::shutdown(fd, SHUT_RDWR);
+    connectionsDone.wait(lock, [&] { return connections.empty(); });
+}
+
+void SequenceServer::serve(int fd) {
+
+    std::string received;
+    char chunk[4096];
+    bool open = true;
+    while (open) {
+        ssize_t got = ::recv(fd, chunk, sizeof(chunk), 0);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) break;
+        received.append(chunk, static_cast<size_t>(got));
+
+        size_t consumed = 0;
+        for (size_t newline = received.find('\n'); newline != std::string::npos; newline = received.find('\n', consumed)) {
+            std::string line = received.substr(consumed, newline - consumed);
+            consumed = newline + 1;
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            if (line.empty()) continue;
+
+            std::string reply = answer(line);
+            if (!sendAll(fd, reply.data(), reply.size())) {
+                open = false;
+                break;
+            }
+        }
+        received.erase(0, consumed);
+
+        if (open && received.size() > MAX_REQUEST) {
+            std::string reply = "ERR request longer than " + std::to_string(MAX_REQUEST) + " bytes\n";
+            sendAll(fd, reply.data(), reply.size());
+            open = false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(connectionMutex);
+    connections.erase(fd);
+    ::close(fd);
+    if (connections.empty()) connectionsDone.notify_all();
+}
+
+std::string SequenceServer::answer(const std::string &request) const {
+
+    try {
+        if (request == "LIST") {
+            const std::vector<Chromosome> &chromosomes = genome.getChromosomes();
+            std::string reply = "OK " + std::to_string(chromosomes.size()) + "\n";
+            for (const Chromosome &chromosome : chromosomes) reply += chromosome.name + '\t' + std::to_string(chromosome.length) + '\n';
+            return reply;
+        }
+
+        if (request == "STATS") {
+            BlockCache::Stats stats = genome.cacheStats();
+            return "OK 6\nhits\t" + std::to_string(stats.hits) + "\nmisses\t" + std::to_string(stats.misses) + "\nevictions\t"
+                 + std::to_string(stats.evictions) + "\nblocks\t" + std::to_string(stats.blocks) + "\nbytes\t" + std::to_string(stats.bytes)
+                 + "\ncapacity_bytes\t" + std::to_string(stats.capacityBytes) + "\n";
+        }
+
+        FastaRegion region = genome.resolve(request);
+        if (region.end - region.start > maxFetch) {
+            throw std::invalid_argument("region is longer than the server's limit of " + std::to_string(maxFetch) + " bases");
+        }
+
+        std::string bases = genome.fetch(region.name, region.start, region.end);
+        return "OK " + std::to_string(bases.size()) + "\n" + bases + "\n";
+    } catch (const std::exception &error) {
+        std::string message = error.what();
+        for (char &c : message) {
+            if (c == '\n') c = ' ';
+        }
+        return "ERR " + message + "\n";
+    }
+}
+
+/**
+ * --------------------------------------------------------------
+ * NOTE: CLIENT
+ * --------------------------------------------------------------
+ */
+
+SequenceClient::SequenceClient(const std::string &socketPath) {
+    fd = connectTo(socketPath);
+    if (fd < 0) throw std::runtime_error("cannot connect to " + socketPath + ": " + std::strerror(errno));
+}
+
+SequenceClient::~SequenceClient() {
+    if (fd >= 0) ::close(fd);
+}
+
+void SequenceClient::receive() {
+    char chunk[1 << 16];
+    ssize_t got;
+    do {
+        got = ::recv(fd, chunk, sizeof(chunk), 0);
+    } while (got < 0 && errno == EINTR);
+    if (got <= 0) throw std::runtime_error("sequence server closed the connection");
+    pending.append(chunk, static_cast<size_t>(got));
+}
+
+std::string SequenceClient::readBytes(size_t count) {
+    while (pending.size() < count) receive();
+    std::string bytes = pending.substr(0, count);
+    pending.erase(0, count);
+    return bytes;
+}
+
+std::string SequenceClient::readLine() {
+    size_t newline;
+    while ((newline = pending.find('\n')) == std::string::npos) receive();
+    std::string line = pending.substr(0, newline);
+    pending.erase(0, newline + 1);
+    return line;
+}
+
+size_t SequenceClient::request(const std::string &line) {
+
+    std::string message = line + '\n';
+    if (!sendAll(fd, message.data(), message.size())) throw std::runtime_error("sequence server closed the connection");
+
+    std::string header = readLine();
+    if (header.rfind("ERR ", 0) == 0) throw std::invalid_argument(header.substr(4));
+    if (header.rfind("OK ", 0) != 0) throw std::runtime_error("unexpected answer from sequence server: " + header);
+    return std::stoull(header.substr(3));
+}
+
+std::string SequenceClient::fetch(const std::string &region) {
+    size_t count = request(region);
+    std::string bases = readBytes(count + 1);
+    bases.pop_back();
+    return bases;
+}
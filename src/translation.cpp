@@ -0,0 +1,62 @@
+#include "translation.hpp"
+#include "kernels.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+std::string translateCodons(const uint8_t *codes, size_t codons) {
+    std::string protein(codons, '\0');
+    kernels().translateCodons(codes, codons, STANDARD_GENETIC_CODE.data(), protein.data());
+    return protein;
+}
+
+std::string translateFrame(const uint8_t *codes, size_t length, int frame) {
+
+    if (frame == 0 || frame < -3 || frame > 3) throw std::invalid_argument("reading frame must be 1..3 or -1..-3");
+
+    size_t offset = static_cast<size_t>(frame < 0 ? -frame : frame) - 1;
+    if (length <= offset) return {};
+    if (frame > 0) return translateCodons(codes + offset, (length - offset) / 3);
+
+    std::vector<uint8_t> reverse(length);
+    kernels().reverseComplementCodes(codes, length, reverse.data());
+    return translateCodons(reverse.data() + offset, (length - offset) / 3);
+}
+
+std::string translateOpenReadingFrame(const uint8_t *codes, size_t length, const OpenReadingFrame &orf, size_t offset) {
+
+    if (orf.start > orf.end || orf.start < offset || orf.end > offset + length) throw std::invalid_argument("ORF lies outside the sequence");
+
+    const uint8_t *first = codes + (orf.start - offset);
+    size_t codons = orf.codons() > 0 ? orf.codons() - 1 : 0;
+    if (orf.strand == StrandInfo::plus) return translateCodons(first, codons);
+
+    /**
+     * NOTE: minus strand -> the ORF's sense strand is the reverse complement of [start, end), read from its start
+     */
+    std::vector<uint8_t> sense(orf.end - orf.start);
+    kernels().reverseComplementCodes(first, sense.size(), sense.data());
+    return translateCodons(sense.data(), codons);
+}
+
+std::string translateSplicedGene(const uint8_t *codes, size_t length, const GeneModel &genes, size_t gene, size_t offset) {
+
+    std::vector<uint8_t> coding;
+    for (size_t f = gene, end = geneRunEnd(genes, gene); f < end; ++f) {
+        const GeneFeature &feature = genes[f];
+        if (feature.type != GeneFeatureType::cds) continue;
+        if (feature.start < offset || feature.end >= offset + length) throw std::invalid_argument("gene lies outside the sequence");
+
+        size_t joined = coding.size();
+        coding.resize(joined + feature.Length());
+        const uint8_t *piece = codes + (feature.start - offset);
+        if (feature.strand == StrandInfo::plus) {
+            std::copy_n(piece, feature.Length(), coding.data() + joined);
+        } else {
+            kernels().reverseComplementCodes(piece, feature.Length(), coding.data() + joined);
+        }
+    }
+
+    size_t codons = coding.size() / 3;
+    return translateCodons(coding.data(), codons > 0 ? codons - 1 : 0);
+}